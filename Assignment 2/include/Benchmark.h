@@ -0,0 +1,42 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : Benchmark.h
+Description : Definitions for the headless benchmarks run with --bench
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include <string>
+
+struct BenchmarkEntry
+{
+	const char* Name;
+	const char* Description;
+	int (*Run)();
+};
+
+// Runs the named benchmark and returns the process exit code; an unknown name lists them all.
+// With a JsonPath, the timings taken with measure() are also written there as JSON for
+// tools/compare_benchmarks.py.
+int runBenchmark(const std::string& Name, const std::string& JsonPath = "");
+void listBenchmarks();
+
+int benchmarkFrustumCulling();
+int benchmarkSceneGraph();
+int benchmarkEntities();
+int benchmarkSceneLoad();
+int benchmarkJobs();
+int benchmarkRecording();
+int benchmarkProfiler();
+int benchmarkAssets();
+int benchmarkTerrain();
+int benchmarkObjParse();
+int benchmarkStaticBatch();
@@ -0,0 +1,48 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : Bounds.h
+Description : Definitions for bounding volumes and view frustums
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include <glm.hpp>
+
+struct Aabb
+{
+	glm::vec3 Min = glm::vec3(0.0f);
+	glm::vec3 Max = glm::vec3(0.0f);
+
+	[[nodiscard]] glm::vec3 getCentre() const;
+	[[nodiscard]] Aabb merged(const Aabb& Other) const;
+	[[nodiscard]] Aabb transformed(const glm::mat4& Transform) const;
+};
+
+struct BoundingSphere
+{
+	glm::vec3 Centre = glm::vec3(0.0f);
+	float Radius = 0.0f;
+
+	// Conservative under non-uniform scale: the radius grows by the largest axis scale
+	[[nodiscard]] BoundingSphere transformed(const glm::mat4& Transform) const;
+};
+
+// Six planes (left, right, bottom, top, near, far) with normals pointing inwards,
+// so a point is inside when dot(Plane.xyz, Point) + Plane.w >= 0 for every plane
+struct Frustum
+{
+	glm::vec4 Planes[6];
+
+	static Frustum fromMatrix(const glm::mat4& ViewProjection);
+
+	[[nodiscard]] bool intersects(const BoundingSphere& Sphere) const;
+	[[nodiscard]] bool intersects(const Aabb& Box) const;
+};
@@ -14,6 +14,8 @@ Mail : ayoub.ahmad@mds.ac.nz
 
 #pragma once
 
+#include "Bounds.h"
+
 #include <glew.h>
 #include <glm.hpp>
 #include <gtc/matrix_transform.hpp>
@@ -34,6 +36,8 @@ constexpr float Pitch = 0.0f;
 constexpr float Speed = 2.5f;
 constexpr float Sensitivity = 0.05f;
 constexpr float Zoom = 45.0f;
+constexpr float NearPlane = 0.1f;
+constexpr float FarPlane = 100.0f;
 
 class Camera
 {
@@ -44,11 +48,15 @@ public:
 
 	[[nodiscard]] glm::mat4 getViewMatrix() const;
 	[[nodiscard]] glm::mat4 getProjectionMatrix(float Width, float Height) const;
+	[[nodiscard]] Frustum getFrustum(float Width, float Height) const;
 
 	void processKeyboard(CameraMovement Direction, float DeltaTime);
 	void processMouseMovement(float OffsetX, float OffsetY, GLboolean ConstrainPitch = true);
 	void processMouseScroll(float OffsetY);
 
+	// Places the camera directly, as camera path playback does
+	void setPose(const glm::vec3& Position, float Yaw, float Pitch, float Zoom);
+
 	glm::vec3 VPosition;
 	glm::vec3 VFront;
 	glm::vec3 VUp;
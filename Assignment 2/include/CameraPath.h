@@ -0,0 +1,55 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : CameraPath.h
+Description : Definitions for camera paths recorded from and replayed into the Camera
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include <glm.hpp>
+#include <string>
+#include <vector>
+
+class Camera;
+
+struct CameraKey
+{
+	float Time;
+	glm::vec3 Position;
+	float Yaw;
+	float Pitch;
+	float Zoom;
+};
+
+// Timed camera poses for one scene. The text format, one command per line, '#' comments:
+//   scene <1-5>
+//   key <seconds> <x> <y> <z> <yaw> <pitch> <zoom>
+// Keys must be in increasing time. Positions follow a Catmull-Rom curve through the keys so
+// sparse hand-written paths stay smooth; angles and zoom are interpolated linearly.
+class CameraPath
+{
+public:
+	bool load(const std::string& Path);
+	bool save(const std::string& Path) const;
+
+	void clear();
+	void setScene(int Scene);
+	void addKey(const Camera& Camera, float Time);
+
+	[[nodiscard]] CameraKey sample(float Time) const;
+	[[nodiscard]] float getDuration() const;
+	[[nodiscard]] int getScene() const;
+	[[nodiscard]] size_t getKeyCount() const;
+
+private:
+	std::vector<CameraKey> MKeys;
+	int MScene = 1;
+};
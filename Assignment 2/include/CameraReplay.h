@@ -0,0 +1,86 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : CameraReplay.h
+Description : Definitions for camera path recording and fixed-step benchmark playback
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include "CameraPath.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Camera;
+
+struct ReplayFrame
+{
+	float Time;
+	double CpuMs;
+	double GpuMs;
+};
+
+// Records the live camera into a CameraPath (K starts and stops; paths are saved under
+// results/paths/) and plays a path back as a benchmark: "Assignment 2.exe" --replay <path>
+// [--offscreen]. Playback steps time by FixedStep every frame, whatever the real frame time,
+// so each run renders the same frames. After WarmupFrames at the first pose, every frame's CPU
+// time (update and render submission) and GPU time (the GpuProfiler frame, so it needs
+// ENABLE_PROFILER) are written to results/replay_<path>.csv, with a summary on the console.
+class CameraReplay
+{
+public:
+	static constexpr float FixedStep = 1.0f / 60.0f;
+	static constexpr unsigned int WarmupFrames = 60;
+
+	static CameraReplay& getInstance();
+
+	bool startPlayback(const std::string& PathFile);
+	[[nodiscard]] bool isPlaying() const;
+	[[nodiscard]] bool isFinished() const;
+	[[nodiscard]] int getScene() const;
+
+	// Poses the camera for this frame and returns the step to update the scene with
+	float beginFrame(Camera& Camera);
+	void endFrame();
+
+	void toggleRecording(int Scene);
+	void recordFrame(const Camera& Camera, double Time);
+	[[nodiscard]] bool isRecording() const;
+
+private:
+	CameraReplay() = default;
+
+	enum class State
+	{
+		Idle,
+		Warmup,
+		Measuring,
+		Draining,
+		Finished
+	};
+
+	void onGpuFrame(uint64_t Frame, double Ms);
+	void writeResults() const;
+
+	CameraPath MPath;
+	std::string MName;
+	State MState = State::Idle;
+	unsigned int MFrame = 0;
+	uint64_t MFirstGpuFrame = 0;
+	std::chrono::steady_clock::time_point MFrameStart;
+	std::vector<ReplayFrame> MFrames;
+
+	CameraPath MRecording;
+	bool MRecordingActive = false;
+	double MRecordingStart = -1.0;
+};
@@ -0,0 +1,70 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : ClusteredLighting.h
+Description : Definitions for clustered forward light culling in OpenGL
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include "Camera.h"
+#include "ComputeShader.h"
+#include "LightManager.h"
+#include "Shader.h"
+
+#include <glew.h>
+#include <glm.hpp>
+#include <vector>
+
+// View-space froxel grid: 16x9 screen tiles, 24 exponential depth slices
+constexpr unsigned int ClusterGridX = 16;
+constexpr unsigned int ClusterGridY = 9;
+constexpr unsigned int ClusterGridZ = 24;
+constexpr unsigned int ClusterCount = ClusterGridX * ClusterGridY * ClusterGridZ;
+constexpr unsigned int MaxLightsPerCluster = 256;
+
+// std430 layout shared with ClusterCull.comp and FragmentShader.frag
+struct GpuPointLight
+{
+	glm::vec4 PositionRadius;
+	glm::vec4 Colour;
+	glm::vec4 Attenuation;
+};
+
+class ClusteredLighting
+{
+public:
+	ClusteredLighting();
+
+	void uploadLights(const std::vector<PointLight>& Lights);
+	void update(const Camera& Camera, float Width, float Height);
+	void bind(const Shader& Shader) const;
+	void cleanup();
+
+	[[nodiscard]] unsigned int getLightCount() const;
+	[[nodiscard]] GLuint getLightBuffer() const;
+	static float computeLightRadius(const PointLight& Light);
+
+private:
+	void buildClusters(const glm::mat4& Projection, const glm::vec2& ScreenSize);
+
+	ComputeShader MBuildShader;
+	ComputeShader MCullShader;
+
+	GLuint MLightBuffer;
+	GLuint MClusterBuffer;
+	GLuint MLightCountBuffer;
+	GLuint MLightIndexBuffer;
+
+	unsigned int MLightCount;
+	size_t MLightCapacity;
+	glm::vec2 MScreenSize;
+	glm::mat4 MBuiltProjection;
+};
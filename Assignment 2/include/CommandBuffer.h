@@ -0,0 +1,77 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : CommandBuffer.h
+Description : Definitions for the draw command buffers recorded off the GL thread
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include "GeometryArena.h"
+#include "LinearAllocator.h"
+
+#include <glew.h>
+#include <glm.hpp>
+#include <cstdint>
+#include <vector>
+
+class Model;
+class Shader;
+
+struct DrawPacket
+{
+	uint64_t Key;
+	const Shader* Program;
+	GLuint Texture;
+	GeometryHandle Geometry;
+	GLenum CullFace;
+	glm::mat4 Transform;
+};
+
+// A list of draw packets recorded without touching GL, so any thread can fill one. Packets
+// are written into chunks of a per-buffer LinearAllocator; reset() at the end of the frame
+// rewinds it, keeping the memory for the next frame. One buffer must only be recorded by one
+// thread at a time; RenderQueue replays buffers on the GL thread.
+class CommandBuffer
+{
+public:
+	explicit CommandBuffer(size_t PacketsPerChunk = 256);
+
+	void push(const DrawPacket& Packet);
+	void draw(const Shader& Program, GLuint Texture, GeometryHandle Geometry, const glm::mat4& Transform, GLenum CullFace = GL_BACK);
+	void draw(const Shader& Program, const Model& Model, const glm::mat4& Transform, GLenum CullFace = GL_BACK);
+	void reset();
+
+	[[nodiscard]] size_t size() const;
+	[[nodiscard]] size_t getMemoryBytes() const;
+
+	// Calls Function(const DrawPacket&) for every packet in recording order
+	template <typename Function>
+	void forEach(Function&& Fn) const
+	{
+		for (const Chunk& Chunk : MChunks)
+		{
+			for (size_t I = 0; I < Chunk.Count; I++)
+				Fn(Chunk.Packets[I]);
+		}
+	}
+
+private:
+	struct Chunk
+	{
+		DrawPacket* Packets;
+		size_t Count;
+	};
+
+	LinearAllocator MMemory;
+	std::vector<Chunk> MChunks;
+	size_t MPacketsPerChunk;
+	size_t MSize = 0;
+};
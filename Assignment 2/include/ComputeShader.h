@@ -0,0 +1,40 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : ComputeShader.h
+Description : Definitions for compute shader programs in OpenGL
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include <glew.h>
+#include <glm.hpp>
+#include <string>
+
+class ComputeShader
+{
+public:
+	explicit ComputeShader(const char* ComputePath, const std::string& Defines = "");
+
+	void use() const;
+	void dispatch(GLuint GroupsX, GLuint GroupsY = 1, GLuint GroupsZ = 1) const;
+	void setInt(const std::string& Name, int Value) const;
+	void setUInt(const std::string& Name, unsigned int Value) const;
+	void setFloat(const std::string& Name, float Value) const;
+	void setVec2(const std::string& Name, const glm::vec2& Value) const;
+	void setIVec2(const std::string& Name, const glm::ivec2& Value) const;
+	void setVec3(const std::string& Name, const glm::vec3& Value) const;
+	void setUVec3(const std::string& Name, const glm::uvec3& Value) const;
+	void setVec4(const std::string& Name, const glm::vec4& Value) const;
+	void setMat4(const std::string& Name, const glm::mat4& Mat) const;
+	void cleanup();
+
+	unsigned int Id;
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include "Scene.h"
+#include "Shader.h"
+#include "Model.h"
+#include "Skybox.h"
+#include "Camera.h"
+#include "LightManager.h"
+#include "Terrain.h"
+#include "SceneDescription.h"
+#include "StaticBatch.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// A scene instantiated entirely from a scene description: models, terrain, placements and
+// lights come from the file instead of C++. The text source is compiled to a binary in
+// cache/scenes the first time it is loaded, or whenever the text is newer.
+class DataScene : public Scene {
+public:
+    DataScene(Camera& camera, LightManager& lightManager, const std::string& name);
+    void load() override;
+    void update(float deltaTime) override;
+    void render() override;
+    void cleanup() override;
+
+private:
+    bool loadDescription();
+    bool usesStaticBatching() const;
+
+    std::string Name;
+    SceneDescription Description;
+    Shader LightingShader;
+    Shader SkyboxShader;
+    Shader TerrainShader;
+    // Shared through the residency manager, which keeps them loaded after the scene is gone
+    std::vector<std::shared_ptr<Model>> Models;
+    std::shared_ptr<Terrain> SceneTerrain;
+    std::shared_ptr<Skybox> LSkybox;
+    Camera& GCamera;
+    LightManager& GLightManager;
+    Material material;
+
+    // Entities created from the description's groups and entity records
+    EntityWorld World;
+    NodeId TerrainNode;
+
+    // Textured entities merged into pre-transformed batches, when the description asks for it
+    StaticBatcher Batches;
+};
@@ -0,0 +1,63 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : DeferredRenderer.h
+Description : Definitions for the deferred shading path with a G-buffer in OpenGL
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include "Camera.h"
+#include "LightManager.h"
+#include "Model.h"
+#include "Shader.h"
+
+#include <glew.h>
+#include <glm.hpp>
+
+// Geometry is drawn once into the G-buffer, then directional/spot light is applied in a
+// full-screen pass and every point light is accumulated by an instanced sphere volume.
+// The result goes into an HDR target that the skybox is drawn into before present().
+class DeferredRenderer
+{
+public:
+	DeferredRenderer();
+
+	void beginGeometryPass(int Width, int Height);
+	void bindGeometryShader(const Camera& Camera, const Material& Material, bool Textured);
+	void lightingPass(const Camera& Camera, const LightManager& LightManager, GLuint LightBuffer,
+	                  unsigned int LightCount, const Model& LightVolume);
+	void present() const;
+	void cleanup();
+
+	Shader& getGeometryShader();
+
+private:
+	void resize(int Width, int Height);
+	void deleteTargets();
+
+	Shader MGeometryShader;
+	Shader MDirectionalShader;
+	Shader MPointLightShader;
+	Shader MPresentShader;
+
+	GLuint MGBuffer;
+	GLuint MAlbedoSpecular;
+	GLuint MNormalShininess;
+	GLuint MDepth;
+
+	GLuint MLitBuffer;
+	GLuint MLitColour;
+	GLuint MLitDepth;
+
+	GLuint MEmptyVao;
+	int MWidth;
+	int MHeight;
+};
@@ -0,0 +1,224 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : EntityRegistry.h
+Description : Definitions for the sparse-set entity component store
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// Low 24 bits index the entity slot, high 8 bits count how often the slot was reused, so a
+// stale id held after destroy() never matches the entity that took its slot
+using Entity = uint32_t;
+constexpr Entity NullEntity = UINT32_MAX;
+
+constexpr uint32_t EntityIndexBits = 24;
+constexpr uint32_t EntityIndexMask = (1u << EntityIndexBits) - 1;
+
+constexpr uint32_t entityIndex(const Entity Id)
+{
+	return Id & EntityIndexMask;
+}
+
+constexpr uint32_t entityGeneration(const Entity Id)
+{
+	return Id >> EntityIndexBits;
+}
+
+class ComponentPoolBase
+{
+public:
+	virtual ~ComponentPoolBase() = default;
+	virtual void remove(Entity Id) = 0;
+	virtual void clear() = 0;
+};
+
+// Components of one type packed into a dense array with no holes, next to the owning entity
+// of each slot. The sparse array maps an entity index to its dense slot, so lookups are O(1)
+// and removal swaps the last component into the gap. Systems iterate the dense arrays directly.
+template <typename T>
+class ComponentPool final : public ComponentPoolBase
+{
+public:
+	T& add(const Entity Id, const T& Component)
+	{
+		const uint32_t Index = entityIndex(Id);
+		if (Index >= MSparse.size())
+			MSparse.resize(Index + 1, InvalidSlot);
+
+		if (has(Id))
+			return MComponents[MSparse[Index]] = Component;
+
+		MSparse[Index] = static_cast<uint32_t>(MDense.size());
+		MDense.push_back(Id);
+		MComponents.push_back(Component);
+		return MComponents.back();
+	}
+
+	void remove(const Entity Id) override
+	{
+		if (!has(Id))
+			return;
+
+		const uint32_t Slot = MSparse[entityIndex(Id)];
+		const Entity Last = MDense.back();
+		MDense[Slot] = Last;
+		MComponents[Slot] = std::move(MComponents.back());
+		MSparse[entityIndex(Last)] = Slot;
+
+		MDense.pop_back();
+		MComponents.pop_back();
+		MSparse[entityIndex(Id)] = InvalidSlot;
+	}
+
+	void clear() override
+	{
+		MSparse.clear();
+		MDense.clear();
+		MComponents.clear();
+	}
+
+	void reserve(const size_t Count)
+	{
+		MDense.reserve(Count);
+		MComponents.reserve(Count);
+	}
+
+	[[nodiscard]] bool has(const Entity Id) const
+	{
+		const uint32_t Index = entityIndex(Id);
+		return Index < MSparse.size() && MSparse[Index] != InvalidSlot && MDense[MSparse[Index]] == Id;
+	}
+
+	[[nodiscard]] T& get(const Entity Id)
+	{
+		return MComponents[MSparse[entityIndex(Id)]];
+	}
+
+	[[nodiscard]] T* tryGet(const Entity Id)
+	{
+		return has(Id) ? &MComponents[MSparse[entityIndex(Id)]] : nullptr;
+	}
+
+	[[nodiscard]] size_t size() const
+	{
+		return MDense.size();
+	}
+
+	[[nodiscard]] const std::vector<Entity>& getEntities() const
+	{
+		return MDense;
+	}
+
+	[[nodiscard]] std::vector<T>& getComponents()
+	{
+		return MComponents;
+	}
+
+private:
+	static constexpr uint32_t InvalidSlot = UINT32_MAX;
+
+	std::vector<uint32_t> MSparse;
+	std::vector<Entity> MDense;
+	std::vector<T> MComponents;
+};
+
+// Owns the entity ids and one pool per component type. Pools are created on first use.
+class EntityRegistry
+{
+public:
+	Entity create();
+	void destroy(Entity Id);
+	void clear();
+
+	[[nodiscard]] bool isAlive(Entity Id) const;
+	[[nodiscard]] size_t getEntityCount() const;
+
+	template <typename T>
+	T& add(const Entity Id, const T& Component)
+	{
+		return getPool<T>().add(Id, Component);
+	}
+
+	template <typename T>
+	void remove(const Entity Id)
+	{
+		getPool<T>().remove(Id);
+	}
+
+	template <typename T>
+	[[nodiscard]] bool has(const Entity Id)
+	{
+		return getPool<T>().has(Id);
+	}
+
+	template <typename T>
+	[[nodiscard]] T& get(const Entity Id)
+	{
+		return getPool<T>().get(Id);
+	}
+
+	template <typename T>
+	[[nodiscard]] T* tryGet(const Entity Id)
+	{
+		return getPool<T>().tryGet(Id);
+	}
+
+	template <typename T>
+	ComponentPool<T>& getPool()
+	{
+		const size_t Type = typeIndex<T>();
+		if (Type >= MPools.size())
+			MPools.resize(Type + 1);
+		if (!MPools[Type])
+			MPools[Type] = std::make_unique<ComponentPool<T>>();
+		return static_cast<ComponentPool<T>&>(*MPools[Type]);
+	}
+
+	// Calls Function(Entity, T&, Others&...) for every entity holding all the listed components.
+	// The first type drives the loop over its dense array, so list the rarest component first.
+	template <typename T, typename... Others, typename Function>
+	void each(Function&& Fn)
+	{
+		ComponentPool<T>& Driver = getPool<T>();
+		[[maybe_unused]] auto Pools = std::forward_as_tuple(getPool<Others>()...);  // Empty when T is the only component
+		const std::vector<Entity>& Entities = Driver.getEntities();
+		std::vector<T>& Components = Driver.getComponents();
+
+		for (size_t Slot = 0; Slot < Entities.size(); Slot++)
+		{
+			const Entity Id = Entities[Slot];
+			if ((std::get<ComponentPool<Others>&>(Pools).has(Id) && ...))
+				Fn(Id, Components[Slot], std::get<ComponentPool<Others>&>(Pools).get(Id)...);
+		}
+	}
+
+private:
+	template <typename T>
+	static size_t typeIndex()
+	{
+		static const size_t Index = MNextTypeIndex++;
+		return Index;
+	}
+
+	inline static size_t MNextTypeIndex = 0;
+
+	std::vector<std::unique_ptr<ComponentPoolBase>> MPools;
+	std::vector<uint8_t> MGenerations;
+	std::vector<uint32_t> MFreeIndices;
+	size_t MAliveCount = 0;
+};
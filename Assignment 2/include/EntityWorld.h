@@ -0,0 +1,86 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : EntityWorld.h
+Description : Definitions for the scene components and the transform, light and culling systems
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include "Bounds.h"
+#include "EntityRegistry.h"
+#include "FrustumCulling.h"
+#include "SceneGraph.h"
+
+#include <glm.hpp>
+#include <vector>
+
+class Model;
+struct PointLight;
+
+// Placement in the world's scene graph; the node owns position, rotation and scale
+struct TransformComponent
+{
+	NodeId Node;
+};
+
+// Model-space sphere and its world-space copy, refreshed when the node moves
+struct BoundsComponent
+{
+	BoundingSphere Local;
+	BoundingSphere World;
+};
+
+// Drawn with the textured lighting variant, or untextured in SolidColour
+struct RenderableComponent
+{
+	const Model* Source;
+	glm::vec3 SolidColour;
+	bool Textured;
+};
+
+// Drives LightManager point light LightIndex from the entity's world position
+struct PointLightComponent
+{
+	uint32_t LightIndex;
+};
+
+// The entities of one scene and the systems that run over them each frame:
+//   updateTransforms() - scene graph update, then world bounds for the entities that moved
+//   updateLights()     - copies light entity positions into the point light array
+//   cull()             - batch frustum test of every bounded entity
+class EntityWorld
+{
+public:
+	void clear();
+	void reserve(size_t Count);
+
+	NodeId createGroup(NodeId Parent, const glm::vec3& Position, const glm::vec3& Scale = glm::vec3(1.0f));
+	Entity createEntity(NodeId Parent, const glm::vec3& Position, const glm::vec3& Scale, const BoundingSphere& LocalBounds);
+
+	// Returns how many scene graph nodes were recomputed
+	unsigned int updateTransforms();
+	void updateLights(std::vector<PointLight>& Lights);
+	const std::vector<Entity>& cull(const Frustum& Frustum);
+
+	[[nodiscard]] const std::vector<Entity>& getVisible() const;
+	[[nodiscard]] const glm::mat4& getWorld(Entity Id);
+
+	[[nodiscard]] EntityRegistry& getRegistry();
+	[[nodiscard]] SceneGraph& getGraph();
+	[[nodiscard]] const FrustumCuller& getCuller() const;
+
+private:
+	EntityRegistry MRegistry;
+	SceneGraph MGraph;
+	FrustumCuller MCuller;
+	std::vector<Entity> MVisible;
+	bool MBoundsDirty = false;
+};
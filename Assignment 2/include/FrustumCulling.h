@@ -0,0 +1,71 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : FrustumCulling.h
+Description : Definitions for batched SIMD frustum culling of bounding spheres
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include "Bounds.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Sphere batches are stored as separate X/Y/Z/radius arrays so one SIMD register holds the same
+// component of 4 (SSE) or 8 (AVX) spheres. Each function writes the indices of the visible
+// spheres to Visible (room for Count entries) and returns how many there are.
+size_t cullSpheresScalar(const Frustum& Frustum, const float* X, const float* Y, const float* Z, const float* Radius,
+                         size_t Count, uint32_t* Visible);
+size_t cullSpheresSse(const Frustum& Frustum, const float* X, const float* Y, const float* Z, const float* Radius,
+                      size_t Count, uint32_t* Visible);
+#ifdef __AVX__
+size_t cullSpheresAvx(const Frustum& Frustum, const float* X, const float* Y, const float* Z, const float* Radius,
+                      size_t Count, uint32_t* Visible);
+#endif
+
+// Widest implementation compiled in (AVX when built with /arch:AVX or -mavx, otherwise SSE)
+size_t cullSpheres(const Frustum& Frustum, const float* X, const float* Y, const float* Z, const float* Radius,
+                   size_t Count, uint32_t* Visible);
+
+struct CullingStats
+{
+	unsigned int LastVisible = 0;
+	unsigned int LastCulled = 0;
+	unsigned long long Frames = 0;
+	unsigned long long TotalVisible = 0;
+	unsigned long long TotalCulled = 0;
+};
+
+// Holds the world-space bounding spheres of a scene's instances and culls them as one batch
+class FrustumCuller
+{
+public:
+	void clear();
+	uint32_t add(const BoundingSphere& Sphere);
+	void update(uint32_t Index, const BoundingSphere& Sphere);
+
+	const std::vector<uint32_t>& cull(const Frustum& Frustum);
+	[[nodiscard]] const std::vector<uint32_t>& getVisible() const;
+
+	[[nodiscard]] size_t getCount() const;
+	[[nodiscard]] const CullingStats& getStats() const;
+	void printStats(const std::string& Label) const;
+
+private:
+	std::vector<float> MX;
+	std::vector<float> MY;
+	std::vector<float> MZ;
+	std::vector<float> MRadius;
+	std::vector<uint32_t> MVisible;
+	CullingStats MStats;
+};
@@ -0,0 +1,77 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : GLStateCache.h
+Description : Definitions for the shadow copy of bound OpenGL state
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include <glew.h>
+
+struct GLStateCallStats
+{
+	unsigned int Issued = 0;   // State calls that reached the driver
+	unsigned int Skipped = 0;  // State calls dropped because the state was already set
+	unsigned int Draws = 0;
+};
+
+// Remembers the program, VAO, textures and cull face that are currently bound and drops
+// requests that would not change them. Code that binds state behind its back must call
+// invalidate(); the main loop does so at the start of every frame.
+class GLStateCache
+{
+public:
+	static GLStateCache& getInstance();
+
+	void useProgram(GLuint Program);
+	void bindVertexArray(GLuint Vao);
+	void bindTexture(GLuint Unit, GLenum Target, GLuint Texture);
+	void setCullFace(GLenum Face);
+	void recordDraw();
+
+	void invalidate();
+
+	// With filtering off every request is forwarded, which gives the "before" call count
+	void setFiltering(bool Enabled);
+	[[nodiscard]] bool isFiltering() const;
+
+	void beginFrame();
+	void endFrame();
+	[[nodiscard]] const GLStateCallStats& getFrameStats() const;
+
+private:
+	GLStateCache() = default;
+
+	void activeTexture(GLuint Unit);
+	void count(bool Skipped);
+
+	static constexpr GLuint MaxTextureUnits = 16;
+	static constexpr GLuint Unknown = 0xFFFFFFFFu;
+
+	struct TextureUnit
+	{
+		GLuint Texture2D = Unknown;
+		GLuint TextureCube = Unknown;
+	};
+
+	GLuint MProgram = Unknown;
+	GLuint MVao = Unknown;
+	GLuint MActiveUnit = Unknown;
+	GLenum MCullFace = Unknown;
+	TextureUnit MUnits[MaxTextureUnits];
+	bool MFiltering = true;
+
+	// Per-frame counts, plus running totals that are printed every couple of seconds
+	GLStateCallStats MFrame;
+	GLStateCallStats MTotal;
+	unsigned int MTotalFrames = 0;
+	double MLastReport = 0.0;
+};
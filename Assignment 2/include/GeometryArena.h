@@ -0,0 +1,115 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : GeometryArena.h
+Description : Definitions for the shared vertex/index buffer sub-allocator in OpenGL
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include <glew.h>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+struct Vertex;
+
+// Where a piece of geometry lives inside the arena buffers, in vertices and indices
+struct GeometrySpan
+{
+	GLint BaseVertex = 0;
+	GLuint FirstIndex = 0;
+	GLsizei IndexCount = 0;
+	GLuint VertexCount = 0;
+};
+
+using GeometryHandle = uint32_t;
+constexpr GeometryHandle InvalidGeometry = UINT32_MAX;
+
+struct GeometryArenaStats
+{
+	unsigned int Allocations = 0;
+	size_t VertexBytesUsed = 0;
+	size_t VertexBytesCapacity = 0;
+	size_t IndexBytesUsed = 0;
+	size_t IndexBytesCapacity = 0;
+	unsigned int FreeBlocks = 0;
+
+	// 1 - largest free block / total free space, 0 when all free space is contiguous
+	float VertexFragmentation = 0.0f;
+	float IndexFragmentation = 0.0f;
+};
+
+// First-fit free list over a range of elements; neighbouring free blocks are merged on release
+class RangeAllocator
+{
+public:
+	void reset(GLuint Capacity, GLuint Used = 0);
+	void grow(GLuint NewCapacity);
+	bool allocate(GLuint Count, GLuint& Offset);
+	void release(GLuint Offset, GLuint Count);
+
+	[[nodiscard]] GLuint getCapacity() const;
+	[[nodiscard]] GLuint getUsed() const;
+	[[nodiscard]] GLuint getLargestFree() const;
+	[[nodiscard]] GLuint getTrailingFree() const;  // Free elements ending at the capacity, which a grow extends
+	[[nodiscard]] unsigned int getFreeBlockCount() const;
+	[[nodiscard]] float getFragmentation() const;
+	[[nodiscard]] bool isPacked() const;
+
+private:
+	std::map<GLuint, GLuint> MFreeBlocks;  // offset -> count, ordered so neighbours can be found
+	GLuint MCapacity = 0;
+	GLuint MUsed = 0;
+};
+
+// Every mesh, the terrain and the skybox share one vertex buffer and one index buffer behind a
+// single VAO, so switching between them only changes the draw offsets. The buffers grow by
+// doubling when full, and defragment() packs the live spans together after a scene unload.
+class GeometryArena
+{
+public:
+	static GeometryArena& getInstance();
+
+	GeometryHandle allocate(const std::vector<Vertex>& Vertices, const std::vector<unsigned int>& Indices);
+	void release(GeometryHandle Handle);
+
+	[[nodiscard]] const GeometrySpan& getSpan(GeometryHandle Handle) const;
+	[[nodiscard]] size_t getByteSize(GeometryHandle Handle) const;
+	void bind() const;
+	void draw(GeometryHandle Handle, GLsizei InstanceCount = 1) const;
+
+	// Moves spans, so offsets copied out of getSpan() (indirect commands) are stale afterwards
+	void defragment();
+	void shutdown();
+
+	[[nodiscard]] GeometryArenaStats getStats() const;
+	void printStats(const char* Label) const;
+
+private:
+	GeometryArena() = default;
+
+	void createBuffers();
+	void growVertices(GLuint MinCapacity);
+	void growIndices(GLuint MinCapacity);
+	static GLuint resizeBuffer(GLuint Buffer, size_t OldBytes, size_t NewBytes);
+	void attachBuffers() const;
+
+	GLuint MVao = 0;
+	GLuint MVertexBuffer = 0;
+	GLuint MIndexBuffer = 0;
+
+	RangeAllocator MVertexAllocator;
+	RangeAllocator MIndexAllocator;
+
+	std::vector<GeometrySpan> MSpans;
+	std::vector<bool> MLive;
+	std::vector<GeometryHandle> MFreeHandles;
+};
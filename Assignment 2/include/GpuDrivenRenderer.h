@@ -0,0 +1,126 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : GpuDrivenRenderer.h
+Description : Definitions for GPU-driven culling and multi-draw-indirect rendering in OpenGL
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include "Camera.h"
+#include "ComputeShader.h"
+#include "HiZBuffer.h"
+#include "ImpostorAtlas.h"
+#include "Model.h"
+#include "Shader.h"
+
+#include <glew.h>
+#include <glm.hpp>
+#include <unordered_map>
+#include <vector>
+
+// std430 layouts shared with GpuCull.comp, GpuDriven.vert and Impostor.vert
+struct GpuInstance
+{
+	glm::mat4 Transform;
+	GLuint ModelId;
+	GLuint Padding[3];
+};
+
+struct GpuModelBounds
+{
+	glm::vec4 Sphere;
+	GLuint FirstCommand;
+	GLuint CommandCount;
+	GLuint ImpostorCommand;  // NoImpostor when the model has none
+	GLuint ImpostorLayer;
+};
+
+constexpr GLuint NoImpostor = 0xFFFFFFFF;
+
+struct DrawElementsIndirectCommand
+{
+	GLuint Count;
+	GLuint InstanceCount;
+	GLuint FirstIndex;
+	GLint BaseVertex;
+	GLuint BaseInstance;
+};
+
+// All registered models already live in the GeometryArena buffers and share one diffuse texture
+// (the scenes use a single texture atlas). A compute pass culls every instance (frustum, optionally Hi-Z occlusion)
+// and appends the survivors to a per-mesh instance list, and the whole population is drawn with
+// one glMultiDrawElementsIndirect.
+//
+// Models baked into an ImpostorAtlas get one more command, the atlas quad. Their instances fade
+// from geometry to impostor between the start and end distance: the cull writes the fade into
+// the top 8 bits of each visible entry (so at most 2^24 instances) and appends the instance to
+// the geometry commands, the impostor command or, inside the fade band, both. The two draws then
+// discard complementary dithered pixels.
+class GpuDrivenRenderer
+{
+public:
+	GpuDrivenRenderer();
+
+	void clearInstances();
+	void addInstance(const Model& Model, const glm::mat4& Transform);
+	// Takes effect at the next upload(); the atlas must outlive the renderer's use of it
+	void setImpostors(const ImpostorAtlas* Atlas, float Start, float End);
+	void setImpostorsEnabled(bool Enabled);
+	void upload();
+
+	void cull(const Camera& Camera, const HiZBuffer* Occluders = nullptr);
+	void draw(const Shader& Shader) const;
+	void drawImpostors(const Shader& Shader) const;
+	void cleanup();
+
+	[[nodiscard]] unsigned int getInstanceCount() const;
+	[[nodiscard]] unsigned int getCommandCount() const;
+	[[nodiscard]] unsigned int getVisibleCount() const;
+	[[nodiscard]] unsigned int getOccludedCount() const;
+	[[nodiscard]] unsigned int getImpostorCount() const;
+
+private:
+	GLuint registerModel(const Model& Model);
+	void readBackVisibleCount();
+
+	ComputeShader MCullShader;
+	ComputeShader MOcclusionCullShader;
+
+	// CPU copies, uploaded by upload()
+	std::vector<GpuModelBounds> MModels;
+	std::vector<DrawElementsIndirectCommand> MCommands;
+	std::vector<GpuInstance> MInstances;
+	std::unordered_map<const Model*, GLuint> MModelIds;
+	GLuint MTexture;
+
+	// One quad command per model with an impostor, uploaded after the geometry commands
+	std::vector<DrawElementsIndirectCommand> MImpostorCommands;
+	const ImpostorAtlas* MImpostors;
+	float MImpostorStart;
+	float MImpostorEnd;
+	bool MImpostorsEnabled;
+
+	GLuint MInstanceBuffer;
+	GLuint MModelBuffer;
+	GLuint MCommandBuffer;
+	GLuint MCommandTemplate;
+	GLuint MVisibleBuffer;
+	GLuint MCounterBuffer;
+
+	// Visible/occluded counts are read back a few frames late so the CPU never waits on the GPU
+	static constexpr int ReadbackLatency = 3;
+	GLuint MReadbackBuffers[ReadbackLatency];
+	GLsync MReadbackFences[ReadbackLatency];
+	int MReadbackIndex;
+	unsigned int MVisibleCount;
+	unsigned int MOccludedCount;
+	unsigned int MImpostorCount;
+};
@@ -0,0 +1,162 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : GpuProfiler.h
+Description : Definitions for the GPU pass profiler built on timestamp queries
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include <glew.h>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Like the CPU profiler macros, these compile to nothing without ENABLE_PROFILER.
+//   PROFILE_GPU("Name") - times the GL commands issued in the enclosing scope; passes nest
+//   PROFILE_GPU_FRAME() - wraps one frame's rendering, once per frame on the GL thread
+#ifdef ENABLE_PROFILER
+#define PROFILE_GPU_CONCAT_INNER(A, B) A##B
+#define PROFILE_GPU_CONCAT(A, B) PROFILE_GPU_CONCAT_INNER(A, B)
+#define PROFILE_GPU(Name) GpuPassScope PROFILE_GPU_CONCAT(GpuPass, __LINE__)(Name)
+#define PROFILE_GPU_FRAME() GpuFrameScope PROFILE_GPU_CONCAT(GpuFrame, __LINE__)
+#else
+#define PROFILE_GPU(Name) ((void)0)
+#define PROFILE_GPU_FRAME() ((void)0)
+#endif
+
+// Rolling statistics of one pass over the last GpuProfiler::WindowFrames samples
+struct GpuPassStats
+{
+	std::string Name;
+	uint32_t Depth;
+	uint64_t LastFrame;
+	unsigned int Samples;
+	double MinMs;
+	double AvgMs;
+	double P95Ms;
+	double P99Ms;
+};
+
+// Passes are bracketed with GL_TIMESTAMP queries rather than GL_TIME_ELAPSED so they can
+// nest. Each frame writes its queries into one slot of a FramesInFlight ring, and a slot is
+// only read back when the ring comes round to it again, by which time the GPU has long
+// finished it; a slot whose results are still not available is dropped, never waited on.
+//
+// Every resolved pass is streamed to profiles/gpu_passes.csv. T toggles an overlay of the
+// rolling averages in the window title and prints the full statistics when it is turned off.
+class GpuProfiler
+{
+public:
+	static constexpr unsigned int FramesInFlight = 4;
+	static constexpr unsigned int WindowFrames = 300;
+
+	static GpuProfiler& getInstance();
+
+	void beginFrame();
+	void endFrame();
+	void beginPass(const char* Name);
+	void endPass();
+
+	// Called with each frame's total GPU time once it is read back, FramesInFlight frames late
+	using FrameListener = std::function<void(uint64_t Frame, double Ms)>;
+	void setFrameListener(FrameListener Listener);
+	[[nodiscard]] uint64_t getFrameIndex() const;
+
+	void toggleOverlay();
+	[[nodiscard]] bool isOverlayEnabled() const;
+	[[nodiscard]] std::string getOverlayText() const;
+
+	[[nodiscard]] std::vector<GpuPassStats> getStats() const;
+	void printStats() const;
+	void shutdown();
+
+private:
+	GpuProfiler() = default;
+
+	struct PassQuery
+	{
+		const char* Name;
+		GLuint StartQuery;
+		GLuint EndQuery;
+		uint32_t Depth;
+	};
+
+	struct FrameSlot
+	{
+		std::vector<PassQuery> Passes;
+		std::vector<GLuint> Queries;
+		size_t UsedQueries = 0;
+		uint64_t Frame = 0;
+		bool Pending = false;
+	};
+
+	struct PassHistory
+	{
+		std::string Name;
+		uint32_t Depth;
+		std::vector<float> Samples;
+		size_t Next = 0;
+		uint64_t LastFrame = 0;
+	};
+
+	GLuint acquireQuery(FrameSlot& Slot);
+	void resolve(FrameSlot& Slot);
+	void addSample(const PassQuery& Pass, uint64_t Frame, float Ms);
+
+	FrameSlot MSlots[FramesInFlight];
+	FrameSlot* MCurrent = nullptr;
+	std::vector<size_t> MOpenPasses;
+	uint64_t MFrameIndex = 0;
+	unsigned int MDroppedFrames = 0;
+
+	std::vector<PassHistory> MHistory;
+	FrameListener MFrameListener;
+	std::ofstream MCsv;
+	bool MCsvFailed = false;
+	bool MOverlay = false;
+};
+
+// Stack objects behind the macros
+class GpuPassScope
+{
+public:
+	explicit GpuPassScope(const char* Name)
+	{
+		GpuProfiler::getInstance().beginPass(Name);
+	}
+
+	~GpuPassScope()
+	{
+		GpuProfiler::getInstance().endPass();
+	}
+
+	GpuPassScope(const GpuPassScope&) = delete;
+	GpuPassScope& operator=(const GpuPassScope&) = delete;
+};
+
+class GpuFrameScope
+{
+public:
+	GpuFrameScope()
+	{
+		GpuProfiler::getInstance().beginFrame();
+	}
+
+	~GpuFrameScope()
+	{
+		GpuProfiler::getInstance().endFrame();
+	}
+
+	GpuFrameScope(const GpuFrameScope&) = delete;
+	GpuFrameScope& operator=(const GpuFrameScope&) = delete;
+};
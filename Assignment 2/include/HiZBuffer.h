@@ -0,0 +1,53 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : HiZBuffer.h
+Description : Definitions for the hierarchical depth buffer used for occlusion culling in OpenGL
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include "Camera.h"
+#include "ComputeShader.h"
+#include "Shader.h"
+
+#include <glew.h>
+#include <glm.hpp>
+
+// Large occluders (terrain, statue) are drawn depth-only into an offscreen target, then a compute
+// reduction builds a mip pyramid where every texel holds the farthest depth of the 2x2 texels
+// below it. A bounding rectangle can then be tested conservatively with four samples.
+class HiZBuffer
+{
+public:
+	HiZBuffer();
+
+	void beginOccluderPass(const Camera& Camera, int Width, int Height);
+	void endOccluderPass();
+	[[nodiscard]] const Shader& getDepthShader() const;
+
+	void bind(const ComputeShader& Shader, GLuint Unit) const;
+	void cleanup();
+
+private:
+	void resize(int Width, int Height);
+	void buildPyramid() const;
+
+	Shader MDepthShader;
+	ComputeShader MBuildShader;
+
+	GLuint MFramebuffer;
+	GLuint MDepth;
+	GLuint MPyramid;
+	int MWidth;
+	int MHeight;
+	int MLevels;
+	GLint MPreviousFramebuffer;
+};
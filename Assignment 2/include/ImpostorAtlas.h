@@ -0,0 +1,66 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : ImpostorAtlas.h
+Description : Definitions for baking octahedral impostors of models into texture arrays
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include "GeometryArena.h"
+#include "Shader.h"
+
+#include <glew.h>
+#include <unordered_map>
+#include <vector>
+
+class Model;
+
+// Each baked model gets one layer of an albedo and a normal texture array. A layer is a grid of
+// Frames x Frames views of the model's bounding sphere, looking in from directions spread over
+// the upper hemisphere with a hemi-octahedral mapping, so the grid neighbours of any view
+// direction are the views closest to it. Impostor.vert picks the four around the camera
+// direction and FragmentShader.frag (with IMPOSTOR defined) blends and lights them.
+//
+// Normals are baked in model space; colours and normals are premultiplied by coverage, with
+// empty texels left at zero.
+class ImpostorAtlas
+{
+public:
+	static constexpr int Frames = 8;
+	static constexpr int FramePixels = 128;
+
+	ImpostorAtlas();
+
+	// Renders every model into its own layer through an offscreen framebuffer; replaces any earlier bake
+	void bake(const std::vector<const Model*>& Models);
+
+	// Layer of the model, or -1 when it was not baked
+	[[nodiscard]] int getLayer(const Model& Model) const;
+
+	// The unit quad every impostor is drawn with, corners in [-1, 1]
+	[[nodiscard]] GeometryHandle getQuad() const;
+
+	void bind(const Shader& Shader, GLuint AlbedoUnit, GLuint NormalUnit) const;
+	[[nodiscard]] size_t getByteSize() const;
+	void cleanup();
+
+private:
+	void release();
+
+	Shader MBakeShader;
+	GLuint MAlbedo;
+	GLuint MNormals;
+	GLuint MFramebuffer;
+	GLuint MDepth;
+	GeometryHandle MQuad;
+	int MLayerCount;
+	std::unordered_map<const Model*, int> MLayers;
+};
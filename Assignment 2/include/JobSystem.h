@@ -0,0 +1,116 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : JobSystem.h
+Description : Definitions for the work-stealing job system
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobCounter;
+
+struct Job
+{
+	std::function<void()> Function;
+	JobCounter* Counter = nullptr;
+};
+
+// Counts the unfinished jobs submitted against it. wait() returns once it reaches zero, and
+// jobs submitted with it as a dependency are held back until then.
+class JobCounter
+{
+public:
+	JobCounter() = default;
+	JobCounter(const JobCounter&) = delete;
+	JobCounter& operator=(const JobCounter&) = delete;
+
+	[[nodiscard]] bool isDone() const;
+	[[nodiscard]] int getPending() const;
+
+private:
+	friend class JobSystem;
+
+	std::atomic<int> MPending = 0;
+	std::mutex MMutex;
+	std::vector<Job> MContinuations;
+};
+
+// A fixed pool of worker threads, each with its own deque. A worker pushes and pops the back
+// of its own deque and, when that is empty, steals from the front of the others, so related
+// jobs stay on one core and idle cores take the oldest work. The main thread owns deque 0
+// and runs jobs while it waits, so with zero workers everything still completes in wait().
+//
+// GL calls are only legal on the main thread: runOnMainThread() queues them, and the queue
+// is drained once a frame and whenever the main thread waits on a counter.
+class JobSystem
+{
+public:
+	static JobSystem& getInstance();
+
+	// WorkerCount defaults to one thread per core besides the main thread
+	void initialize(unsigned int WorkerCount = defaultWorkerCount());
+	void shutdown();
+
+	void run(std::function<void()> Function, JobCounter* Counter = nullptr);
+	void run(std::function<void()> Function, JobCounter* Counter, JobCounter& DependsOn);
+	void wait(JobCounter& Counter);
+
+	// Splits [0, Count) into chunks of at most Grain items and calls Function(Begin, End) for
+	// each chunk across the workers, returning when all of them have finished
+	void parallelFor(size_t Count, size_t Grain, const std::function<void(size_t, size_t)>& Function);
+
+	void runOnMainThread(std::function<void()> Function, JobCounter* Counter = nullptr);
+	unsigned int runMainThreadJobs();
+
+	[[nodiscard]] unsigned int getWorkerCount() const;
+	[[nodiscard]] bool isMainThread() const;
+
+	// 0 on the main thread (and any thread the system did not start), 1..N on the workers
+	static unsigned int getThreadIndex();
+	static unsigned int defaultWorkerCount();
+
+private:
+	JobSystem() = default;
+	~JobSystem();
+
+	struct WorkerQueue
+	{
+		std::mutex Mutex;
+		std::deque<Job> Jobs;
+	};
+
+	void push(Job&& NewJob);
+	bool tryRunOne(unsigned int Queue);
+	void execute(Job& Current);
+	void finish(JobCounter* Counter);
+	void workerLoop(unsigned int Queue);
+
+	std::vector<std::unique_ptr<WorkerQueue>> MQueues;
+	std::vector<std::thread> MWorkers;
+	std::atomic<unsigned int> MNextQueue = 0;
+	std::atomic<int> MQueuedJobs = 0;
+	std::atomic<bool> MRunning = false;
+	std::mutex MSleepMutex;
+	std::condition_variable MWake;
+
+	std::mutex MMainMutex;
+	std::vector<Job> MMainJobs;
+	std::thread::id MMainThread;
+};
@@ -18,6 +18,7 @@ Mail : ayoub.ahmad@mds.ac.nz
 
 #include <glm.hpp>
 #include <string>
+#include <vector>
 
 struct PointLight
 {
@@ -48,6 +49,9 @@ struct SpotLight
 	float Quadratic;
 };
 
+// Point lights uploaded through the uniform array; the clustered path has no fixed limit
+constexpr int ActivePointLights = 2;
+
 class LightManager
 {
 public:
@@ -55,6 +59,7 @@ public:
 
 	void initialize();
 	void updateLighting(const Shader& Shader) const;
+	[[nodiscard]] ShaderVariant getShaderVariant(bool Textured) const;
 
 	void togglePointLights();
 	void toggleDirectionalLight();
@@ -66,9 +71,14 @@ public:
 
 	[[nodiscard]] bool isPointLightsOn() const;
 	[[nodiscard]] PointLight& getPointLight(int Index);
+	[[nodiscard]] std::vector<PointLight>& getPointLights();
+
+	void setPointLightPath(PointLightPath Path);
+	[[nodiscard]] PointLightPath getPointLightPath() const;
 
 private:
-	PointLight MPointLights[10];
+	std::vector<PointLight> MPointLights;
+	PointLightPath MPointLightPath = PointLightPath::Uniforms;
 	DirectionalLight MDirectionalLight;
 	SpotLight MSpotLight;
 
@@ -0,0 +1,55 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : LinearAllocator.h
+Description : Definitions for the per-frame bump allocator
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Hands out memory by bumping an offset through a list of fixed-size blocks, and frees all of
+// it at once with reset(). The blocks are kept, so once a frame has grown the allocator to its
+// working size, later frames allocate nothing from the heap. Not thread-safe: give each
+// recording thread its own. Only suitable for trivially destructible types.
+class LinearAllocator
+{
+public:
+	explicit LinearAllocator(size_t BlockBytes = 64 * 1024);
+
+	void* allocate(size_t Bytes, size_t Alignment = alignof(std::max_align_t));
+
+	template <typename T>
+	T* allocate(const size_t Count)
+	{
+		return static_cast<T*>(allocate(sizeof(T) * Count, alignof(T)));
+	}
+
+	void reset();
+
+	[[nodiscard]] size_t getUsedBytes() const;
+	[[nodiscard]] size_t getReservedBytes() const;
+
+private:
+	struct Block
+	{
+		std::unique_ptr<std::byte[]> Memory;
+		size_t Size;
+	};
+
+	std::vector<Block> MBlocks;
+	size_t MBlockBytes;
+	size_t MCurrent = 0;
+	size_t MOffset = 0;
+	size_t MUsed = 0;
+};
@@ -14,6 +14,9 @@ Mail : ayoub.ahmad@mds.ac.nz
 
 #pragma once
 
+#include "Bounds.h"
+#include "GeometryArena.h"
+#include "ResidentSize.h"
 #include "Shader.h"
 
 #include <glew.h>
@@ -33,37 +36,10 @@ struct Vertex
 	}
 };
 
-namespace std
-{
-	template <>
-	struct hash<glm::vec2>
-	{
-		size_t operator()(const glm::vec2& V) const noexcept
-		{
-			return hash<float>()(V.x) ^ (hash<float>()(V.y) << 1);
-		}
-	};
-
-	template <>
-	struct hash<glm::vec3>
-	{
-		size_t operator()(const glm::vec3& V) const noexcept
-		{
-			return hash<float>()(V.x) ^ (hash<float>()(V.y) << 1) ^ (hash<float>()(V.z) << 2);
-		}
-	};
-
-	template <>
-	struct hash<Vertex>
-	{
-		size_t operator()(const Vertex& Vertex) const noexcept
-		{
-			return ((hash<glm::vec3>()(Vertex.Position) ^
-					(hash<glm::vec3>()(Vertex.Normal) << 1)) >> 1) ^
-				(hash<glm::vec2>()(Vertex.TexCoords) << 1);
-		}
-	};
-}
+// Collapses one vertex per index (a mesh's triangle corners) into its unique vertices, in
+// first-seen order, plus an index per corner into them. Uses a flat open-addressing table
+// keyed by a hash of the vertex's bytes, sized once from the corner count.
+void deduplicateVertices(const std::vector<Vertex>& Corners, std::vector<Vertex>& Vertices, std::vector<unsigned int>& Indices);
 
 struct Texture
 {
@@ -72,22 +48,43 @@ struct Texture
 	std::string Path;
 };
 
+// Owns its range of the geometry arena and releases it on destruction. Move-only, so a mesh
+// is never uploaded or released twice. Textures belong to the Model; the mesh only binds them.
 class Mesh
 {
 public:
-	Mesh(std::vector<Vertex> Vertices, std::vector<unsigned int> Indices, std::vector<Texture> Textures);
+	Mesh(std::vector<Vertex>&& Vertices, std::vector<unsigned int>&& Indices, CpuGeometryPolicy Policy);
+	~Mesh();
+
+	Mesh(const Mesh&) = delete;
+	Mesh& operator=(const Mesh&) = delete;
+	Mesh(Mesh&& Other) noexcept;
+	Mesh& operator=(Mesh&& Other) noexcept;
 
 	void draw(const Shader& Shader) const;
-	void cleanup();  // Add this method to clean up the Mesh
+	void drawInstanced(GLsizei InstanceCount) const;  // Textures and uniforms are left as bound
+	void cleanup();  // Returns the geometry to the arena
+
+	[[nodiscard]] GeometryHandle getGeometry() const;
+
+	// Empty unless the mesh was loaded with CpuGeometryPolicy::Keep
+	[[nodiscard]] bool hasCpuGeometry() const;
+	[[nodiscard]] const std::vector<Vertex>& getVertices() const;
+	[[nodiscard]] const std::vector<unsigned int>& getIndices() const;
 
-	std::vector<Vertex> Vertices;
-	std::vector<unsigned int> Indices;
 	std::vector<Texture> Textures;
 
+	// Object-space bounds, computed once at load
+	Aabb Bounds;
+	BoundingSphere Sphere;
+
 private:
 	void setupMesh();
+	void computeBounds();
+
+	std::vector<Vertex> MVertices;
+	std::vector<unsigned int> MIndices;
 
-	unsigned int MVao;
-	unsigned int MVbo;
-	unsigned int MEbo;
+	// Vertex and index data live in the shared GeometryArena
+	GeometryHandle MGeometry;
 };
@@ -16,28 +16,86 @@ Mail : ayoub.ahmad@mds.ac.nz
 
 #include "Shader.h"
 #include "Mesh.h"
+#include "ResidentSize.h"
 
 #include <glew.h>
 #include <glm.hpp>
+#include <memory>
 #include <string>
 #include <vector>
 
+// Pixels decoded by stb_image, freed with stbi_image_free
+struct DecodedImage
+{
+	struct PixelDeleter
+	{
+		void operator()(unsigned char* Pixels) const;
+	};
+
+	std::unique_ptr<unsigned char, PixelDeleter> Pixels;
+	int Width = 0;
+	int Height = 0;
+	int Components = 0;
+};
+
+// The CPU half of a model load: parsed meshes and the decoded texture. Building one touches
+// no GL state, so it can run on a worker thread; the Model constructor then uploads it.
+struct ModelSource
+{
+	struct MeshSource
+	{
+		std::vector<Vertex> Vertices;
+		std::vector<unsigned int> Indices;
+	};
+
+	std::vector<MeshSource> Meshes;
+	DecodedImage Image;
+	std::string TexturePath;
+};
+
+// Owns its meshes and textures and releases both on destruction. Move-only, like Mesh.
 class Model
 {
 public:
-	Model(const std::string& ModelPath, const std::string& TexturePath);
+	Model(const std::string& ModelPath, const std::string& TexturePath, CpuGeometryPolicy Policy = CpuGeometryPolicy::Release);
+	explicit Model(ModelSource&& Source, CpuGeometryPolicy Policy = CpuGeometryPolicy::Release);
+	~Model();
+
+	// Parses the OBJ and decodes the texture without touching GL; safe on any thread
+	static ModelSource read(const std::string& ModelPath, const std::string& TexturePath);
+	// Parses just the OBJ into Source.Meshes; read() calls it before decoding the texture
+	static void readMeshes(const std::string& Path, ModelSource& Source);
+
+	Model(const Model&) = delete;
+	Model& operator=(const Model&) = delete;
+	Model(Model&& Other) noexcept;
+	Model& operator=(Model&& Other) noexcept;
 
 	void draw(const Shader& Shader) const;
+	void drawInstanced(GLsizei InstanceCount) const;
 	void cleanup();
 
+	[[nodiscard]] const std::vector<Mesh>& getMeshes() const;
+	[[nodiscard]] const Aabb& getBounds() const;
+	[[nodiscard]] const BoundingSphere& getBoundingSphere() const;
+	[[nodiscard]] ResidentSize getResidentSize() const;
+
 private:
-	void loadModel(const std::string& Path);
-	void loadTexture(const std::string& Path);
+	void computeBounds();
 
 	std::vector<Mesh> MMeshes;
-	std::string MDirectory;
 	std::vector<Texture> MTexturesLoaded;
 	std::string MTexturePath;
+	Aabb MBounds;
+	BoundingSphere MSphere;
+	size_t MTextureBytes = 0;
 };
 
 unsigned int textureFromFile(const char* Path, const std::string& Directory, bool Gamma = false);
+
+// Split halves of textureFromFile: decoding is thread-safe, creating the texture needs GL
+DecodedImage decodeImage(const std::string& Path);
+unsigned int createTexture(const DecodedImage& Image);
+
+// Level 0 size of a 2D texture plus a third for its mip chain, assuming 4 bytes per texel
+size_t estimateTextureBytes(unsigned int Texture);
@@ -0,0 +1,48 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : ObjParser.h
+Description : Definitions for the chunked, multithreaded OBJ parser
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include "tiny_obj_loader.h"
+
+#include <string>
+#include <vector>
+
+// One OBJ file in tinyobjloader's layout: flat attribute arrays shared by every shape, and
+// each shape's triangulated corners as indices into them
+struct ObjGeometry
+{
+	struct Shape
+	{
+		std::string Name;
+		std::vector<tinyobj::index_t> Corners;
+	};
+
+	std::vector<float> Positions;
+	std::vector<float> Normals;
+	std::vector<float> TexCoords;
+	std::vector<Shape> Shapes;
+};
+
+// Parses an OBJ on the job system. The file is split into line-range chunks: one pass counts
+// each chunk's attributes so every chunk knows where its own start in the shared arrays, a
+// second pass parses the chunks in parallel straight into place, and the faces are then
+// triangulated per shape and chunk in parallel. Values, indices and triangulation come from
+// tinyobjloader's own routines, so the result matches tinyobj::LoadObj for v, vn, vt, f, o
+// and g. Materials, smoothing groups, lines and points are ignored; the renderer draws
+// each model with one texture.
+//
+// Safe to call from a worker: its waits run other jobs. Returns false on an unreadable file
+// or a malformed face, with the reason in Errors.
+bool parseObj(const std::string& Path, ObjGeometry& Geometry, std::string& Warnings, std::string& Errors);
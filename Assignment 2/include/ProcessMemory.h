@@ -0,0 +1,25 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : ProcessMemory.h
+Description : Definitions for querying the process's resident memory
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+// Physical memory currently mapped into the process (the working set on Windows), or 0 when
+// the platform does not report it. Includes driver allocations, so it is a whole-process
+// figure to compare between scenes rather than a sum of the assets.
+size_t getProcessResidentBytes();
+
+// Prints the resident memory around a scene switch, in megabytes
+void printProcessMemory(const char* Label, size_t BeforeBytes, size_t AfterBytes);
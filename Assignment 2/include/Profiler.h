@@ -0,0 +1,151 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : Profiler.h
+Description : Definitions for the CPU zone profiler and its Chrome trace export
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Instrumentation is compiled in only when ENABLE_PROFILER is defined (the project defines it
+// for Debug and Profile, the optimised build to measure with); without it, as in Release, every
+// macro expands to nothing.
+//   PROFILE_ZONE("Name")   - times the enclosing scope; the name must be a string literal
+//   PROFILE_FUNCTION()     - PROFILE_ZONE named after the enclosing function
+//   PROFILE_THREAD("Name") - names the calling thread in traces and summaries
+//   PROFILE_FRAME()        - ends the frame, once per frame on the main thread
+#ifdef ENABLE_PROFILER
+#define PROFILE_CONCAT_INNER(A, B) A##B
+#define PROFILE_CONCAT(A, B) PROFILE_CONCAT_INNER(A, B)
+#define PROFILE_ZONE(Name) ProfileZone PROFILE_CONCAT(ProfileZone, __LINE__)(Name)
+#define PROFILE_FUNCTION() PROFILE_ZONE(__func__)
+#define PROFILE_THREAD(Name) Profiler::getInstance().setThreadName(Name)
+#define PROFILE_FRAME() Profiler::getInstance().endFrame()
+#else
+#define PROFILE_ZONE(Name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#define PROFILE_THREAD(Name) ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#endif
+
+struct ProfileEvent
+{
+	const char* Name;
+	uint64_t Start;
+	uint64_t End;
+	uint32_t Depth;
+	uint32_t Thread;
+};
+
+// Time spent under one call path in one thread, summed over the frames it covers
+struct ProfileZoneTotal
+{
+	std::string Path;
+	const char* Name;
+	uint32_t Thread;
+	uint32_t Depth;
+	double Ms = 0.0;
+	unsigned int Calls = 0;
+};
+
+// Each thread writes finished zones into its own ring with a single release store, so
+// recording takes no lock. endFrame() drains every ring on the main thread; a ring that
+// laps its reader overwrites the oldest zones. Timestamps are raw CPU ticks, converted to
+// time only when a summary or trace is produced.
+//
+// Pressing P captures the next CaptureFrames frames, then writes them as a Chrome trace
+// (chrome://tracing or ui.perfetto.dev) and prints their average per-frame summary.
+class Profiler
+{
+public:
+	static constexpr unsigned int CaptureFrames = 120;
+
+	static Profiler& getInstance();
+
+	static uint64_t now();
+	void record(const char* Name, uint64_t Start, uint64_t End, uint32_t Depth);
+	void setThreadName(const std::string& Name);
+
+	void endFrame();
+	void beginCapture(unsigned int Frames = CaptureFrames);
+	[[nodiscard]] bool isCapturing() const;
+
+	bool writeChromeTrace(const std::string& Path) const;
+	void printFrameSummary() const;
+	[[nodiscard]] std::vector<ProfileZoneTotal> summarize() const;
+	[[nodiscard]] double getLastFrameMs() const;
+
+	inline static thread_local uint32_t Depth = 0;
+
+private:
+	Profiler();
+
+	static constexpr uint32_t RingSize = 1 << 16;
+
+	struct ThreadRing
+	{
+		std::unique_ptr<ProfileEvent[]> Events = std::make_unique<ProfileEvent[]>(RingSize);
+		std::atomic<uint64_t> Written = 0;
+		uint64_t Read = 0;
+		uint32_t Index = 0;
+		std::string Name;
+	};
+
+	ThreadRing& getRing();
+	void drain(std::vector<ProfileEvent>& Out);
+	[[nodiscard]] double ticksToMs(uint64_t Ticks) const;
+	void calibrate();
+
+	std::mutex MRingsMutex;
+	std::vector<std::unique_ptr<ThreadRing>> MRings;
+
+	std::vector<ProfileEvent> MFrameEvents;
+	std::vector<ProfileEvent> MCaptured;
+	unsigned int MCaptureRemaining = 0;
+	unsigned int MCapturedFrames = 0;
+	uint64_t MFrameStart = 0;
+	double MLastFrameMs = 0.0;
+	uint64_t MFrameIndex = 0;
+
+	uint64_t MTickOrigin = 0;
+	int64_t MClockOrigin = 0;
+	double MMsPerTick = 0.0;
+};
+
+// Stack object behind PROFILE_ZONE: reads the clock on entry and records the zone on exit
+class ProfileZone
+{
+public:
+	explicit ProfileZone(const char* Name)
+		: MName(Name), MStart(Profiler::now())
+	{
+		Profiler::Depth++;
+	}
+
+	~ProfileZone()
+	{
+		Profiler::Depth--;
+		Profiler::getInstance().record(MName, MStart, Profiler::now(), Profiler::Depth);
+	}
+
+	ProfileZone(const ProfileZone&) = delete;
+	ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+	const char* MName;
+	uint64_t MStart;
+};
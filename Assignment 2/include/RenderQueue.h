@@ -0,0 +1,81 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : RenderQueue.h
+Description : Definitions for the sorted draw packet queue in OpenGL
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include "CommandBuffer.h"
+#include "GeometryArena.h"
+#include "Model.h"
+#include "Shader.h"
+
+#include <glew.h>
+#include <glm.hpp>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Where the time went in the parallel recording of the last flushed frame
+struct RecordStats
+{
+	size_t Batches = 0;
+	size_t Packets = 0;
+	double WallMs = 0.0;
+	std::vector<double> ThreadMs;  // Indexed by JobSystem::getThreadIndex()
+};
+
+// Scenes submit packets in any order, either directly on the GL thread or by recording
+// batches into command buffers across the job system. flush() sorts every packet so that
+// packets sharing a program, then a texture, then a cull face are drawn back to back, and
+// issues the state through GLStateCache so only the changes between neighbouring packets
+// reach the driver.
+//
+// Key layout, most significant first:
+//   program (20 bits) | texture (20 bits) | cull face (1 bit) | geometry (23 bits)
+class RenderQueue
+{
+public:
+	void submit(const Shader& Program, GLuint Texture, GeometryHandle Geometry, const glm::mat4& Transform, GLenum CullFace = GL_BACK);
+	void submit(const Shader& Program, const Model& Model, const glm::mat4& Transform, GLenum CullFace = GL_BACK);
+
+	// Splits [0, Count) into batches of BatchSize items, each recorded into its own command
+	// buffer by Record(Buffer, Begin, End) on the job system. Record runs on several threads at
+	// once, so it may only read shared state. Returns once every batch is recorded.
+	void record(size_t Count, size_t BatchSize, const std::function<void(CommandBuffer&, size_t, size_t)>& Record);
+
+	void flush();
+	void clear();
+	[[nodiscard]] size_t size() const;
+	[[nodiscard]] const RecordStats& getRecordStats() const;
+	void printRecordStats() const;
+
+	static uint64_t makeKey(GLuint Program, GLuint Texture, GLenum CullFace, GeometryHandle Geometry);
+
+private:
+	struct SortEntry
+	{
+		uint64_t Key;
+		const DrawPacket* Packet;
+	};
+
+	void gather(const CommandBuffer& Buffer);
+	void resetBuffers();
+
+	CommandBuffer MImmediate;
+	std::vector<std::unique_ptr<CommandBuffer>> MBuffers;  // One per batch, kept between frames
+	size_t MBuffersUsed = 0;
+	std::vector<SortEntry> MSorted;
+	RecordStats MPendingStats;
+	RecordStats MRecordStats;
+};
@@ -0,0 +1,113 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : ResidencyManager.h
+Description : Definitions for the budgeted LRU cache of loaded models, terrains and skyboxes
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include "ResidentSize.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Model;
+class Skybox;
+class Terrain;
+struct HeightMapInfo;
+
+struct ResidencyBudget
+{
+	size_t GpuBytes = size_t{512} << 20;
+	size_t CpuBytes = size_t{256} << 20;
+};
+
+struct ResidencyStats
+{
+	unsigned int Hits = 0;
+	unsigned int Loads = 0;
+	unsigned int Evictions = 0;
+};
+
+struct ModelRequest
+{
+	std::string ModelPath;
+	std::string TexturePath;
+	CpuGeometryPolicy Policy = CpuGeometryPolicy::Release;
+};
+
+struct EvictionEvent
+{
+	std::string Key;
+	ResidentSize Size;
+	uint64_t IdleSwitches;  // Scene switches since the asset was last acquired
+};
+
+// Scenes acquire their models, terrain and skybox here instead of loading them. Assets stay
+// resident after the scene that loaded them is destroyed, so switching back to a recent
+// scene, or to another scene using the same files, reuses them without touching the disk.
+// trim() evicts assets no scene holds, least recently acquired first, until both the GPU and
+// CPU totals fit the budget. Assets still in use are never evicted.
+class ResidencyManager
+{
+public:
+	using EvictionListener = std::function<void(const EvictionEvent&)>;
+
+	static ResidencyManager& getInstance();
+
+	std::shared_ptr<Model> acquireModel(const std::string& ModelPath, const std::string& TexturePath, CpuGeometryPolicy Policy = CpuGeometryPolicy::Release);
+	// Acquires several models at once: the ones not resident are parsed and decoded in
+	// parallel on the job system and uploaded on this thread as each one finishes
+	std::vector<std::shared_ptr<Model>> acquireModels(const std::vector<ModelRequest>& Requests);
+	std::shared_ptr<Terrain> acquireTerrain(const HeightMapInfo& Info, CpuGeometryPolicy Policy = CpuGeometryPolicy::Release);
+	std::shared_ptr<Skybox> acquireSkybox();
+
+	// Advances the LRU clock once per scene switch and evicts down to the budget
+	void trim();
+	void shutdown();
+
+	void setBudget(const ResidencyBudget& Budget);
+	[[nodiscard]] const ResidencyBudget& getBudget() const;
+	void setEvictionListener(EvictionListener Listener);
+
+	[[nodiscard]] ResidentSize getResidentSize() const;
+	[[nodiscard]] ResidentSize getResidentSize(const std::string& Key) const;
+	[[nodiscard]] const ResidencyStats& getStats() const;
+	void printStats(const char* Label) const;
+
+private:
+	ResidencyManager() = default;
+
+	struct ResidentAsset
+	{
+		std::shared_ptr<void> Object;
+		std::function<void()> Release;
+		ResidentSize Size;
+		uint64_t LastUse = 0;
+	};
+
+	template <typename T, typename Loader, typename Measure>
+	std::shared_ptr<T> acquire(const std::string& Key, Loader&& Load, Measure&& Size, std::function<void(T&)> Release);
+
+	static std::string getModelKey(const std::string& ModelPath, const std::string& TexturePath, CpuGeometryPolicy Policy);
+	void evict(std::unordered_map<std::string, ResidentAsset>::iterator Asset);
+
+	std::unordered_map<std::string, ResidentAsset> MAssets;
+	ResidencyBudget MBudget;
+	ResidentSize MTotal;
+	ResidencyStats MStats;
+	EvictionListener MListener;
+	uint64_t MClock = 0;
+};
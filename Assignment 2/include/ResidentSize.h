@@ -0,0 +1,45 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : ResidentSize.h
+Description : Definitions for the GPU and CPU memory held by a loaded asset
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+struct ResidentSize
+{
+	size_t GpuBytes = 0;
+	size_t CpuBytes = 0;
+
+	ResidentSize& operator+=(const ResidentSize& Other)
+	{
+		GpuBytes += Other.GpuBytes;
+		CpuBytes += Other.CpuBytes;
+		return *this;
+	}
+
+	ResidentSize& operator-=(const ResidentSize& Other)
+	{
+		GpuBytes -= Other.GpuBytes;
+		CpuBytes -= Other.CpuBytes;
+		return *this;
+	}
+};
+
+// Whether an asset keeps its vertex, index or height data on the CPU once it is uploaded.
+// Drawing only needs the GPU copy; keep the CPU one for meshes that are picked or collided with.
+enum class CpuGeometryPolicy
+{
+	Release,
+	Keep
+};
@@ -4,10 +4,23 @@
 #include "LightManager.h"
 #include "Model.h"
 #include "Skybox.h"
+#include "ResidencyManager.h"
+#include "FrustumCulling.h"
+#include "RenderQueue.h"
+#include "EntityWorld.h"
 #include <memory>
+#include <vector>
+
+inline constexpr const char* WindowTitle = "OpenGL More Framebuffers and Shaders";
+
+// A model placed in the scene. Instances are gathered at load and frustum culled as one batch per frame.
+struct ModelInstance {
+    const Model* Source;
+    glm::mat4 Transform;
+};
 
 // Enum to track the active scene
-enum class SceneType { SCENE_1, SCENE_2, SCENE_3, SCENE_4 };
+enum class SceneType { SCENE_1, SCENE_2, SCENE_3, SCENE_4, SCENE_5 };
 
 class Scene {
 public:
@@ -16,7 +29,44 @@ public:
     virtual void update(float deltaTime) = 0; // Update scene elements (input, animations, etc.)
     virtual void render() = 0;    // Render the scene
     virtual void cleanup() = 0;   // Clean up resources
+    virtual void handleKey(int key) {}  // Scene-specific key press (forwarded by InputManager)
 
     // Add the switchScene function
     static void switchScene(SceneType newScene, std::unique_ptr<Scene>& currentScene, SceneType& activeScene, Camera& camera, LightManager& lightManager);
+
+    // Sorted render queue plus redundant state filtering (R toggles, to compare GL call counts)
+    static void toggleRenderQueue();
+
+    // Rolling GPU pass times in the window title while the GPU profiler overlay is on (T toggles)
+    static void showGpuOverlay();
+
+protected:
+    // Selects the lighting shader variant matching the light toggles and uploads the per-frame uniforms
+    static void bindLightingShader(Shader& lightingShader, const Camera& camera, const LightManager& lightManager, const Material& material, bool textured,
+                                   float width = 800.0f, float height = 600.0f);
+
+    // Records an instance and its world-space bounding sphere
+    static void addInstance(std::vector<ModelInstance>& instances, FrustumCuller& culler, const Model& model, const glm::mat4& transform);
+
+    // Culls all instances against the camera and draws the visible ones, through the render queue when enabled
+    static void drawVisibleInstances(const Shader& shader, const std::vector<ModelInstance>& instances, FrustumCuller& culler, const Camera& camera,
+                                     float width = 800.0f, float height = 600.0f);
+
+    // Creates an entity drawing the model under the given scene graph node
+    static Entity addEntity(EntityWorld& world, const Model& model, NodeId parent, const glm::vec3& position, const glm::vec3& scale, bool textured = true);
+
+    // Render submission: culls the world's entities and draws the visible textured ones, through the render queue when enabled
+    static void drawVisibleEntities(const Shader& shader, EntityWorld& world, const Camera& camera);
+
+    // Draws the visible untextured entities from the last cull in their light's colour, or their solid colour
+    static void drawSolidEntities(const Shader& shader, EntityWorld& world, LightManager& lightManager);
+
+    // Prints the render queue's per-thread recording times every few seconds
+    static void showRecordStats();
+
+    // Shows the last frame's visible/culled counts in the window title
+    static void showCullingStats(unsigned int visible, unsigned int culled, unsigned int occluded = 0);
+
+    inline static RenderQueue Queue;
+    inline static bool UseRenderQueue = true;
 };
@@ -6,7 +6,13 @@
 #include "Camera.h"
 #include "LightManager.h"
 #include "Terrain.h"  // Include the Terrain header
+#include "GpuDrivenRenderer.h"
+#include "HiZBuffer.h"
+#include "ImpostorAtlas.h"
+#include "StaticBatch.h"
+#include "VegetationScatter.h"
 #include <iostream>
+#include <vector>
 
 class Scene1 : public Scene {
 public:
@@ -16,17 +22,56 @@ public:
     void update(float deltaTime) override;
     void render() override;
     void cleanup() override;
+    void handleKey(int key) override;
 
 private:
+    void buildInstances();
+    void buildStaticBatches();
+    void renderOccluders();
+    void printFrameTimings() const;
+
     Shader LightingShader;
     Shader SkyboxShader;
     Shader TerrainShader;
-    Model GardenPlant, Tree, Statue;
-    Skybox LSkybox;
+    Shader GpuDrivenShader;
+    Shader ImpostorShader;
+    Shader VegetationShader;
+    // Shared through the residency manager, which keeps them loaded after the scene is gone
+    std::shared_ptr<Model> GardenPlant, Tree, Statue;
+    std::shared_ptr<Skybox> LSkybox;
     Camera& GCamera;
     LightManager& GLightManager;
     Material material;
 
+    // Terrain placement, and a garden root holding the plant, tree and statue entities
+    EntityWorld World;
+    NodeId TerrainNode;
+    Entity StatueEntity;
+
     // Add terrain instance
-    Terrain terrain;
+    std::shared_ptr<Terrain> terrain;
+
+    // GPU-driven path (G toggles, =/- resize the plant field and the forest around it)
+    GpuDrivenRenderer GpuDriven;
+    bool UseGpuDriven;
+    int PlantGridRadius;
+
+    // Static batches replace the per-model draws on the CPU path (B toggles, rebuilt with the plant field)
+    StaticBatcher Batches;
+    bool UseStaticBatches;
+
+    // Distant plants and trees drawn as octahedral impostors on the GPU-driven path (I toggles)
+    ImpostorAtlas Impostors;
+    bool UseImpostors;
+
+    // Plants scattered over the terrain on the GPU, region by region as they come into view (V toggles)
+    VegetationScatter Vegetation;
+    bool UseVegetation;
+
+    // Hi-Z occlusion against the terrain and statue (O toggles); frame times are kept per
+    // combination of occlusion and impostors
+    HiZBuffer Occlusion;
+    bool UseOcclusion;
+    double FrameTimeTotal[4];
+    unsigned int FrameTimeCount[4];
 };
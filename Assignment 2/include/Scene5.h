@@ -0,0 +1,81 @@
+#pragma once
+#include "Scene.h"
+#include "Shader.h"
+#include "Model.h"
+#include "Skybox.h"
+#include "Camera.h"
+#include "LightManager.h"
+#include "ClusteredLighting.h"
+#include "DeferredRenderer.h"
+#include <string>
+#include <vector>
+
+// Light stress scene: hundreds of animated point lights, shaded forward (clustered or unculled)
+// or deferred with light volumes
+class Scene5 : public Scene {
+public:
+    Scene5(Camera& camera, LightManager& lightManager);
+    void load() override;
+    void update(float deltaTime) override;
+    void render() override;
+    void cleanup() override;
+    void handleKey(int key) override;
+
+private:
+    struct SweepConfig {
+        int LightCount;
+        PointLightPath Path;
+        bool Deferred;
+        int Width;
+        int Height;
+    };
+
+    struct SweepResult {
+        SweepConfig Config;
+        int ViewportWidth;
+        int ViewportHeight;
+        double AverageFrameMs;
+    };
+
+    void generateLights(int count);
+    void animateLights();
+    void renderForward(int width, int height);
+    void renderDeferred(int width, int height);
+    void drawTexturedGeometry(const Shader& shader, int width, int height);
+    void drawLightMarkers(const Shader& shader) const;
+    void applySweepConfig(const SweepConfig& config);
+    void startSweep();
+    void updateSweep(float deltaTime);
+    void writeSweepResults() const;
+
+    Shader LightingShader;
+    Shader SkyboxShader;
+    // Shared through the residency manager, which keeps them loaded after the scene is gone
+    std::shared_ptr<Model> GardenPlant;
+    std::shared_ptr<Model> Statue;
+    std::shared_ptr<Model> Sphere;
+    std::shared_ptr<Skybox> LSkybox;
+    Camera& GCamera;
+    LightManager& GLightManager;
+    Material material;
+    ClusteredLighting Clustered;
+    DeferredRenderer Deferred;
+
+    // Static instances and their bounding spheres for frustum culling
+    std::vector<ModelInstance> Instances;
+    FrustumCuller Culler;
+
+    int LightCount;
+    bool UseDeferred;
+    float Time;
+
+    // Frame-time sweep over light counts, shading paths and resolutions (B key)
+    bool Sweeping;
+    size_t SweepStep;
+    int SweepFrame;
+    double SweepAccumulatedMs;
+    int RestoreWidth;
+    int RestoreHeight;
+    std::vector<SweepConfig> SweepSteps;
+    std::vector<SweepResult> SweepResults;
+};
@@ -0,0 +1,155 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : SceneDescription.h
+Description : Definitions for the text and binary scene description formats
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+constexpr uint32_t SceneFileMagic = 0x424E4353; // "SCNB"
+constexpr uint32_t SceneFileVersion = 1;
+constexpr int32_t SceneNoParent = -1;
+constexpr uint32_t SceneNoModel = UINT32_MAX;
+
+// Binary layout, every section 4-byte aligned and in this order:
+//   header | models | terrain (0 or 1) | groups | entities | lights | string table
+// Strings are referenced by byte offset into the null-terminated string table.
+struct SceneFileHeader
+{
+	uint32_t Magic;
+	uint32_t Version;
+	uint32_t ModelCount;
+	uint32_t TerrainCount;
+	uint32_t GroupCount;
+	uint32_t EntityCount;
+	uint32_t LightCount;
+	uint32_t StringBytes;
+	float ClearColour[3];
+	uint32_t Flags;
+};
+
+enum SceneFileFlags : uint32_t
+{
+	SceneStaticBatching = 1
+};
+
+struct SceneModelRecord
+{
+	uint32_t Path;
+	uint32_t Texture;
+};
+
+struct SceneTerrainRecord
+{
+	uint32_t HeightMap;
+	uint32_t Width;
+	uint32_t Depth;
+	float CellSpacing;
+	float Scale[3];
+};
+
+// Groups come before their children, so Parent is always a lower index or SceneNoParent
+struct SceneGroupRecord
+{
+	int32_t Parent;
+	float Position[3];
+	float Scale[3];
+};
+
+enum SceneEntityFlags : uint32_t
+{
+	SceneEntityTextured = 1
+};
+
+struct SceneEntityRecord
+{
+	uint32_t Model;
+	int32_t Group;
+	float Position[3];
+	float Scale[3];
+	float Colour[3];
+	uint32_t Flags;
+	int32_t Light;
+};
+
+struct SceneLightRecord
+{
+	float Colour[3];
+	float Constant;
+	float Linear;
+	float Quadratic;
+};
+
+// A scene's models, groups, entities and lights. The text form is line based and meant to be
+// edited by hand; --compile-scene turns it into the binary form, which loads with one read
+// into a single buffer and is used in place, without a per-entity allocation.
+//
+// Text commands, one per line ('#' starts a comment, '-' means none):
+//   clear   r g b
+//   batch   on|off   (merge the textured entities into static batches at load)
+//   terrain heightmap width depth cellSpacing scaleX scaleY scaleZ
+//   model   name objPath texture|-
+//   group   name parent|- x y z [scale]
+//   entity  model group|- x y z scale
+//   solid   model group|- x y z scale r g b
+//   grid    model group|- x0 x1 z0 z1 y stepX stepZ scale
+//   light   model|- group|- x y z scale r g b constant linear quadratic
+class SceneDescription
+{
+public:
+	bool load(const std::string& Path);
+	bool loadText(const std::string& Path);
+	bool loadBinary(const std::string& Path);
+	bool saveBinary(const std::string& Path) const;
+
+	// Compiles a text description into its binary form
+	static bool compile(const std::string& TextPath, const std::string& BinaryPath);
+
+	[[nodiscard]] bool isLoaded() const;
+	[[nodiscard]] size_t getSize() const;
+	[[nodiscard]] const SceneFileHeader& getHeader() const;
+	[[nodiscard]] std::span<const SceneModelRecord> getModels() const;
+	[[nodiscard]] const SceneTerrainRecord* getTerrain() const;
+	[[nodiscard]] std::span<const SceneGroupRecord> getGroups() const;
+	[[nodiscard]] std::span<const SceneEntityRecord> getEntities() const;
+	[[nodiscard]] std::span<const SceneLightRecord> getLights() const;
+	[[nodiscard]] const char* getString(uint32_t Offset) const;
+
+private:
+	struct Layout
+	{
+		size_t Models;
+		size_t Terrain;
+		size_t Groups;
+		size_t Entities;
+		size_t Lights;
+		size_t Strings;
+		size_t End;
+	};
+
+	static Layout computeLayout(const SceneFileHeader& Header);
+	bool validate(const std::string& Path) const;
+
+	template <typename T>
+	const T* at(size_t Offset) const
+	{
+		return reinterpret_cast<const T*>(MBlob.data() + Offset);
+	}
+
+	std::vector<char> MBlob;
+	Layout MLayout = {};
+};
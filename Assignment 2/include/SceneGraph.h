@@ -0,0 +1,79 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : SceneGraph.h
+Description : Definitions for the transform hierarchy with cached world matrices
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include <glm.hpp>
+#include <gtc/quaternion.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using NodeId = uint32_t;
+constexpr NodeId InvalidNode = UINT32_MAX;
+
+// World[Node] = World[Parent[Node]] * Local[Node] for each listed node
+using TransformMultiply = void (*)(const NodeId* Nodes, size_t Count, const NodeId* Parents, const glm::mat4* Local, glm::mat4* World);
+void multiplyTransformsScalar(const NodeId* Nodes, size_t Count, const NodeId* Parents, const glm::mat4* Local, glm::mat4* World);
+void multiplyTransformsSse(const NodeId* Nodes, size_t Count, const NodeId* Parents, const glm::mat4* Local, glm::mat4* World);
+
+// Nodes are stored as parallel arrays in creation order. A parent must exist before its
+// children, so the arrays are always in topological order and one forward pass can push a
+// dirty flag from every parent to its whole subtree. Only dirty nodes are recomputed; a
+// graph where nothing moved returns from update() immediately.
+class SceneGraph
+{
+public:
+	NodeId createNode(NodeId Parent = InvalidNode, const glm::vec3& Position = glm::vec3(0.0f),
+	                  const glm::quat& Rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f), const glm::vec3& Scale = glm::vec3(1.0f));
+	void clear();
+	void reserve(size_t Count);
+
+	void setPosition(NodeId Node, const glm::vec3& Position);
+	void setRotation(NodeId Node, const glm::quat& Rotation);
+	void setScale(NodeId Node, const glm::vec3& Scale);
+
+	// Recomputes the dirty nodes and their descendants, returning how many were updated
+	unsigned int update(TransformMultiply Multiply = multiplyTransformsSse);
+
+	[[nodiscard]] const glm::mat4& getWorld(NodeId Node) const;
+	[[nodiscard]] const glm::mat4& getLocal(NodeId Node) const;
+	[[nodiscard]] NodeId getParent(NodeId Node) const;
+	[[nodiscard]] size_t getNodeCount() const;
+
+private:
+	enum : uint8_t
+	{
+		LocalDirty = 1,
+		WorldDirty = 2
+	};
+
+	void markDirty(NodeId Node);
+
+	std::vector<NodeId> MParents;
+	std::vector<uint32_t> MDepths;
+	std::vector<glm::vec3> MPositions;
+	std::vector<glm::quat> MRotations;
+	std::vector<glm::vec3> MScales;
+	std::vector<glm::mat4> MLocal;
+	std::vector<glm::mat4> MWorld;
+	std::vector<uint8_t> MFlags;
+	bool MAnyDirty = false;
+
+	// Scratch lists reused between updates
+	std::vector<NodeId> MUpdateList;
+	std::vector<NodeId> MSortedList;
+	std::vector<uint32_t> MDepthCounts;
+	std::vector<uint32_t> MDepthCursors;
+};
@@ -17,6 +17,8 @@ Mail : ayoub.ahmad@mds.ac.nz
 #include <glew.h>
 #include <glm.hpp>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 struct Material
 {
@@ -34,20 +36,58 @@ struct Light
 	glm::vec3 Specular;
 };
 
+// Where the lighting shader reads its point lights from
+enum class PointLightPath
+{
+	Uniforms,  // NUM_POINT_LIGHTS entries of the pointLights uniform array
+	Clustered, // per-cluster light lists built by ClusteredLighting
+	Unculled   // every light in the light SSBO, as a reference for the clustered path
+};
+
+// Compile-time feature set of a shader permutation, injected as #defines after #version
+struct ShaderVariant
+{
+	bool HasTexture = false;
+	bool HasDirectionalLight = false;
+	bool HasSpotLight = false;
+	int NumPointLights = 0;
+	PointLightPath PointLights = PointLightPath::Uniforms;
+
+	[[nodiscard]] unsigned int getKey() const;
+	[[nodiscard]] std::string getDefines() const;
+	[[nodiscard]] std::string getName() const;
+};
+
+struct ShaderVariantTiming
+{
+	std::string Name;
+	unsigned int Samples = 0;
+	double TotalMs = 0.0;
+};
+
 class Shader
 {
 public:
-	Shader(const char* VertexPath, const char* FragmentPath);
+	// Defines are injected into both stages of the base program and of every variant
+	Shader(const char* VertexPath, const char* FragmentPath, const std::string& Defines = "");
+
+	void selectVariant(const ShaderVariant& Variant);
+	void flushVariantTiming();
+	void printVariantTimings() const;
 
 	void use() const;
 	void setBool(const std::string& Name, bool Value) const;
 	void setInt(const std::string& Name, int Value) const;
+	void setUInt(const std::string& Name, unsigned int Value) const;
 	void setFloat(const std::string& Name, float Value) const;
+	void setVec2(const std::string& Name, const glm::vec2& Value) const;
 	void setVec3(const std::string& Name, const glm::vec3& Value) const;
 	void setVec3(const std::string& Name, float X, float Y, float Z) const;
+	void setUVec3(const std::string& Name, const glm::uvec3& Value) const;
 	void setMat4(const std::string& Name, const glm::mat4& Mat) const;
 	void setLight(const std::string& Name, const Light& Light) const;
 	GLuint getId();
+	void cleanup();
 	static void checkCompileErrors(unsigned int Shader, const std::string& Type);
 	static void checkLinkErrors(unsigned int Program);
 
@@ -62,4 +102,25 @@ public:
 		setFloat("material.shininess", material.Shininess);
 	}
 
+private:
+	struct PendingTiming
+	{
+		unsigned int Key;
+		GLuint StartQuery;
+		GLuint EndQuery;
+	};
+
+	GLuint acquireQuery();
+	void collectVariantTimings();
+
+	std::string MVertexPath;
+	std::string MFragmentPath;
+	std::string MDefines;
+	unsigned int MBaseId = 0;
+	std::unordered_map<unsigned int, GLuint> MVariants;
+	unsigned int MCurrentKey = 0;
+	GLuint MCurrentStartQuery = 0;
+	std::vector<PendingTiming> MPendingTimings;
+	std::vector<GLuint> MFreeQueries;
+	std::unordered_map<unsigned int, ShaderVariantTiming> MVariantTimings;
 };
@@ -0,0 +1,82 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : ShaderCache.h
+Description : Definitions for the shader program binary cache in OpenGL
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include <glew.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct ShaderCacheStats
+{
+	unsigned int SourceCompiles = 0;
+	unsigned int DiskHits = 0;
+	unsigned int DiskRejects = 0;
+	unsigned int MemoryHits = 0;
+	double SourceCompileMs = 0.0;
+	double DiskHitMs = 0.0;
+};
+
+// Programs are keyed by a hash of their sources, injected defines and the driver strings.
+// Identical programs are shared between scenes and stay resident until shutdown(), so a
+// scene switch that reuses a program neither recompiles nor reloads it.
+class ShaderCache
+{
+public:
+	static ShaderCache& getInstance();
+
+	GLuint acquireProgram(const char* VertexPath, const char* FragmentPath, const std::string& Defines = "");
+	GLuint acquireComputeProgram(const char* ComputePath, const std::string& Defines = "");
+	void releaseProgram(GLuint Program);
+	void shutdown();
+
+	void printStats() const;
+	[[nodiscard]] const ShaderCacheStats& getStats() const;
+
+	static std::string readSource(const char* Path);
+	static std::string injectDefines(const std::string& Source, const std::string& Defines);
+
+private:
+	ShaderCache() = default;
+
+	struct CachedProgram
+	{
+		GLuint Program = 0;
+		unsigned int RefCount = 0;
+	};
+
+	struct ShaderStage
+	{
+		GLenum Type;
+		const char* Name;
+		std::string Source;
+	};
+
+	GLuint acquire(const std::vector<ShaderStage>& Stages, const std::string& Label);
+
+	const std::string& getDriverString();
+	[[nodiscard]] std::string getBinaryPath(uint64_t Key) const;
+	GLuint loadBinary(uint64_t Key);
+	void saveBinary(uint64_t Key, GLuint Program) const;
+	static GLuint compileProgram(const std::vector<ShaderStage>& Stages);
+
+	std::unordered_map<uint64_t, CachedProgram> MPrograms;
+	std::string MDriverString;
+	std::string MCacheDirectory = "cache/shaders";
+	ShaderCacheStats MStats;
+};
+
+uint64_t hashBytes(const void* Data, size_t Size, uint64_t Seed = 14695981039346656037ull);
@@ -14,6 +14,9 @@ Mail : ayoub.ahmad@mds.ac.nz
 
 #pragma once
 
+#include "GeometryArena.h"
+#include "Model.h"
+#include "ResidentSize.h"
 #include "Shader.h"
 
 #include <glew.h>
@@ -31,13 +34,18 @@ public:
 	void render(const Shader& skyboxShader, const Camera& camera, int scrWidth, int scrHeight) const;
 	void cleanup();
 
+	[[nodiscard]] ResidentSize getResidentSize() const;
+
+	// The CPU half of loadCubeMap: every face decoded, without touching GL
+	static std::vector<DecodedImage> decodeFaces(const std::vector<std::string>& Faces);
+
 private:
 	void setupSkybox();
-	static unsigned int loadCubeMap(const std::vector<std::string>& Faces);
+	static unsigned int loadCubeMap(const std::vector<std::string>& Faces, size_t& Bytes);
 
-	unsigned int MVao;
-	unsigned int MVbo;
+	GeometryHandle MGeometry;
 	unsigned int MCubeMapTexture;
+	size_t MCubeMapBytes = 0;
 
 	std::vector<std::string> Faces;
 };
@@ -0,0 +1,95 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : StaticBatch.h
+Description : Definitions for merging static meshes into pre-transformed batches
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include "FrustumCulling.h"
+#include "Mesh.h"
+
+#include <glm.hpp>
+#include <string>
+#include <vector>
+
+class Model;
+
+// What batching a scene costs and saves, printed after each build
+struct StaticBatchStats
+{
+	unsigned int Instances = 0;
+	unsigned int SourceDraws = 0;  // Mesh draws per frame without batching
+	unsigned int Batches = 0;
+	size_t SourceBytes = 0;  // The shared meshes the instances reference, resident either way
+	size_t BatchBytes = 0;   // The merged, pre-transformed copies
+	double BuildMs = 0.0;
+};
+
+// Merges meshes that never move into a few large ones. Every added mesh is transformed to world
+// space on the CPU and appended to the batch for its texture and grid cell, so one draw covers
+// every instance in a CellSize square sharing a texture, and each batch is culled by its bounds.
+// Draw calls drop from one per mesh to one per batch at the price of a copy of the geometry per
+// instance, so a scene opts in and build() refuses to go past MaxBatchBytes.
+//
+// add() keeps pointers to the source vertices: the models (loaded with CpuGeometryPolicy::Keep)
+// must stay alive until build(). build() touches no GL state; upload() hands the batches to
+// the geometry arena.
+class StaticBatcher
+{
+public:
+	static constexpr float CellSize = 16.0f;
+	static constexpr size_t MaxBatchVertices = 1 << 20;
+	static constexpr size_t MaxBatchBytes = 256ull << 20;
+
+	// Adds every mesh of the model; false when it was loaded without CPU geometry
+	bool add(const Model& Source, const glm::mat4& Transform);
+	void add(const std::vector<Vertex>& Vertices, const std::vector<unsigned int>& Indices, const std::vector<Texture>& Textures,
+		const glm::mat4& Transform);
+
+	// Transforms and merges the added meshes in parallel; false when over MaxBatchBytes
+	bool build();
+	void upload();
+	void clear();
+
+	// Culls the batches against the frustum and draws the visible ones with an identity model matrix
+	void draw(const Shader& Shader, const Frustum& Frustum);
+
+	[[nodiscard]] bool isUploaded() const;
+	[[nodiscard]] const StaticBatchStats& getStats() const;
+	[[nodiscard]] const CullingStats& getCullingStats() const;
+	void printStats(const std::string& Label) const;
+
+private:
+	struct Item
+	{
+		const std::vector<Vertex>* Vertices;
+		const std::vector<unsigned int>* Indices;
+		const std::vector<Texture>* Textures;
+		glm::mat4 Transform;
+		size_t Batch;
+		size_t FirstVertex;
+		size_t FirstIndex;
+	};
+
+	struct PendingBatch
+	{
+		std::vector<Texture> Textures;
+		std::vector<Vertex> Vertices;
+		std::vector<unsigned int> Indices;
+	};
+
+	std::vector<Item> MItems;
+	std::vector<PendingBatch> MPending;
+	std::vector<Mesh> MBatches;
+	FrustumCuller MCuller;
+	StaticBatchStats MStats;
+};
@@ -7,6 +7,7 @@
 #include <glew.h>
 #include <glm.hpp>
 #include "Mesh.h" // Include the Mesh.h file which already has the Vertex struct
+#include "ResidentSize.h"
 
 // Structure to hold heightmap information
 struct HeightMapInfo {
@@ -19,23 +20,39 @@ struct HeightMapInfo {
 // Terrain class definition
 class Terrain {
 public:
-    Terrain(const HeightMapInfo& info);
+    static constexpr float HeightScale = 1000.0f;  // Local height of a heightmap value of 1
+
+    Terrain(const HeightMapInfo& info, CpuGeometryPolicy policy = CpuGeometryPolicy::Release);
     ~Terrain();
 
+    // Owns its arena range, so copying would release it twice
+    Terrain(const Terrain&) = delete;
+    Terrain& operator=(const Terrain&) = delete;
+
     // Setup and draw functions
-    void SetupTerrain();  // Function to set up the terrain
+    void SetupTerrain();  // Function to set up the terrain, needs the heightmap kept with CpuGeometryPolicy::Keep
     void DrawTerrain();   // Function to draw the terrain
+    ResidentSize GetResidentSize() const;  // Heightmap on the CPU, vertices, indices and height texture on the GPU
+
+    // The smoothed heightmap as a single-channel float texture (texel = column, row), kept for
+    // GPU passes that place things on the terrain after the CPU copy is released
+    GLuint GetHeightTexture() const;
+    const HeightMapInfo& GetInfo() const;
+
+    // CPU-only stages of building a terrain, also run by the benchmarks without a GL context
+    static std::vector<float> LoadHeightMap(HeightMapInfo& info);  // Load heightmap from file
+    static void SmoothHeights(std::vector<float>& heightmap, const HeightMapInfo& info);
+    static void GenerateNormals(const std::vector<float>& heightmap, const HeightMapInfo& info, std::vector<Vertex>& Vertices); // Generate normals
+    static void SetupIndexBuffer(const HeightMapInfo& info, std::vector<GLuint>& Indices); // Build the indices for indexed rendering
 
 private:
     HeightMapInfo terrainInfo;     // Terrain info
-    std::vector<float> heightmap;  // Heightmap data
-    GLuint vao, vbo, ebo;          // OpenGL buffers
+    std::vector<float> heightmap;  // Heightmap data, freed after upload unless the policy keeps it
+    GeometryHandle geometry;       // Vertex and index ranges in the geometry arena
+    GLuint heightTexture;          // R32F copy of the heightmap
 
     // Private functions for setting up and calculating the terrain
-    void LoadHeightMap();  // Load heightmap from file
-    void SmoothHeights();
-    float Average(unsigned row, unsigned col);
-    void SetupMesh();      // Setup VAO, VBO, and vertex data
-    void SetupIndexBuffer(); // Setup EBO for indexed rendering
-    void GenerateNormals(std::vector<Vertex>& Vertices); // Generate normals
+    static float Average(const std::vector<float>& heightmap, const HeightMapInfo& info, unsigned row, unsigned col);
+    void SetupMesh();      // Build the vertex data and upload it to the geometry arena
+    void SetupHeightTexture();  // Upload the heightmap for GPU height queries
 };
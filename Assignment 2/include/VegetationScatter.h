@@ -0,0 +1,137 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : VegetationScatter.h
+Description : Definitions for scattering vegetation over a terrain with compute shaders
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#pragma once
+
+#include "Bounds.h"
+#include "Camera.h"
+#include "ComputeShader.h"
+#include "GpuDrivenRenderer.h"
+#include "Shader.h"
+
+#include <glew.h>
+#include <glm.hpp>
+#include <string>
+#include <vector>
+
+class Model;
+class Terrain;
+
+// Where a model grows. Distances are in heightmap cells and heights are heightmap values, so the
+// rules do not change with the terrain's transform.
+struct ScatterRules
+{
+	float Spacing = 1.0f;           // Between neighbouring candidates, each jittered inside its own square
+	float Density = 1.0f;           // Chance that a candidate passing the rules is kept
+	float Clumping = 0.0f;          // 0 spreads the plants evenly, 1 gathers them in patches
+	float PatchSize = 24.0f;
+	float MinHeight = 0.0f;
+	float MaxHeight = 1.0f;
+	float MaxSlopeDegrees = 30.0f;  // Steeper ground stays bare
+	float MinScale = 1.0f;
+	float MaxScale = 1.0f;
+	unsigned int Seed = 1;
+};
+
+struct ScatterStats
+{
+	unsigned int Regions = 0;
+	unsigned int ResidentRegions = 0;
+	unsigned int VisibleRegions = 0;
+	unsigned int GeneratedLastFrame = 0;
+	unsigned long long Generated = 0;
+	unsigned long long Evicted = 0;
+};
+
+// Covers a terrain with instances of one model without any per-instance CPU work. The terrain is
+// split into square regions of RegionCells heightmap cells. VegetationScatter.comp fills a region
+// with a jittered grid of candidates, keeps the ones the rules and a hash allow, snaps them onto
+// the terrain's triangles and appends them to the region's slot of an instance buffer.
+//
+// Slots are a fixed pool of MaxResidentRegions. Every update() finds the regions in the frustum
+// and within the fade distance, generates the missing ones (nearest first, at most
+// MaxRegionsPerFrame) into free or least recently seen slots, and VegetationCommands.comp turns
+// the slot counts into one indirect command per slot and mesh, zero for slots out of view. The
+// whole field is then drawn with one glMultiDrawElementsIndirect through Vegetation.vert.
+class VegetationScatter
+{
+public:
+	static constexpr int RegionCells = 32;
+	static constexpr int MaxResidentRegions = 128;
+	static constexpr int MaxRegionsPerFrame = 4;
+
+	VegetationScatter();
+
+	// Each drops every generated region; they are scattered again as they come into view
+	void setTerrain(const Terrain& Terrain, const glm::mat4& Transform);
+	void setModel(const Model& Model, const ScatterRules& Rules);
+
+	// Instances fade out with dithering between these distances, and regions past the end are skipped
+	void setDrawDistance(float FadeStart, float FadeEnd);
+
+	void update(const Camera& Camera);
+	void draw(const Shader& Shader) const;
+	void cleanup();
+
+	[[nodiscard]] size_t getInstanceCapacity() const;
+	[[nodiscard]] const ScatterStats& getStats() const;
+	void printStats(const std::string& Label) const;
+
+private:
+	struct Slot
+	{
+		int Region = -1;
+		unsigned long long LastVisible = 0;
+	};
+
+	void reset();
+	[[nodiscard]] bool isReady() const;
+	[[nodiscard]] Aabb getRegionBounds(int Region) const;
+	int acquireSlot();
+	void generate(int Region, int Slot) const;
+
+	ComputeShader MScatterShader;
+	ComputeShader MCommandShader;
+
+	const Terrain* MTerrain;
+	glm::mat4 MTransform;
+	const Model* MModel;
+	ScatterRules MRules;
+	float MModelRadius;
+	float MFadeStart;
+	float MFadeEnd;
+
+	int MRegionsX;
+	int MRegionsZ;
+	GLuint MPointsPerSide;
+
+	// World bounds of every region, region to slot (-1 when not generated) and slot to region
+	std::vector<Aabb> MRegionBounds;
+	std::vector<int> MRegionSlots;
+	std::vector<Slot> MSlots;
+	std::vector<GLuint> MVisibleSlots;
+	unsigned long long MFrame;
+
+	// One command per mesh of the model; the command pass copies them for every slot
+	std::vector<DrawElementsIndirectCommand> MMeshCommands;
+	GLuint MTexture;
+
+	GLuint MInstanceBuffer;
+	GLuint MCountBuffer;
+	GLuint MMeshBuffer;
+	GLuint MVisibleBuffer;
+	GLuint MCommandBuffer;
+
+	ScatterStats MStats;
+};
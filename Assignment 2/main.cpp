@@ -1,13 +1,25 @@
+#include "Benchmark.h"
 #include "Camera.h"
+#include "CameraReplay.h"
+#include "GeometryArena.h"
+#include "GLStateCache.h"
+#include "GpuProfiler.h"
 #include "LightManager.h"
 #include "InputManager.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "ResidencyManager.h"
 #include "Scene.h"
+#include "SceneDescription.h"
+#include "ShaderCache.h"
 #include <glew.h>
 #include <glfw3.h>
 #include <iostream>
 #include <glm.hpp>
 #include <gtc/matrix_transform.hpp>
+#include <cstdlib>
 #include <memory>
+#include <string>
 
 
 // Settings
@@ -40,7 +52,46 @@ void checkGlError(const std::string& Location)
     }
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // Headless benchmarks: "Assignment 2.exe" --bench <name> [--json <results.json>]
+    if (argc >= 2 && std::string(argv[1]) == "--bench") {
+        const bool Json = argc >= 5 && std::string(argv[3]) == "--json";
+        return runBenchmark(argc >= 3 ? argv[2] : "", Json ? argv[4] : "");
+    }
+
+    // Scene compiler: "Assignment 2.exe" --compile-scene <text.scene> <binary.bin>
+    if (argc >= 2 && std::string(argv[1]) == "--compile-scene") {
+        if (argc < 4) {
+            std::cerr << "Usage: --compile-scene <text.scene> <binary.bin>" << '\n';
+            return 1;
+        }
+        return SceneDescription::compile(argv[2], argv[3]) ? 0 : 1;
+    }
+
+    // Residency budget in megabytes: "Assignment 2.exe" --residency <gpuMB> <cpuMB>
+    for (int I = 1; I + 2 < argc; I++) {
+        if (std::string(argv[I]) == "--residency") {
+            ResidencyBudget Budget;
+            Budget.GpuBytes = std::strtoull(argv[I + 1], nullptr, 10) << 20;
+            Budget.CpuBytes = std::strtoull(argv[I + 2], nullptr, 10) << 20;
+            ResidencyManager::getInstance().setBudget(Budget);
+        }
+    }
+
+    // Camera path benchmark: "Assignment 2.exe" --replay <path> [--offscreen]
+    bool Offscreen = false;
+    for (int I = 1; I < argc; I++) {
+        if (std::string(argv[I]) == "--offscreen") {
+            Offscreen = true;
+        }
+        else if (std::string(argv[I]) == "--replay" && I + 1 < argc) {
+            if (!CameraReplay::getInstance().startPlayback(argv[++I])) {
+                return 1;
+            }
+        }
+    }
+    const bool Replaying = CameraReplay::getInstance().isPlaying();
+
     // Initialize and configure GLFW
     if (!glfwInit()) {
         std::cerr << "Failed to initialize GLFW" << '\n';
@@ -52,8 +103,13 @@ int main() {
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_SAMPLES, 4); // Enable MSAA
 
+    // An offscreen run renders into a hidden window's framebuffer, so nothing needs a display
+    if (Offscreen) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    }
+
     // Create window and OpenGL context
-    GLFWwindow* Window = glfwCreateWindow(ScrWidth, ScrHeight, "OpenGL More Framebuffers and Shaders", nullptr, nullptr);
+    GLFWwindow* Window = glfwCreateWindow(ScrWidth, ScrHeight, WindowTitle, nullptr, nullptr);
     if (!Window) {
         std::cerr << "Failed to create GLFW window" << '\n';
         glfwTerminate();
@@ -61,6 +117,11 @@ int main() {
     }
     glfwMakeContextCurrent(Window);
 
+    // Replays measure unthrottled frame times
+    if (Replaying) {
+        glfwSwapInterval(0);
+    }
+
     // Initialize raw mouse motion
     GInputManager.enableRawMouseMotion(Window);
 
@@ -93,13 +154,19 @@ int main() {
     glFrontFace(GL_CCW);
     glEnable(GL_MULTISAMPLE);
 
+    // Workers for asset loading and other parallel work; this thread keeps the GL context
+    PROFILE_THREAD("Main");
+    JobSystem::getInstance().initialize();
+    std::cout << "Job system: " << JobSystem::getInstance().getWorkerCount() << " workers" << std::endl;
+
     // Initialize the first scene
     std::cout << "Initializing scene..." << std::endl;
-    Scene::switchScene(SceneType::SCENE_1, currentScene, activeScene, GCamera, GLightManager);
+    const SceneType FirstScene = Replaying ? static_cast<SceneType>(CameraReplay::getInstance().getScene() - 1) : SceneType::SCENE_1;
+    Scene::switchScene(FirstScene, currentScene, activeScene, GCamera, GLightManager);
 
     // Check if the scene loaded successfully
     if (!currentScene) {
-        std::cerr << "Failed to load Scene 1" << std::endl;
+        std::cerr << "Failed to load the first scene" << std::endl;
         return -1;
     }
 
@@ -109,21 +176,64 @@ int main() {
         DeltaTime = CurrentFrame - LastFrame;
         LastFrame = CurrentFrame;
 
-        GInputManager.processInput(Window, DeltaTime);
+        if (Replaying) {
+            // The path drives the camera and the clock; only Escape is read
+            DeltaTime = CameraReplay::getInstance().beginFrame(GCamera);
+            if (glfwGetKey(Window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
+                glfwSetWindowShouldClose(Window, true);
+            }
+        }
+        else {
+            GInputManager.processInput(Window, DeltaTime);
+            CameraReplay::getInstance().recordFrame(GCamera, CurrentFrame);
+        }
+
+        // GL work queued by jobs since the last frame
+        {
+            PROFILE_ZONE("JobSystem::runMainThreadJobs");
+            JobSystem::getInstance().runMainThreadJobs();
+        }
 
         // Update and render the current scene
         currentScene->update(DeltaTime);
-        currentScene->render();
-
-        glfwSwapBuffers(Window);
+        {
+            PROFILE_GPU_FRAME();
+            GLStateCache::getInstance().beginFrame();
+            currentScene->render();
+            GLStateCache::getInstance().endFrame();
+        }
+        Scene::showGpuOverlay();
+        if (Replaying) {
+            CameraReplay::getInstance().endFrame();
+        }
+
+        {
+            PROFILE_ZONE("glfwSwapBuffers");
+            glfwSwapBuffers(Window);
+        }
         glfwPollEvents();
+        PROFILE_FRAME();
+
+        if (CameraReplay::getInstance().isFinished()) {
+            glfwSetWindowShouldClose(Window, true);
+        }
     }
 
     // Cleanup
     if (currentScene) {
         currentScene->cleanup();
+        currentScene.reset();
     }
 
+    JobSystem::getInstance().shutdown();
+    ResidencyManager::getInstance().printStats("shutdown");
+    ResidencyManager::getInstance().shutdown();
+    GpuProfiler::getInstance().shutdown();
+    ShaderCache::getInstance().printStats();
+    ShaderCache::getInstance().shutdown();
+    GeometryArena::getInstance().printStats("shutdown");
+    GeometryArena::getInstance().shutdown();
+
     glfwTerminate();
     return 0;
 }
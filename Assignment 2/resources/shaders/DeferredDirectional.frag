@@ -0,0 +1,99 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : DeferredDirectional.frag
+Description : Fragment shader applying directional and spot light to the G-buffer
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#version 460 core
+
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+struct DirectionalLight
+{
+    vec3 direction;
+    vec3 color;
+    float ambientStrength;
+};
+
+struct SpotLight
+{
+    vec3 position;
+    vec3 direction;
+    vec3 color;
+    float cutOff;
+    float outerCutOff;
+    float constant;
+    float linear;
+    float quadratic;
+};
+
+uniform sampler2D gAlbedoSpecular;
+uniform sampler2D gNormalShininess;
+uniform sampler2D gDepth;
+uniform mat4 inverseViewProjection;
+uniform DirectionalLight directionalLight;
+uniform SpotLight spotLight;
+uniform vec3 viewPos;
+
+vec3 ReconstructPosition(vec2 uv, float depth)
+{
+    vec4 world = inverseViewProjection * vec4(vec3(uv, depth) * 2.0 - 1.0, 1.0);
+    return world.xyz / world.w;
+}
+
+void main()
+{
+    float depth = texture(gDepth, TexCoords).r;
+    if (depth >= 1.0)
+        discard; // Sky, filled in by the skybox afterwards
+
+    vec4 albedoSpecular = texture(gAlbedoSpecular, TexCoords);
+    vec4 normalShininess = texture(gNormalShininess, TexCoords);
+    vec3 color = albedoSpecular.rgb;
+    vec3 specularColor = vec3(albedoSpecular.a);
+    vec3 normal = normalize(normalShininess.xyz);
+    float shininess = normalShininess.w;
+
+    vec3 fragPos = ReconstructPosition(TexCoords, depth);
+    vec3 viewDir = normalize(viewPos - fragPos);
+    vec3 result = vec3(0.0);
+
+#ifdef HAS_DIR
+    {
+        vec3 lightDir = normalize(-directionalLight.direction);
+        float diff = max(dot(normal, lightDir), 0.0);
+        float spec = pow(max(dot(viewDir, reflect(-lightDir, normal)), 0.0), shininess);
+        result += directionalLight.ambientStrength * directionalLight.color * color;
+        result += directionalLight.color * diff * color;
+        result += directionalLight.color * spec * specularColor;
+    }
+#endif
+
+#ifdef HAS_SPOT
+    {
+        vec3 lightDir = normalize(spotLight.position - fragPos);
+        float theta = dot(lightDir, normalize(-spotLight.direction));
+        float intensity = clamp((theta - spotLight.outerCutOff) / (spotLight.cutOff - spotLight.outerCutOff), 0.0, 1.0);
+
+        float diff = max(dot(normal, lightDir), 0.0);
+        float spec = pow(max(dot(viewDir, reflect(-lightDir, normal)), 0.0), shininess);
+
+        float distance = length(spotLight.position - fragPos);
+        float attenuation = 1.0 / (spotLight.constant + spotLight.linear * distance + spotLight.quadratic * (distance * distance));
+
+        result += (spotLight.color * color + spotLight.color * diff * color + spotLight.color * spec * specularColor) * attenuation * intensity;
+    }
+#endif
+
+    FragColor = vec4(result, 1.0);
+}
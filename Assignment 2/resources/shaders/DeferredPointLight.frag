@@ -0,0 +1,66 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : DeferredPointLight.frag
+Description : Fragment shader accumulating one point light over the G-buffer pixels it covers
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#version 460 core
+
+out vec4 FragColor;
+
+flat in uint LightIndex;
+
+struct GpuPointLight
+{
+    vec4 positionRadius;
+    vec4 color;
+    vec4 attenuation;
+};
+
+layout(std430, binding = 0) readonly buffer PointLightBuffer
+{
+    GpuPointLight lights[];
+};
+
+uniform sampler2D gAlbedoSpecular;
+uniform sampler2D gNormalShininess;
+uniform sampler2D gDepth;
+uniform mat4 inverseViewProjection;
+uniform vec2 screenSize;
+uniform vec3 viewPos;
+
+void main()
+{
+    vec2 uv = gl_FragCoord.xy / screenSize;
+    float depth = texture(gDepth, uv).r;
+
+    vec4 world = inverseViewProjection * vec4(vec3(uv, depth) * 2.0 - 1.0, 1.0);
+    vec3 fragPos = world.xyz / world.w;
+
+    GpuPointLight light = lights[LightIndex];
+    float distance = length(light.positionRadius.xyz - fragPos);
+    if (distance >= light.positionRadius.w)
+        discard; // Behind the volume's back faces but outside the light's range
+
+    vec4 albedoSpecular = texture(gAlbedoSpecular, uv);
+    vec4 normalShininess = texture(gNormalShininess, uv);
+    vec3 color = albedoSpecular.rgb;
+    vec3 normal = normalize(normalShininess.xyz);
+
+    vec3 lightDir = normalize(light.positionRadius.xyz - fragPos);
+    vec3 viewDir = normalize(viewPos - fragPos);
+    float diff = max(dot(normal, lightDir), 0.0);
+    float spec = pow(max(dot(viewDir, reflect(-lightDir, normal)), 0.0), normalShininess.w);
+    float attenuation = 1.0 / (light.attenuation.x + light.attenuation.y * distance + light.attenuation.z * (distance * distance));
+
+    vec3 result = light.color.rgb * color + light.color.rgb * diff * color + light.color.rgb * spec * vec3(albedoSpecular.a);
+    FragColor = vec4(result * attenuation, 1.0);
+}
@@ -0,0 +1,44 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : DeferredPointLight.vert
+Description : Vertex shader placing an instanced light volume around each point light
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#version 460 core
+
+layout(location = 0) in vec3 aPos;
+
+// Point lights uploaded by ClusteredLighting (radius in positionRadius.w)
+struct GpuPointLight
+{
+    vec4 positionRadius;
+    vec4 color;
+    vec4 attenuation;
+};
+
+layout(std430, binding = 0) readonly buffer PointLightBuffer
+{
+    GpuPointLight lights[];
+};
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform float volumeScale;
+
+flat out uint LightIndex;
+
+void main()
+{
+    GpuPointLight light = lights[gl_InstanceID];
+    vec3 worldPos = light.positionRadius.xyz + aPos * light.positionRadius.w * volumeScale;
+    LightIndex = uint(gl_InstanceID);
+    gl_Position = projection * view * vec4(worldPos, 1.0);
+}
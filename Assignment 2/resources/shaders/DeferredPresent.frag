@@ -0,0 +1,26 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : DeferredPresent.frag
+Description : Fragment shader copying the lit deferred image to the window
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#version 460 core
+
+out vec4 FragColor;
+
+in vec2 TexCoords;
+
+uniform sampler2D litImage;
+
+void main()
+{
+    FragColor = vec4(texture(litImage, TexCoords).rgb, 1.0);
+}
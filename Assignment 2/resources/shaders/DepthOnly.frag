@@ -0,0 +1,20 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : DepthOnly.frag
+Description : Fragment shader for the depth-only occluder pass
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#version 460 core
+
+void main()
+{
+    // Depth is written by the fixed-function pipeline
+}
@@ -14,12 +14,58 @@ Mail : ayoub.ahmad@mds.ac.nz
 
 #version 460 core
 
+// Shader::selectVariant injects the feature defines above this line. Without them every
+// feature is compiled in and the texture is chosen at runtime, as before.
+#ifndef SHADER_VARIANT
+#define HAS_DIR
+#define HAS_SPOT
+#define NUM_POINT_LIGHTS 2
+#define RUNTIME_TEXTURE
+#endif
+
 out vec4 FragColor;
 
 in vec2 TexCoords;
 in vec3 FragPos;
 in vec3 Normal;
 
+#ifdef DITHER_FADE
+// Cross-fade between an instance's geometry and its impostor: 0 is all geometry, 1 all impostor.
+// Both sides use the same per-pixel threshold, so together they cover every pixel exactly once.
+flat in float Fade;
+
+float DitherThreshold()
+{
+    // Interleaved gradient noise
+    return fract(52.9829189 * fract(dot(gl_FragCoord.xy, vec2(0.06711056, 0.00583715))));
+}
+#endif
+
+#ifdef IMPOSTOR
+// Set by Impostor.vert: the first of the four baked views around the view direction, the bilinear
+// weights between them, the atlas layer of the model and its model-to-world normal matrix
+flat in vec2 ImpostorCell;
+flat in vec2 ImpostorBlend;
+flat in float ImpostorLayer;
+flat in mat3 ImpostorNormalMatrix;
+
+uniform sampler2DArray impostorAlbedo;
+uniform sampler2DArray impostorNormals;
+uniform float impostorFrames;
+
+vec4 SampleImpostorView(sampler2DArray atlas, vec2 cell)
+{
+    return texture(atlas, vec3((cell + TexCoords) / impostorFrames, ImpostorLayer));
+}
+
+vec4 SampleImpostor(sampler2DArray atlas)
+{
+    vec4 bottom = mix(SampleImpostorView(atlas, ImpostorCell), SampleImpostorView(atlas, ImpostorCell + vec2(1.0, 0.0)), ImpostorBlend.x);
+    vec4 top = mix(SampleImpostorView(atlas, ImpostorCell + vec2(0.0, 1.0)), SampleImpostorView(atlas, ImpostorCell + vec2(1.0, 1.0)), ImpostorBlend.x);
+    return mix(bottom, top, ImpostorBlend.y);
+}
+#endif
+
 struct Material 
 {
     vec3 specular;
@@ -55,7 +101,9 @@ struct SpotLight
 };
 
 uniform Material material;
-uniform PointLight pointLights[2];
+#if NUM_POINT_LIGHTS > 0
+uniform PointLight pointLights[NUM_POINT_LIGHTS];
+#endif
 uniform DirectionalLight directionalLight;
 uniform SpotLight spotLight;
 uniform vec3 viewPos;
@@ -63,6 +111,55 @@ uniform sampler2D texture_diffuse1;
 uniform bool useTexture; 
 uniform vec3 solidColor; 
 
+#if defined(CLUSTERED_LIGHTS) || defined(UNCULLED_LIGHTS)
+// Point lights uploaded by ClusteredLighting (radius in positionRadius.w)
+struct GpuPointLight
+{
+    vec4 positionRadius;
+    vec4 color;
+    vec4 attenuation;
+};
+
+layout(std430, binding = 0) readonly buffer PointLightBuffer
+{
+    GpuPointLight lights[];
+};
+
+uniform uint pointLightCount;
+
+PointLight UnpackPointLight(GpuPointLight light)
+{
+    return PointLight(light.positionRadius.xyz, light.color.rgb, light.attenuation.x, light.attenuation.y, light.attenuation.z);
+}
+#endif
+
+#ifdef CLUSTERED_LIGHTS
+layout(std430, binding = 2) readonly buffer ClusterLightCounts
+{
+    uint lightCounts[];
+};
+
+layout(std430, binding = 3) readonly buffer ClusterLightIndices
+{
+    uint lightIndices[];
+};
+
+uniform mat4 view;
+uniform uvec3 clusterGridSize;
+uniform vec2 clusterScreenSize;
+uniform float clusterScale;
+uniform float clusterBias;
+uniform uint maxLightsPerCluster;
+
+uint GetClusterIndex()
+{
+    float viewZ = (view * vec4(FragPos, 1.0)).z;
+    uint slice = min(uint(max(log(-viewZ) * clusterScale + clusterBias, 0.0)), clusterGridSize.z - 1u);
+    uvec2 tile = min(uvec2(gl_FragCoord.xy / (clusterScreenSize / vec2(clusterGridSize.xy))), clusterGridSize.xy - 1u);
+    return tile.x + tile.y * clusterGridSize.x + slice * clusterGridSize.x * clusterGridSize.y;
+}
+#endif
+
 vec3 CalculateDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir, vec3 color)
 {
     vec3 lightDir = normalize(-light.direction);
@@ -126,17 +223,63 @@ vec3 CalculateSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir
 
 void main()
 {
-    vec3 norm = normalize(Normal);
+#if defined(DITHER_FADE) && defined(IMPOSTOR)
+    if (DitherThreshold() >= Fade)
+        discard;
+#elif defined(DITHER_FADE)
+    if (DitherThreshold() < Fade)
+        discard;
+#endif
+
     vec3 viewDir = normalize(viewPos - FragPos);
+#if defined(IMPOSTOR)
+    // The atlas is cleared to zero, so dividing by the coverage undoes the blend with empty texels
+    vec4 albedo = SampleImpostor(impostorAlbedo);
+    if (albedo.a < 0.5)
+        discard;
+    vec3 color = albedo.rgb / albedo.a;
+    vec4 packedNormal = SampleImpostor(impostorNormals);
+    vec3 norm = normalize(ImpostorNormalMatrix * (packedNormal.xyz / max(packedNormal.a, 0.001) * 2.0 - 1.0));
+#else
+    vec3 norm = normalize(Normal);
+#if defined(RUNTIME_TEXTURE)
     vec3 color = useTexture ? vec3(texture(texture_diffuse1, TexCoords)) : solidColor;
+#elif defined(HAS_TEXTURE)
+    vec3 color = vec3(texture(texture_diffuse1, TexCoords));
+#else
+    vec3 color = solidColor;
+#endif
+#endif
+
+    vec3 result = vec3(0.0);
 
-    vec3 result = CalculateDirectionalLight(directionalLight, norm, viewDir, color);
+#ifdef HAS_DIR
+    result += CalculateDirectionalLight(directionalLight, norm, viewDir, color);
+#endif
 
-    for (int i = 0; i < 2; i++) {
+#if defined(CLUSTERED_LIGHTS)
+    // Only the lights binned into this fragment's cluster
+    uint cluster = GetClusterIndex();
+    uint clusterLights = lightCounts[cluster];
+    for (uint i = 0u; i < clusterLights; i++) {
+        GpuPointLight light = lights[lightIndices[cluster * maxLightsPerCluster + i]];
+        if (distance(light.positionRadius.xyz, FragPos) < light.positionRadius.w)
+            result += CalculatePointLight(UnpackPointLight(light), norm, FragPos, viewDir, color);
+    }
+#elif defined(UNCULLED_LIGHTS)
+    for (uint i = 0u; i < pointLightCount; i++) {
+        if (distance(lights[i].positionRadius.xyz, FragPos) < lights[i].positionRadius.w)
+            result += CalculatePointLight(UnpackPointLight(lights[i]), norm, FragPos, viewDir, color);
+    }
+#elif NUM_POINT_LIGHTS > 0
+    for (int i = 0; i < NUM_POINT_LIGHTS; i++) {
         result += CalculatePointLight(pointLights[i], norm, FragPos, viewDir, color);
     }
+#endif
 
+#ifdef HAS_SPOT
     result += CalculateSpotLight(spotLight, norm, FragPos, viewDir, color);
+#endif
 
     FragColor = vec4(result, 1.0);
 }
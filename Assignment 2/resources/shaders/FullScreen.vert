@@ -0,0 +1,25 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : FullScreen.vert
+Description : Vertex shader for a full-screen triangle generated from gl_VertexID
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#version 460 core
+
+out vec2 TexCoords;
+
+void main()
+{
+    // Vertices (0,0), (2,0), (0,2) in UV space cover the whole screen with one triangle
+    vec2 uv = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    TexCoords = uv;
+    gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,45 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : GBuffer.frag
+Description : Fragment shader writing surface attributes into the deferred G-buffer
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#version 460 core
+
+// Albedo + specular strength, normal + shininess. Position is reconstructed from depth.
+layout(location = 0) out vec4 gAlbedoSpecular;
+layout(location = 1) out vec4 gNormalShininess;
+
+in vec2 TexCoords;
+in vec3 FragPos;
+in vec3 Normal;
+
+struct Material
+{
+    vec3 specular;
+    float shininess;
+};
+
+uniform Material material;
+uniform sampler2D texture_diffuse1;
+uniform vec3 solidColor;
+
+void main()
+{
+#ifdef HAS_TEXTURE
+    vec3 color = vec3(texture(texture_diffuse1, TexCoords));
+#else
+    vec3 color = solidColor;
+#endif
+
+    gAlbedoSpecular = vec4(color, material.specular.r);
+    gNormalShininess = vec4(normalize(Normal), material.shininess);
+}
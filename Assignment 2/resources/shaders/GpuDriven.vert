@@ -0,0 +1,60 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : GpuDriven.vert
+Description : Vertex shader for instances drawn through multi-draw-indirect
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#version 460 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aNormal;
+layout(location = 2) in vec2 aTexCoords;
+
+struct Instance
+{
+    mat4 transform;
+    uint modelId;
+    uint padding0;
+    uint padding1;
+    uint padding2;
+};
+
+layout(std430, binding = 4) readonly buffer InstanceBuffer
+{
+    Instance instances[];
+};
+
+layout(std430, binding = 7) readonly buffer VisibleInstanceBuffer
+{
+    uint visibleInstances[];
+};
+
+out vec2 TexCoords;
+out vec3 FragPos;
+out vec3 Normal;
+flat out float Fade;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    // baseInstance points at this mesh's slice of the compacted visible list; the cull packs
+    // the cross-fade towards the instance's impostor into the top 8 bits of each entry
+    uint entry = visibleInstances[gl_BaseInstance + gl_InstanceID];
+    mat4 model = instances[entry & 0xFFFFFFu].transform;
+    Fade = float(entry >> 24u) / 255.0;
+
+    TexCoords = aTexCoords;
+    FragPos = vec3(model * vec4(aPos, 1.0));
+    Normal = mat3(transpose(inverse(model))) * aNormal;
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
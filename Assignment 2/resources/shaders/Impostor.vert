@@ -0,0 +1,117 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : Impostor.vert
+Description : Vertex shader for camera-facing impostor quads drawn through multi-draw-indirect
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#version 460 core
+
+// The impostor quad: corners in [-1, 1] and their texture coordinates
+layout(location = 0) in vec3 aPos;
+layout(location = 2) in vec2 aTexCoords;
+
+struct Instance
+{
+    mat4 transform;
+    uint modelId;
+    uint padding0;
+    uint padding1;
+    uint padding2;
+};
+
+struct ModelBounds
+{
+    vec4 sphere;
+    uint firstCommand;
+    uint commandCount;
+    uint impostorCommand;
+    uint impostorLayer;
+};
+
+layout(std430, binding = 4) readonly buffer InstanceBuffer
+{
+    Instance instances[];
+};
+
+layout(std430, binding = 5) readonly buffer ModelBuffer
+{
+    ModelBounds models[];
+};
+
+layout(std430, binding = 7) readonly buffer VisibleInstanceBuffer
+{
+    uint visibleInstances[];
+};
+
+out vec2 TexCoords;
+out vec3 FragPos;
+out vec3 Normal;
+
+flat out float Fade;
+flat out vec2 ImpostorCell;
+flat out vec2 ImpostorBlend;
+flat out float ImpostorLayer;
+flat out mat3 ImpostorNormalMatrix;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform vec3 viewPos;
+uniform float impostorFrames;
+
+// Upper hemisphere onto [-1, 1]^2, the layout ImpostorAtlas bakes the views in
+vec2 EncodeHemiOctahedron(vec3 dir)
+{
+    vec2 p = dir.xz / (abs(dir.x) + abs(dir.y) + abs(dir.z));
+    return vec2(p.x + p.y, p.x - p.y);
+}
+
+// Must match impostorBasis() in ImpostorAtlas.cpp
+void ImpostorBasis(vec3 dir, out vec3 right, out vec3 up)
+{
+    vec3 worldUp = abs(dir.y) > 0.999 ? vec3(0.0, 0.0, -1.0) : vec3(0.0, 1.0, 0.0);
+    right = normalize(cross(worldUp, dir));
+    up = cross(dir, right);
+}
+
+void main()
+{
+    // The cull packs the cross-fade into the top 8 bits of the instance index
+    uint entry = visibleInstances[gl_BaseInstance + gl_InstanceID];
+    Instance instance = instances[entry & 0xFFFFFFu];
+    ModelBounds bounds = models[instance.modelId];
+    Fade = float(entry >> 24u) / 255.0;
+
+    mat3 linear = mat3(instance.transform);
+    vec3 centre = vec3(instance.transform * vec4(bounds.sphere.xyz, 1.0));
+
+    // Direction to the camera in model space, held at the horizon when the camera is below the model
+    vec3 dir = inverse(linear) * (viewPos - centre);
+    dir.y = max(dir.y, 0.0);
+    dir = dot(dir, dir) > 0.0 ? normalize(dir) : vec3(0.0, 1.0, 0.0);
+
+    // The four baked views around it, blended bilinearly in the fragment shader
+    vec2 grid = (EncodeHemiOctahedron(dir) * 0.5 + 0.5) * (impostorFrames - 1.0);
+    ImpostorCell = min(floor(grid), vec2(impostorFrames - 2.0));
+    ImpostorBlend = grid - ImpostorCell;
+    ImpostorLayer = float(bounds.impostorLayer);
+    ImpostorNormalMatrix = transpose(inverse(linear));
+
+    // A quad covering the bounding sphere, facing the camera
+    vec3 right;
+    vec3 up;
+    ImpostorBasis(dir, right, up);
+    vec3 offset = (right * aPos.x + up * aPos.y) * bounds.sphere.w;
+
+    TexCoords = aTexCoords;
+    FragPos = centre + linear * offset;
+    Normal = linear * dir;
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
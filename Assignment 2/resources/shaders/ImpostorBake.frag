@@ -0,0 +1,33 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : ImpostorBake.frag
+Description : Fragment shader writing albedo and model-space normals into the impostor atlas
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#version 460 core
+
+layout(location = 0) out vec4 Albedo;
+layout(location = 1) out vec4 NormalOut;
+
+in vec2 TexCoords;
+in vec3 Normal;
+
+uniform sampler2D texture_diffuse1;
+
+void main()
+{
+    // Both sides of a leaf are baked, so a back face takes the flipped normal
+    vec3 normal = normalize(gl_FrontFacing ? Normal : -Normal);
+
+    // The atlas is cleared to zero alpha; covered texels have alpha 1
+    Albedo = vec4(texture(texture_diffuse1, TexCoords).rgb, 1.0);
+    NormalOut = vec4(normal * 0.5 + 0.5, 1.0);
+}
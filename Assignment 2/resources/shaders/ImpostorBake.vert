@@ -0,0 +1,33 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : ImpostorBake.vert
+Description : Vertex shader rendering a model into one view of its impostor atlas
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#version 460 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aNormal;
+layout(location = 2) in vec2 aTexCoords;
+
+out vec2 TexCoords;
+out vec3 Normal;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    // The model is baked in its own space; the normals stay in model space too
+    TexCoords = aTexCoords;
+    Normal = aNormal;
+    gl_Position = projection * view * vec4(aPos, 1.0);
+}
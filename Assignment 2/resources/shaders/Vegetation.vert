@@ -0,0 +1,56 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : Vegetation.vert
+Description : Vertex shader for vegetation scattered over a terrain on the GPU
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#version 460 core
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aNormal;
+layout(location = 2) in vec2 aTexCoords;
+
+// World position, with yaw and scale packed as two halves in w (VegetationScatter.comp)
+layout(std430, binding = 9) readonly buffer VegetationInstanceBuffer
+{
+    vec4 vegetationInstances[];
+};
+
+out vec2 TexCoords;
+out vec3 FragPos;
+out vec3 Normal;
+flat out float Fade;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform vec3 viewPos;
+
+// Instances dither out between these distances from the camera
+uniform float fadeStart;
+uniform float fadeEnd;
+
+void main()
+{
+    // baseInstance points at the slot of this instance's terrain region
+    vec4 instance = vegetationInstances[gl_BaseInstance + gl_InstanceID];
+    vec2 yawScale = unpackHalf2x16(floatBitsToUint(instance.w));
+
+    // Rotation about +Y; the scale is uniform, so normals only need the rotation
+    float c = cos(yawScale.x);
+    float s = sin(yawScale.x);
+    mat3 rotation = mat3(c, 0.0, -s, 0.0, 1.0, 0.0, s, 0.0, c);
+
+    TexCoords = aTexCoords;
+    FragPos = instance.xyz + rotation * (aPos * yawScale.y);
+    Normal = rotation * aNormal;
+    Fade = clamp((distance(instance.xyz, viewPos) - fadeStart) / (fadeEnd - fadeStart), 0.0, 1.0);
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
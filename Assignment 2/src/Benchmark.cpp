@@ -0,0 +1,1000 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : Benchmark.cpp
+Description : Implementations for the headless benchmarks run with --bench
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "Benchmark.h"
+
+#include "Camera.h"
+#include "EntityWorld.h"
+#include "FrustumCulling.h"
+#include "JobSystem.h"
+#include "Model.h"
+#include "ObjParser.h"
+#include "Profiler.h"
+#include "RenderQueue.h"
+#include "SceneDescription.h"
+#include "SceneGraph.h"
+#include "Skybox.h"
+#include "StaticBatch.h"
+#include "Terrain.h"
+
+#include <gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+	const BenchmarkEntry Benchmarks[] = {
+		{"culling", "Frustum culling of 100k bounding spheres, scalar vs SIMD", benchmarkFrustumCulling},
+		{"scenegraph", "Transform hierarchy updates for 100k nodes: static, one subtree, everything", benchmarkSceneGraph},
+		{"ecs", "Entity iteration, transform and culling systems at 10k, 100k and 1M entities", benchmarkEntities},
+		{"sceneload", "Loading a 100k-entity scene description, text vs compiled binary", benchmarkSceneLoad},
+		{"jobs", "Job system scaling from 1 to N cores: terrain smoothing, model loading, job overhead", benchmarkJobs},
+		{"recording", "Parallel draw recording into command buffers for 10k and 100k entities, 1 to N cores", benchmarkRecording},
+		{"profiler", "Cost of a profiler zone on one and on every core, and of draining the rings", benchmarkProfiler},
+		{"assets", "OBJ parsing and vertex dedup per model, texture and cubemap decoding", benchmarkAssets},
+		{"terrain", "Terrain heightmap load, smoothing, normals and indices from 256 to 4096 squared", benchmarkTerrain},
+		{"objparse", "Chunked parallel OBJ parsing against tinyobj::LoadObj, 1 to N cores", benchmarkObjParse},
+		{"staticbatch", "Static batch builds of the Scene1 garden from 121 to 1681 plants: draws vs memory", benchmarkStaticBatch},
+	};
+
+	struct BenchmarkResult
+	{
+		std::string Name;
+		double MeanMs;
+		double MinMs;
+		int Iterations;
+	};
+
+	// Filled by measure() and written out by runBenchmark when --json is given
+	std::vector<BenchmarkResult> Results;
+
+	using CullFunction = size_t (*)(const Frustum&, const float*, const float*, const float*, const float*, size_t, uint32_t*);
+
+	template <typename Function>
+	double averageMs(const int Runs, Function&& Run)
+	{
+		const auto Start = std::chrono::steady_clock::now();
+		for (int I = 0; I < Runs; I++)
+			Run(I);
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count() / Runs;
+	}
+
+	void printResult(const BenchmarkResult& Result)
+	{
+		std::cout << "  " << std::left << std::setw(56) << Result.Name << std::right << std::fixed << std::setprecision(3)
+			<< std::setw(10) << Result.MeanMs << " ms mean " << std::setw(10) << Result.MinMs << " ms min ("
+			<< Result.Iterations << " runs)" << std::defaultfloat << '\n';
+	}
+
+	// One warmup call, then timed calls until MinTotalMs has passed (and at least MinIterations)
+	template <typename Function>
+	BenchmarkResult timeCalls(const std::string& Name, Function&& Run, const double MinTotalMs = 250.0, const int MinIterations = 3)
+	{
+		Run();
+
+		BenchmarkResult Result{Name, 0.0, 0.0, 0};
+		double TotalMs = 0.0;
+		while (TotalMs < MinTotalMs || Result.Iterations < MinIterations)
+		{
+			const auto Start = std::chrono::steady_clock::now();
+			Run();
+			const double Ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+			Result.MinMs = Result.Iterations == 0 ? Ms : std::min(Result.MinMs, Ms);
+			TotalMs += Ms;
+			Result.Iterations++;
+		}
+		Result.MeanMs = TotalMs / Result.Iterations;
+		return Result;
+	}
+
+	void recordResult(const BenchmarkResult& Result)
+	{
+		printResult(Result);
+		Results.push_back(Result);
+	}
+
+	// Times Run, prints the mean and the fastest call and keeps them for the JSON results
+	template <typename Function>
+	void measure(const std::string& Name, Function&& Run)
+	{
+		recordResult(timeCalls(Name, Run));
+	}
+
+	// measure() with the console muted, for loaders that log every file they open
+	template <typename Function>
+	void measureQuiet(const std::string& Name, Function&& Run)
+	{
+		std::streambuf* Console = std::cout.rdbuf(nullptr);
+		const BenchmarkResult Result = timeCalls(Name, Run);
+		std::cout.rdbuf(Console);
+		std::cout.clear();
+		recordResult(Result);
+	}
+
+	std::string escapeJson(const std::string& Text)
+	{
+		std::string Escaped;
+		for (const char Character : Text)
+		{
+			if (Character == '"' || Character == '\\')
+				Escaped += '\\';
+			Escaped += Character;
+		}
+		return Escaped;
+	}
+
+	bool writeResults(const std::string& Benchmark, const std::string& Path)
+	{
+		std::ofstream File(Path, std::ios::trunc);
+		if (!File.is_open())
+		{
+			std::cerr << "Failed to write benchmark results: " << Path << '\n';
+			return false;
+		}
+
+		File << std::setprecision(9) << "{\n  \"benchmark\": \"" << escapeJson(Benchmark) << "\",\n  \"results\": [";
+		for (size_t I = 0; I < Results.size(); I++)
+		{
+			const BenchmarkResult& Result = Results[I];
+			File << (I == 0 ? "\n" : ",\n") << "    {\"name\": \"" << escapeJson(Result.Name) << "\", \"mean_ms\": " << Result.MeanMs
+				<< ", \"min_ms\": " << Result.MinMs << ", \"iterations\": " << Result.Iterations << "}";
+		}
+		File << "\n  ]\n}\n";
+		std::cout << "[Benchmark] " << Results.size() << " results written to " << Path << '\n';
+		return static_cast<bool>(File);
+	}
+
+	std::vector<std::string> findFiles(const std::string& Directory, const std::string& Extension)
+	{
+		std::vector<std::string> Files;
+		std::error_code Error;
+		for (const auto& Entry : std::filesystem::recursive_directory_iterator(Directory, Error))
+		{
+			if (Entry.is_regular_file() && Entry.path().extension() == Extension)
+				Files.push_back(Entry.path().generic_string());
+		}
+		std::sort(Files.begin(), Files.end());
+		return Files;
+	}
+}
+
+int runBenchmark(const std::string& Name, const std::string& JsonPath)
+{
+	for (const BenchmarkEntry& Entry : Benchmarks)
+	{
+		if (Name == Entry.Name)
+		{
+			std::cout << "[Benchmark] " << Entry.Name << ": " << Entry.Description << '\n';
+			Results.clear();
+			const int ExitCode = Entry.Run();
+			if (!JsonPath.empty() && !writeResults(Entry.Name, JsonPath))
+				return 1;
+			return ExitCode;
+		}
+	}
+
+	if (!Name.empty())
+		std::cerr << "Unknown benchmark: " << Name << '\n';
+	listBenchmarks();
+	return Name.empty() ? 0 : 1;
+}
+
+void listBenchmarks()
+{
+	std::cout << "Usage: --bench <name> [--json <results.json>]" << '\n';
+	for (const BenchmarkEntry& Entry : Benchmarks)
+	{
+		std::cout << "  " << Entry.Name << " - " << Entry.Description << '\n';
+	}
+}
+
+int benchmarkFrustumCulling()
+{
+	constexpr size_t InstanceCount = 100000;
+	constexpr int Frames = 200;
+
+	// Instances scattered over a 400x400 field around the camera, like a very large plant grid
+	std::mt19937 Random(1234);
+	std::uniform_real_distribution<float> Horizontal(-200.0f, 200.0f);
+	std::uniform_real_distribution<float> Vertical(-1.0f, 10.0f);
+	std::uniform_real_distribution<float> Size(0.25f, 3.0f);
+
+	std::vector<float> X(InstanceCount), Y(InstanceCount), Z(InstanceCount), Radius(InstanceCount);
+	for (size_t I = 0; I < InstanceCount; I++)
+	{
+		X[I] = Horizontal(Random);
+		Y[I] = Vertical(Random);
+		Z[I] = Horizontal(Random);
+		Radius[I] = Size(Random);
+	}
+
+	// One frustum per frame as the camera turns a full circle
+	Camera BenchCamera(glm::vec3(0.0f, 2.0f, 0.0f));
+	std::vector<Frustum> Frustums;
+	for (int Frame = 0; Frame < Frames; Frame++)
+	{
+		BenchCamera.processMouseMovement(360.0f / Frames / BenchCamera.FMouseSensitivity, 0.0f);
+		Frustums.push_back(BenchCamera.getFrustum(800, 600));
+	}
+
+	struct Variant
+	{
+		const char* Name;
+		CullFunction Cull;
+	};
+	const Variant Variants[] = {
+		{"scalar", cullSpheresScalar},
+		{"sse (4 wide)", cullSpheresSse},
+#ifdef __AVX__
+		{"avx (8 wide)", cullSpheresAvx},
+#endif
+	};
+
+	std::vector<uint32_t> Visible(InstanceCount);
+	std::vector<size_t> ReferenceCounts;
+	int Result = 0;
+
+	for (const Variant& Variant : Variants)
+	{
+		size_t TotalVisible = 0;
+		std::vector<size_t> Counts;
+		const auto Start = std::chrono::steady_clock::now();
+		for (const Frustum& Frustum : Frustums)
+		{
+			const size_t Count = Variant.Cull(Frustum, X.data(), Y.data(), Z.data(), Radius.data(), InstanceCount, Visible.data());
+			Counts.push_back(Count);
+			TotalVisible += Count;
+		}
+		const double Ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+
+		// Every implementation must agree with the scalar reference
+		if (ReferenceCounts.empty())
+			ReferenceCounts = Counts;
+		else if (Counts != ReferenceCounts)
+		{
+			std::cerr << "  " << Variant.Name << ": visible counts differ from scalar reference" << '\n';
+			Result = 1;
+		}
+
+		std::cout << "  " << Variant.Name << ": " << Ms / Frames << " ms/frame, "
+			<< Ms * 1.0e6 / (static_cast<double>(Frames) * InstanceCount) << " ns/instance, avg "
+			<< TotalVisible / Frames << " visible / " << InstanceCount - TotalVisible / Frames << " culled" << '\n';
+	}
+
+	return Result;
+}
+
+int benchmarkSceneGraph()
+{
+	constexpr int Groups = 100;
+	constexpr int LeavesPerGroup = 1000;
+	constexpr int Runs = 200;
+
+	// Root -> 100 groups -> 1000 leaves each, like a garden of plant clusters
+	SceneGraph Graph;
+	std::vector<NodeId> GroupNodes;
+	Graph.reserve(1 + Groups + static_cast<size_t>(Groups) * LeavesPerGroup);
+	const NodeId Root = Graph.createNode();
+	for (int Group = 0; Group < Groups; Group++)
+	{
+		const NodeId GroupNode = Graph.createNode(Root, glm::vec3(Group % 10 * 40.0f, 0.0f, Group / 10 * 40.0f));
+		GroupNodes.push_back(GroupNode);
+		for (int Leaf = 0; Leaf < LeavesPerGroup; Leaf++)
+		{
+			const glm::quat Rotation = glm::angleAxis(static_cast<float>(Leaf), glm::vec3(0.0f, 1.0f, 0.0f));
+			Graph.createNode(GroupNode, glm::vec3(Leaf % 32, 0.0f, Leaf / 32), Rotation, glm::vec3(0.005f));
+		}
+	}
+	Graph.update();
+	std::cout << "  " << Graph.getNodeCount() << " nodes" << '\n';
+
+	unsigned int Updated = 0;
+	const double StaticMs = averageMs(Runs, [&](int) { Updated = Graph.update(); });
+	std::cout << "  static frame     : " << StaticMs << " ms, " << Updated << " nodes updated" << '\n';
+
+	const double SubtreeMs = averageMs(Runs, [&](const int Run)
+	{
+		Graph.setPosition(GroupNodes[Run % Groups], glm::vec3(static_cast<float>(Run), 0.0f, 0.0f));
+		Updated = Graph.update();
+	});
+	std::cout << "  move one group   : " << SubtreeMs << " ms, " << Updated << " nodes updated" << '\n';
+
+	struct Variant
+	{
+		const char* Name;
+		TransformMultiply Multiply;
+	};
+	const Variant Variants[] = {
+		{"scalar", multiplyTransformsScalar},
+		{"sse", multiplyTransformsSse},
+	};
+
+	// Moving the root dirties every node; the two multiplies must produce the same matrices
+	std::vector<glm::mat4> Reference;
+	int Result = 0;
+	for (const Variant& Variant : Variants)
+	{
+		const double AllMs = averageMs(Runs, [&](const int Run)
+		{
+			Graph.setPosition(Root, glm::vec3(0.0f, static_cast<float>(Run % 2), 0.0f));
+			Updated = Graph.update(Variant.Multiply);
+		});
+		std::cout << "  move root (" << Variant.Name << ") : " << AllMs << " ms, " << Updated << " nodes updated" << '\n';
+
+		std::vector<glm::mat4> World(Graph.getNodeCount());
+		for (NodeId Node = 0; Node < Graph.getNodeCount(); Node++)
+			World[Node] = Graph.getWorld(Node);
+
+		if (Reference.empty())
+			Reference = World;
+		else
+		{
+			for (size_t Node = 0; Node < World.size(); Node++)
+			{
+				const glm::mat4 Difference = World[Node] - Reference[Node];
+				for (int Column = 0; Column < 4; Column++)
+				{
+					if (glm::any(glm::greaterThan(glm::abs(Difference[Column]), glm::vec4(1.0e-4f))))
+						Result = 1;
+				}
+			}
+			if (Result != 0)
+				std::cerr << "  " << Variant.Name << ": world matrices differ from scalar reference" << '\n';
+		}
+	}
+
+	return Result;
+}
+
+int benchmarkEntities()
+{
+	constexpr size_t Counts[] = {10000, 100000, 1000000};
+
+	Camera BenchCamera(glm::vec3(0.0f, 2.0f, 0.0f));
+	const Frustum ViewFrustum = BenchCamera.getFrustum(800, 600);
+	const BoundingSphere UnitSphere{glm::vec3(0.0f), 1.0f};
+	volatile float Sink = 0.0f;
+
+	for (const size_t Count : Counts)
+	{
+		// Entities on a square field under one root; a quarter are renderable, one in a hundred are lights
+		EntityWorld World;
+		World.reserve(Count + 1);
+		const NodeId Root = World.createGroup(InvalidNode, glm::vec3(0.0f));
+		const int Side = static_cast<int>(std::sqrt(static_cast<double>(Count)));
+		for (size_t I = 0; I < Count; I++)
+		{
+			const glm::vec3 Position(static_cast<float>(I % Side) - Side / 2.0f, 0.0f, static_cast<float>(I / Side) - Side / 2.0f);
+			const Entity Id = World.createEntity(Root, Position, glm::vec3(0.25f), UnitSphere);
+			if (I % 4 == 0)
+				World.getRegistry().add(Id, RenderableComponent{nullptr, glm::vec3(1.0f), true});
+			if (I % 100 == 0)
+				World.getRegistry().add(Id, PointLightComponent{static_cast<uint32_t>(I / 100)});
+		}
+		World.updateTransforms();
+
+		const int Runs = static_cast<int>(std::max<size_t>(5, 2000000 / Count));
+		const auto PerEntityNs = [Count](const double Ms) { return Ms * 1.0e6 / static_cast<double>(Count); };
+		std::cout << "  " << Count << " entities (" << Runs << " runs)" << '\n';
+
+		// Dense pass over one packed component array
+		std::vector<BoundsComponent>& Bounds = World.getRegistry().getPool<BoundsComponent>().getComponents();
+		const double DenseMs = averageMs(Runs, [&](int)
+		{
+			float Sum = 0.0f;
+			for (const BoundsComponent& Sphere : Bounds)
+				Sum += Sphere.World.Radius;
+			Sink = Sink + Sum;
+		});
+		std::cout << "    dense bounds pass     : " << DenseMs << " ms, " << PerEntityNs(DenseMs) << " ns/entity" << '\n';
+
+		// Join driven by the sparser renderable pool, looking transforms up through the sparse index
+		const double JoinMs = averageMs(Runs, [&](int)
+		{
+			float Sum = 0.0f;
+			World.getRegistry().each<RenderableComponent, TransformComponent>(
+				[&](Entity, const RenderableComponent& Renderable, const TransformComponent& Transform)
+				{
+					Sum += Renderable.SolidColour.x + static_cast<float>(Transform.Node);
+				});
+			Sink = Sink + Sum;
+		});
+		std::cout << "    renderable+transform  : " << JoinMs << " ms, " << PerEntityNs(JoinMs) << " ns/entity" << '\n';
+
+		// Transform system with every node dirty, then the batch cull
+		const double TransformMs = averageMs(Runs, [&](const int Run)
+		{
+			World.getGraph().setPosition(Root, glm::vec3(0.0f, static_cast<float>(Run % 2), 0.0f));
+			World.updateTransforms();
+		});
+		std::cout << "    transforms + bounds   : " << TransformMs << " ms, " << PerEntityNs(TransformMs) << " ns/entity" << '\n';
+
+		const double StaticMs = averageMs(Runs, [&](int) { World.updateTransforms(); });
+		std::cout << "    transforms (static)   : " << StaticMs << " ms" << '\n';
+
+		size_t Visible = 0;
+		const double CullMs = averageMs(Runs, [&](int) { Visible = World.cull(ViewFrustum).size(); });
+		std::cout << "    cull                  : " << CullMs << " ms, " << PerEntityNs(CullMs) << " ns/entity, "
+			<< Visible << " visible" << '\n';
+	}
+
+	return 0;
+}
+
+int benchmarkSceneLoad()
+{
+	constexpr int EntityCount = 100000;
+	constexpr int Runs = 10;
+
+	// A garden of 100k individually placed entities under 100 groups, written the way a level
+	// editor would export it rather than as grid commands
+	const std::filesystem::path Directory = std::filesystem::temp_directory_path();
+	const std::string TextPath = (Directory / "bench_scene.scene").string();
+	const std::string BinaryPath = (Directory / "bench_scene.bin").string();
+	{
+		std::ofstream Text(TextPath);
+		Text << "clear 0.1 0.1 0.1\n";
+		Text << "model plant resources/models/AncientEmpire/SM_Env_Garden_Plants_01.obj PolygonAncientWorlds_Texture_01_A.png\n";
+		Text << "model tree resources/models/AncientEmpire/SM_Env_Tree_Palm_01.obj PolygonAncientWorlds_Texture_01_A.png\n";
+		Text << "model sphere resources/models/Sphere/Sphere_HighPoly.obj -\n";
+		for (int Group = 0; Group < 100; Group++)
+			Text << "group g" << Group << " - " << Group % 10 * 40 << " 0 " << Group / 10 * 40 << "\n";
+		for (int I = 0; I < EntityCount; I++)
+		{
+			Text << (I % 50 == 0 ? "entity tree g" : "entity plant g") << I % 100 << ' ' << I % 32 * 1.25f << " 0 "
+				<< I / 100 % 32 * 1.25f << ' ' << (I % 50 == 0 ? 0.01f : 0.005f) << "\n";
+		}
+		Text << "light sphere - -2 0.5 0 0.5 1 0 0 1 0.09 0.032\n";
+	}
+
+	if (!SceneDescription::compile(TextPath, BinaryPath))
+		return 1;
+
+	SceneDescription FromText;
+	SceneDescription FromBinary;
+	bool Loaded = true;
+	const double TextMs = averageMs(Runs, [&](int) { Loaded &= FromText.loadText(TextPath); });
+	const double BinaryMs = averageMs(Runs, [&](int) { Loaded &= FromBinary.loadBinary(BinaryPath); });
+	if (!Loaded)
+		return 1;
+
+	const auto TextBytes = std::filesystem::file_size(TextPath);
+	const auto BinaryBytes = std::filesystem::file_size(BinaryPath);
+	std::cout << "  " << FromBinary.getEntities().size() << " entities" << '\n';
+	std::cout << "  text   : " << TextMs << " ms, " << TextBytes << " bytes" << '\n';
+	std::cout << "  binary : " << BinaryMs << " ms, " << BinaryBytes << " bytes (" << TextMs / BinaryMs << "x faster)" << '\n';
+
+	// Both forms must describe the same scene
+	int Result = 0;
+	if (FromText.getSize() != FromBinary.getSize() ||
+		std::memcmp(FromText.getEntities().data(), FromBinary.getEntities().data(), FromText.getEntities().size_bytes()) != 0)
+	{
+		std::cerr << "  text and binary descriptions differ" << '\n';
+		Result = 1;
+	}
+
+	std::filesystem::remove(TextPath);
+	std::filesystem::remove(BinaryPath);
+	return Result;
+}
+
+int benchmarkJobs()
+{
+	constexpr unsigned int Size = 1024;
+	constexpr int SmoothPasses = 5;
+	constexpr int JobCount = 100000;
+	const char* const ModelPaths[] = {
+		"resources/models/AncientEmpire/SM_Env_Garden_Plants_01.obj",
+		"resources/models/AncientEmpire/SM_Env_Tree_Palm_01.obj",
+		"resources/models/AncientEmpire/SM_Prop_Statue_01.obj",
+		"resources/models/Sphere/Sphere_HighPoly.obj",
+	};
+
+	std::mt19937 Random(7);
+	std::uniform_real_distribution<float> Height(0.0f, 1.0f);
+	std::vector<float> Source(Size * Size);
+	for (float& Value : Source)
+		Value = Height(Random);
+
+	// The terrain smoothing pass on a heightmap four times the size of Heightmap0
+	auto Smooth = [&](std::vector<float>& Map, std::vector<float>& Scratch)
+	{
+		JobSystem::getInstance().parallelFor(Size, 16, [&](const size_t FirstRow, const size_t LastRow)
+		{
+			for (size_t Row = FirstRow; Row < LastRow; Row++)
+			{
+				for (size_t Col = 0; Col < Size; Col++)
+				{
+					float Sum = 0.0f;
+					int Count = 0;
+					for (size_t R = Row > 0 ? Row - 1 : 0; R <= std::min<size_t>(Row + 1, Size - 1); R++)
+					{
+						for (size_t C = Col > 0 ? Col - 1 : 0; C <= std::min<size_t>(Col + 1, Size - 1); C++)
+						{
+							Sum += Map[R * Size + C];
+							Count++;
+						}
+					}
+					Scratch[Row * Size + Col] = Sum / Count;
+				}
+			}
+		});
+		Map.swap(Scratch);
+	};
+
+	const unsigned int Cores = JobSystem::defaultWorkerCount() + 1;
+	std::cout << "  " << Cores << " hardware threads" << '\n';
+
+	double BaseSmoothMs = 0.0;
+	double BaseLoadMs = 0.0;
+	float Checksum = 0.0f;
+	for (unsigned int Threads = 1; Threads <= Cores; Threads++)
+	{
+		JobSystem& Jobs = JobSystem::getInstance();
+		Jobs.initialize(Threads - 1);
+
+		std::vector<float> Map;
+		std::vector<float> Scratch(Source.size());
+		const double SmoothMs = averageMs(5, [&](int)
+		{
+			Map = Source;
+			for (int Pass = 0; Pass < SmoothPasses; Pass++)
+				Smooth(Map, Scratch);
+		});
+		if (Threads == 1)
+			Checksum = Map[Size * Size / 2];
+		else if (Map[Size * Size / 2] != Checksum)
+			std::cerr << "  smoothing result differs with " << Threads << " threads" << '\n';
+
+		// Parse and decode every model at once, the CPU half of ResidencyManager::acquireModels
+		std::streambuf* Console = std::cout.rdbuf(nullptr);
+		size_t Vertices = 0;
+		const double LoadMs = averageMs(3, [&](int)
+		{
+			std::vector<ModelSource> Sources(std::size(ModelPaths));
+			JobCounter Loaded;
+			for (size_t I = 0; I < Sources.size(); I++)
+				Jobs.run([&, I] { Sources[I] = Model::read(ModelPaths[I], "PolygonAncientWorlds_Texture_01_A.png"); }, &Loaded);
+			Jobs.wait(Loaded);
+
+			Vertices = 0;
+			for (const ModelSource& Loaded : Sources)
+			{
+				for (const ModelSource::MeshSource& Mesh : Loaded.Meshes)
+					Vertices += Mesh.Vertices.size();
+			}
+		});
+		std::cout.rdbuf(Console);
+		std::cout.clear();
+
+		// Scheduling cost alone: empty jobs against one counter
+		JobCounter Empty;
+		const double OverheadMs = averageMs(1, [&](int)
+		{
+			for (int I = 0; I < JobCount; I++)
+				Jobs.run([] {}, &Empty);
+			Jobs.wait(Empty);
+		});
+
+		if (Threads == 1)
+		{
+			BaseSmoothMs = SmoothMs;
+			BaseLoadMs = LoadMs;
+		}
+
+		std::cout << "  " << Threads << (Threads == 1 ? " thread " : " threads") << ": smooth " << SmoothMs << " ms ("
+			<< BaseSmoothMs / SmoothMs << "x), load " << LoadMs << " ms (" << BaseLoadMs / LoadMs << "x, "
+			<< Vertices << " vertices), " << OverheadMs * 1.0e6 / JobCount << " ns/job" << '\n';
+	}
+
+	JobSystem::getInstance().shutdown();
+	return 0;
+}
+
+int benchmarkRecording()
+{
+	constexpr int Runs = 20;
+	constexpr size_t BatchSize = 1024;
+
+	const unsigned int Cores = JobSystem::defaultWorkerCount() + 1;
+	std::cout << "  " << Cores << " hardware threads" << '\n';
+
+	for (const int EntityCount : {10000, 100000})
+	{
+		// A scene like Scene 1's garden: one group, every entity visible and drawn
+		EntityWorld World;
+		World.reserve(EntityCount);
+		const NodeId Root = World.createGroup(InvalidNode, glm::vec3(0.0f));
+		const BoundingSphere Bounds{glm::vec3(0.0f), 1.0f};
+		for (int I = 0; I < EntityCount; I++)
+		{
+			const Entity Id = World.createEntity(Root, glm::vec3(I % 300, 0.0f, I / 300), glm::vec3(0.005f), Bounds);
+			World.getRegistry().add(Id, RenderableComponent{nullptr, glm::vec3(1.0f), true});
+		}
+		World.updateTransforms();
+
+		const std::vector<Entity>& Entities = World.getRegistry().getPool<RenderableComponent>().getEntities();
+		ComponentPool<RenderableComponent>& Renderables = World.getRegistry().getPool<RenderableComponent>();
+		ComponentPool<TransformComponent>& Transforms = World.getRegistry().getPool<TransformComponent>();
+		const SceneGraph& Graph = World.getGraph();
+
+		std::cout << "  " << EntityCount << " entities" << '\n';
+		double BaseMs = 0.0;
+		for (unsigned int Threads = 1; Threads <= Cores; Threads++)
+		{
+			JobSystem::getInstance().initialize(Threads - 1);
+
+			// Same work per entity as Scene::drawVisibleEntities: component lookups, the world
+			// matrix and a keyed packet; Program is left null since nothing is replayed here
+			RenderQueue Queue;
+			RecordStats Stats;
+			const double Ms = averageMs(Runs, [&](int)
+			{
+				Queue.record(Entities.size(), BatchSize, [&](CommandBuffer& Buffer, const size_t Begin, const size_t End)
+				{
+					for (size_t I = Begin; I < End; I++)
+					{
+						const RenderableComponent* Renderable = Renderables.tryGet(Entities[I]);
+						if (Renderable == nullptr || !Renderable->Textured)
+							continue;
+						const GeometryHandle Geometry = static_cast<GeometryHandle>(I % 64);
+						Buffer.push({RenderQueue::makeKey(1, 2, GL_BACK, Geometry), nullptr, 2, Geometry, GL_BACK,
+							Graph.getWorld(Transforms.get(Entities[I]).Node)});
+					}
+				});
+				Queue.clear();
+				Stats = Queue.getRecordStats();
+			});
+
+			if (Threads == 1)
+				BaseMs = Ms;
+
+			double Busiest = 0.0;
+			std::cout << "    " << Threads << (Threads == 1 ? " thread : " : " threads: ") << Ms << " ms (" << BaseMs / Ms << "x), "
+				<< Stats.Packets << " packets in " << Stats.Batches << " batches; per thread";
+			for (size_t Thread = 0; Thread < Stats.ThreadMs.size(); Thread++)
+			{
+				std::cout << ' ' << Stats.ThreadMs[Thread];
+				Busiest = std::max(Busiest, Stats.ThreadMs[Thread]);
+			}
+			std::cout << " ms (busiest " << Busiest << " ms)" << '\n';
+		}
+	}
+
+	JobSystem::getInstance().shutdown();
+	return 0;
+}
+
+int benchmarkProfiler()
+{
+	constexpr int Runs = 20;
+	constexpr size_t Zones = 50000;
+	Profiler& Recorder = Profiler::getInstance();
+
+	// Zones fit in one ring (RingSize) so each drain below sees all of them
+	const double ZoneMs = averageMs(Runs, [&](int)
+	{
+		for (size_t I = 0; I < Zones; I++)
+			ProfileZone Zone("Empty");
+		Recorder.endFrame();
+	});
+
+	double DrainMs = 0.0;
+	for (int Run = 0; Run < Runs; Run++)
+	{
+		for (size_t I = 0; I < Zones; I++)
+			ProfileZone Zone("Empty");
+		const auto Start = std::chrono::steady_clock::now();
+		Recorder.endFrame();
+		DrainMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count() / Runs;
+	}
+
+	// Each zone reads the clock twice; on virtual machines that read alone can dominate
+	uint64_t Ticks = 0;
+	const double ClockMs = averageMs(Runs, [&](int)
+	{
+		for (size_t I = 0; I < Zones; I++)
+			Ticks += Profiler::now();
+	});
+
+	std::cout << "  Clock read: " << ClockMs * 1.0e6 / Zones << " ns" << (Ticks == 0 ? " (stopped)" : "") << '\n';
+	std::cout << "  One thread: " << (ZoneMs - DrainMs) * 1.0e6 / Zones << " ns per zone, draining " << Zones << " zones "
+		<< DrainMs << " ms (" << DrainMs * 1.0e6 / Zones << " ns each)" << '\n';
+
+	const unsigned int Cores = JobSystem::defaultWorkerCount() + 1;
+	for (unsigned int Threads = 1; Threads <= Cores; Threads++)
+	{
+		JobSystem::getInstance().initialize(Threads - 1);
+		const double Ms = averageMs(Runs, [&](int)
+		{
+			JobSystem::getInstance().parallelFor(Zones * Threads, Zones, [](const size_t Begin, const size_t End)
+			{
+				for (size_t I = Begin; I < End; I++)
+					ProfileZone Zone("Empty");
+			});
+			Recorder.endFrame();
+		});
+		std::cout << "  " << Threads << (Threads == 1 ? " thread : " : " threads: ") << Zones * Threads << " zones in " << Ms
+			<< " ms including the drain, " << Ms * 1.0e6 / Zones << " ns per zone per thread" << '\n';
+	}
+
+	JobSystem::getInstance().shutdown();
+	return 0;
+}
+
+int benchmarkAssets()
+{
+	const std::vector<std::string> ModelPaths = findFiles("resources/models", ".obj");
+	const std::vector<std::string> TexturePaths = findFiles("resources/textures", ".png");
+	if (ModelPaths.empty())
+	{
+		std::cerr << "  No models found under resources/models; run from the project directory" << '\n';
+		return 1;
+	}
+
+	for (const std::string& Path : ModelPaths)
+	{
+		const std::string Name = std::filesystem::path(Path).stem().string();
+		ModelSource Source;
+		measureQuiet("parse " + Name, [&]
+		{
+			Source = ModelSource();
+			Model::readMeshes(Path, Source);
+		});
+
+		// The per-face corners tinyobjloader hands to the dedup, rebuilt from the welded mesh
+		std::vector<std::vector<Vertex>> Corners;
+		size_t CornerCount = 0;
+		for (const ModelSource::MeshSource& Mesh : Source.Meshes)
+		{
+			std::vector<Vertex>& MeshCorners = Corners.emplace_back();
+			MeshCorners.reserve(Mesh.Indices.size());
+			for (const unsigned int Index : Mesh.Indices)
+				MeshCorners.push_back(Mesh.Vertices[Index]);
+			CornerCount += MeshCorners.size();
+		}
+
+		size_t Unique = 0;
+		measure("dedup " + Name + " (" + std::to_string(CornerCount) + " corners)", [&]
+		{
+			Unique = 0;
+			for (const std::vector<Vertex>& MeshCorners : Corners)
+			{
+				std::vector<Vertex> Vertices;
+				std::vector<unsigned int> Indices;
+				deduplicateVertices(MeshCorners, Vertices, Indices);
+				Unique += Vertices.size();
+			}
+		});
+	}
+
+	for (const std::string& Path : TexturePaths)
+	{
+		measure("decode " + std::filesystem::path(Path).filename().string(), [&]
+		{
+			const DecodedImage Image = decodeImage(Path);
+		});
+	}
+
+	for (const char* const Sky : {"Corona", "RedEclipse"})
+	{
+		const std::string Directory = std::string("resources/skybox/") + Sky + "/";
+		const std::vector<std::string> Faces = {Directory + "Right.png", Directory + "Left.png", Directory + "Top.png",
+			Directory + "Bottom.png", Directory + "Back.png", Directory + "Front.png"};
+		measure(std::string("cubemap ") + Sky, [&]
+		{
+			const std::vector<DecodedImage> Images = Skybox::decodeFaces(Faces);
+		});
+	}
+	return 0;
+}
+
+int benchmarkTerrain()
+{
+	constexpr unsigned int Sizes[] = {256, 512, 1024, 2048, 4096};
+	JobSystem::getInstance().initialize(JobSystem::defaultWorkerCount());
+	std::cout << "  " << JobSystem::defaultWorkerCount() + 1 << " hardware threads" << '\n';
+
+	HeightMapInfo FileInfo;
+	FileInfo.FilePath = "resources/heightmap/heightmap.raw";
+	measure("load heightmap.raw", [&]
+	{
+		const std::vector<float> Heights = Terrain::LoadHeightMap(FileInfo);
+	});
+
+	// The terrain only ships a 512 heightmap; the larger sizes use noise of the same range
+	std::mt19937 Random(11);
+	std::uniform_real_distribution<float> Height(0.0f, 1.0f);
+	for (const unsigned int Size : Sizes)
+	{
+		HeightMapInfo Info;
+		Info.Width = Size;
+		Info.Depth = Size;
+		const std::string Label = std::to_string(Size) + "^2";
+
+		std::vector<float> Source(static_cast<size_t>(Size) * Size);
+		for (float& Value : Source)
+			Value = Height(Random);
+
+		std::vector<float> Heights;
+		measure("smooth " + Label, [&]
+		{
+			Heights = Source;
+			Terrain::SmoothHeights(Heights, Info);
+		});
+
+		{
+			std::vector<Vertex> Vertices(Heights.size());
+			measure("normals " + Label, [&] { Terrain::GenerateNormals(Heights, Info, Vertices); });
+		}
+
+		{
+			std::vector<GLuint> Indices;
+			measure("indices " + Label, [&] { Terrain::SetupIndexBuffer(Info, Indices); });
+		}
+	}
+
+	JobSystem::getInstance().shutdown();
+	return 0;
+}
+
+int benchmarkObjParse()
+{
+	const char* const ModelPaths[] = {
+		"resources/models/Sphere/Sphere_HighPoly.obj",
+		"resources/models/SciFiWorlds/SM_Bld_Planetary_Cannon_01.obj",
+		"resources/models/AncientEmpire/SM_Prop_Statue_01.obj",
+	};
+
+	// A last line of only blanks with no newline after it, which once read past the end of the buffer
+	const std::string TrailingBlanksPath = (std::filesystem::temp_directory_path() / "bench_trailing_blanks.obj").string();
+	{
+		std::ofstream File(TrailingBlanksPath, std::ios::binary | std::ios::trunc);
+		File << "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n \t ";
+	}
+
+	// The serial reference, and a check that both parsers agree on every model
+	std::vector<std::string> CheckPaths = findFiles("resources/models", ".obj");
+	CheckPaths.push_back(TrailingBlanksPath);
+	int Mismatches = 0;
+	for (const std::string& Path : CheckPaths)
+	{
+		tinyobj::attrib_t Attrib;
+		std::vector<tinyobj::shape_t> Shapes;
+		std::vector<tinyobj::material_t> Materials;
+		std::string Warn, Err;
+		tinyobj::LoadObj(&Attrib, &Shapes, &Materials, &Warn, &Err, Path.c_str(), nullptr, true);
+
+		ObjGeometry Geometry;
+		parseObj(Path, Geometry, Warn, Err);
+
+		bool Same = Attrib.vertices == Geometry.Positions && Attrib.normals == Geometry.Normals && Attrib.texcoords == Geometry.TexCoords
+			&& Shapes.size() == Geometry.Shapes.size();
+		for (size_t I = 0; Same && I < Shapes.size(); I++)
+		{
+			const std::vector<tinyobj::index_t>& Expected = Shapes[I].mesh.indices;
+			const std::vector<tinyobj::index_t>& Actual = Geometry.Shapes[I].Corners;
+			Same = Expected.size() == Actual.size() && std::equal(Expected.begin(), Expected.end(), Actual.begin(),
+				[](const tinyobj::index_t& A, const tinyobj::index_t& B)
+				{
+					return A.vertex_index == B.vertex_index && A.normal_index == B.normal_index && A.texcoord_index == B.texcoord_index;
+				});
+		}
+		if (!Same)
+		{
+			std::cerr << "  parseObj differs from tinyobj::LoadObj on " << Path << '\n';
+			Mismatches++;
+		}
+	}
+	std::filesystem::remove(TrailingBlanksPath);
+
+	for (const char* const Path : ModelPaths)
+	{
+		const std::string Name = std::filesystem::path(Path).stem().string();
+		measure("tinyobj::LoadObj " + Name, [&]
+		{
+			tinyobj::attrib_t Attrib;
+			std::vector<tinyobj::shape_t> Shapes;
+			std::vector<tinyobj::material_t> Materials;
+			std::string Warn, Err;
+			tinyobj::LoadObj(&Attrib, &Shapes, &Materials, &Warn, &Err, Path, nullptr, true);
+		});
+	}
+
+	const unsigned int Cores = JobSystem::defaultWorkerCount() + 1;
+	std::cout << "  " << Cores << " hardware threads" << '\n';
+	for (unsigned int Threads = 1; Threads <= Cores; Threads++)
+	{
+		JobSystem::getInstance().initialize(Threads - 1);
+		for (const char* const Path : ModelPaths)
+		{
+			const std::string Name = std::filesystem::path(Path).stem().string();
+			measure("parseObj " + Name + " " + std::to_string(Threads) + (Threads == 1 ? " thread" : " threads"), [&]
+			{
+				ObjGeometry Geometry;
+				std::string Warn, Err;
+				parseObj(Path, Geometry, Warn, Err);
+			});
+			measureQuiet("readMeshes " + Name + " " + std::to_string(Threads) + (Threads == 1 ? " thread" : " threads"), [&]
+			{
+				ModelSource Source;
+				Model::readMeshes(Path, Source);
+			});
+		}
+	}
+
+	JobSystem::getInstance().shutdown();
+	return Mismatches == 0 ? 0 : 1;
+}
+
+int benchmarkStaticBatch()
+{
+	JobSystem::getInstance().initialize(JobSystem::defaultWorkerCount());
+	std::cout << "  " << JobSystem::defaultWorkerCount() + 1 << " hardware threads" << '\n';
+
+	// The Scene1 garden: a plant grid, four trees and the statue, with the model's texture as the batch key
+	ModelSource Plant, Tree, Statue;
+	Model::readMeshes("resources/models/AncientEmpire/SM_Env_Garden_Plants_01.obj", Plant);
+	Model::readMeshes("resources/models/AncientEmpire/SM_Env_Tree_Palm_01.obj", Tree);
+	Model::readMeshes("resources/models/AncientEmpire/SM_Prop_Statue_01.obj", Statue);
+	const std::vector<Texture> Textures = {{1, "texture_diffuse", ""}};
+
+	const auto addModel = [&Textures](StaticBatcher& Batcher, const ModelSource& Source, const glm::vec3& Position, const float Scale)
+	{
+		const glm::mat4 Transform = glm::scale(glm::translate(glm::mat4(1.0f), Position + glm::vec3(0.0f, 0.0f, 15.0f)), glm::vec3(Scale));
+		for (const ModelSource::MeshSource& Mesh : Source.Meshes)
+			Batcher.add(Mesh.Vertices, Mesh.Indices, Textures, Transform);
+	};
+
+	for (const int Radius : {5, 10, 20})
+	{
+		StaticBatcher Batcher;
+		const auto fill = [&]
+		{
+			Batcher.clear();
+			for (int X = -Radius; X <= Radius; X++)
+			{
+				for (int Z = -Radius; Z <= Radius; Z++)
+					addModel(Batcher, Plant, glm::vec3(X, 0.0f, Z * 0.8f), 0.005f);
+			}
+			for (const glm::vec3 Position : {glm::vec3(-6.0f, 0.0f, -5.0f), glm::vec3(6.0f, 0.0f, -5.0f), glm::vec3(-6.0f, 0.0f, 5.0f),
+				glm::vec3(6.0f, 0.0f, 5.0f)})
+				addModel(Batcher, Tree, Position, 0.01f);
+			addModel(Batcher, Statue, glm::vec3(0.0f), 0.01f);
+		};
+
+		const int Side = Radius * 2 + 1;
+		measure("build " + std::to_string(Side * Side) + " plants", [&]
+		{
+			fill();
+			Batcher.build();
+		});
+
+		const StaticBatchStats& Stats = Batcher.getStats();
+		std::cout << "    " << Stats.SourceDraws << " draws -> " << Stats.Batches << ", "
+			<< static_cast<double>(Stats.BatchBytes) / (1024.0 * 1024.0) << " MB batched over "
+			<< static_cast<double>(Stats.SourceBytes) / (1024.0 * 1024.0) << " MB shared" << '\n';
+	}
+
+	JobSystem::getInstance().shutdown();
+	return 0;
+}
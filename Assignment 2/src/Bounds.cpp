@@ -0,0 +1,90 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : Bounds.cpp
+Description : Implementations for bounding volumes and view frustums
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "Bounds.h"
+
+#include <algorithm>
+
+glm::vec3 Aabb::getCentre() const
+{
+	return (Min + Max) * 0.5f;
+}
+
+Aabb Aabb::merged(const Aabb& Other) const
+{
+	return {glm::min(Min, Other.Min), glm::max(Max, Other.Max)};
+}
+
+Aabb Aabb::transformed(const glm::mat4& Transform) const
+{
+	// Arvo's method: project the box extents onto each axis of the transform
+	const glm::vec3 Centre = glm::vec3(Transform * glm::vec4(getCentre(), 1.0f));
+	const glm::vec3 Extent = (Max - Min) * 0.5f;
+	const glm::mat3 Absolute(glm::abs(glm::vec3(Transform[0])), glm::abs(glm::vec3(Transform[1])),
+	                         glm::abs(glm::vec3(Transform[2])));
+	const glm::vec3 NewExtent = Absolute * Extent;
+	return {Centre - NewExtent, Centre + NewExtent};
+}
+
+BoundingSphere BoundingSphere::transformed(const glm::mat4& Transform) const
+{
+	const float ScaleX = glm::length(glm::vec3(Transform[0]));
+	const float ScaleY = glm::length(glm::vec3(Transform[1]));
+	const float ScaleZ = glm::length(glm::vec3(Transform[2]));
+	return {glm::vec3(Transform * glm::vec4(Centre, 1.0f)), Radius * std::max({ScaleX, ScaleY, ScaleZ})};
+}
+
+Frustum Frustum::fromMatrix(const glm::mat4& ViewProjection)
+{
+	// Gribb/Hartmann plane extraction from the rows of the combined matrix
+	const glm::mat4 M = glm::transpose(ViewProjection);
+
+	Frustum Result;
+	Result.Planes[0] = M[3] + M[0]; // Left
+	Result.Planes[1] = M[3] - M[0]; // Right
+	Result.Planes[2] = M[3] + M[1]; // Bottom
+	Result.Planes[3] = M[3] - M[1]; // Top
+	Result.Planes[4] = M[3] + M[2]; // Near
+	Result.Planes[5] = M[3] - M[2]; // Far
+
+	// Normalised so plane distances are in world units and comparable with sphere radii
+	for (glm::vec4& Plane : Result.Planes)
+	{
+		Plane /= glm::length(glm::vec3(Plane));
+	}
+	return Result;
+}
+
+bool Frustum::intersects(const BoundingSphere& Sphere) const
+{
+	for (const glm::vec4& Plane : Planes)
+	{
+		if (glm::dot(glm::vec3(Plane), Sphere.Centre) + Plane.w < -Sphere.Radius)
+			return false;
+	}
+	return true;
+}
+
+bool Frustum::intersects(const Aabb& Box) const
+{
+	for (const glm::vec4& Plane : Planes)
+	{
+		// Test the corner furthest along the plane normal
+		const glm::vec3 Positive(Plane.x >= 0.0f ? Box.Max.x : Box.Min.x, Plane.y >= 0.0f ? Box.Max.y : Box.Min.y,
+		                         Plane.z >= 0.0f ? Box.Max.z : Box.Min.z);
+		if (glm::dot(glm::vec3(Plane), Positive) + Plane.w < 0.0f)
+			return false;
+	}
+	return true;
+}
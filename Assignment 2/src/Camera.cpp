@@ -41,7 +41,12 @@ glm::mat4 Camera::getViewMatrix() const
 
 glm::mat4 Camera::getProjectionMatrix(const float Width, const float Height) const
 {
-	return glm::perspective(glm::radians(FZoom), Width / Height, 0.1f, 100.0f);
+	return glm::perspective(glm::radians(FZoom), Width / Height, NearPlane, FarPlane);
+}
+
+Frustum Camera::getFrustum(const float Width, const float Height) const
+{
+	return Frustum::fromMatrix(getProjectionMatrix(Width, Height) * getViewMatrix());
 }
 
 void Camera::processKeyboard(const CameraMovement Direction, const float DeltaTime)
@@ -89,6 +94,15 @@ void Camera::processMouseScroll(const float OffsetY)
 		FZoom = 90.0f;
 }
 
+void Camera::setPose(const glm::vec3& Position, const float Yaw, const float Pitch, const float Zoom)
+{
+	VPosition = Position;
+	FYaw = Yaw;
+	FPitch = Pitch;
+	FZoom = Zoom;
+	updateCameraVectors();
+}
+
 void Camera::updateCameraVectors()
 {
 	glm::vec3 front;
@@ -0,0 +1,167 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : CameraPath.cpp
+Description : Implementations for CameraPath class
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "CameraPath.h"
+
+#include "Camera.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+	glm::vec3 catmullRom(const glm::vec3& P0, const glm::vec3& P1, const glm::vec3& P2, const glm::vec3& P3, const float T)
+	{
+		const float T2 = T * T;
+		const float T3 = T2 * T;
+		return 0.5f * (2.0f * P1 + (P2 - P0) * T + (2.0f * P0 - 5.0f * P1 + 4.0f * P2 - P3) * T2 + (3.0f * P1 - P0 - 3.0f * P2 + P3) * T3);
+	}
+}
+
+bool CameraPath::load(const std::string& Path)
+{
+	std::ifstream File(Path);
+	if (!File.is_open())
+	{
+		std::cerr << "CameraPath: failed to open " << Path << '\n';
+		return false;
+	}
+
+	clear();
+	std::string Text;
+	int LineNumber = 0;
+
+	const auto fail = [&](const std::string& Message)
+	{
+		std::cerr << "CameraPath: " << Path << ":" << LineNumber << ": " << Message << '\n';
+		clear();
+		return false;
+	};
+
+	while (std::getline(File, Text))
+	{
+		LineNumber++;
+		const size_t Comment = Text.find('#');
+		if (Comment != std::string::npos)
+			Text.erase(Comment);
+
+		std::istringstream Line(Text);
+		std::string Command;
+		if (!(Line >> Command))
+			continue;
+
+		if (Command == "scene")
+		{
+			if (!(Line >> MScene) || MScene < 1 || MScene > 5)
+				return fail("expected scene 1-5");
+		}
+		else if (Command == "key")
+		{
+			CameraKey Key;
+			if (!(Line >> Key.Time >> Key.Position.x >> Key.Position.y >> Key.Position.z >> Key.Yaw >> Key.Pitch >> Key.Zoom))
+				return fail("expected key seconds x y z yaw pitch zoom");
+			if (!MKeys.empty() && Key.Time <= MKeys.back().Time)
+				return fail("key times must increase");
+			MKeys.push_back(Key);
+		}
+		else
+		{
+			return fail("unknown command '" + Command + "'");
+		}
+	}
+
+	if (MKeys.empty())
+		return fail("no keys");
+	return true;
+}
+
+bool CameraPath::save(const std::string& Path) const
+{
+	std::ofstream File(Path, std::ios::trunc);
+	if (!File.is_open())
+	{
+		std::cerr << "CameraPath: failed to write " << Path << '\n';
+		return false;
+	}
+
+	File << "# Recorded camera path, " << MKeys.size() << " keys over " << getDuration() << " s\n";
+	File << "scene " << MScene << '\n';
+	for (const CameraKey& Key : MKeys)
+	{
+		File << "key " << Key.Time << ' ' << Key.Position.x << ' ' << Key.Position.y << ' ' << Key.Position.z << ' '
+			<< Key.Yaw << ' ' << Key.Pitch << ' ' << Key.Zoom << '\n';
+	}
+	return static_cast<bool>(File);
+}
+
+void CameraPath::clear()
+{
+	MKeys.clear();
+	MScene = 1;
+}
+
+void CameraPath::setScene(const int Scene)
+{
+	MScene = Scene;
+}
+
+void CameraPath::addKey(const Camera& Camera, const float Time)
+{
+	// Two frames can share a timestamp when the clock is coarse; keep the later pose
+	if (!MKeys.empty() && Time <= MKeys.back().Time)
+		MKeys.pop_back();
+	MKeys.push_back({Time, Camera.VPosition, Camera.FYaw, Camera.FPitch, Camera.FZoom});
+}
+
+CameraKey CameraPath::sample(const float Time) const
+{
+	if (MKeys.empty())
+		return {0.0f, glm::vec3(0.0f), -90.0f, 0.0f, 45.0f};
+	if (Time <= MKeys.front().Time)
+		return MKeys.front();
+	if (Time >= MKeys.back().Time)
+		return MKeys.back();
+
+	// Segment [I, I + 1] contains Time; the curve's outer control points clamp at the ends
+	const auto Next = std::upper_bound(MKeys.begin(), MKeys.end(), Time, [](const float Value, const CameraKey& Key)
+	{
+		return Value < Key.Time;
+	});
+	const size_t I = static_cast<size_t>(Next - MKeys.begin()) - 1;
+	const CameraKey& A = MKeys[I];
+	const CameraKey& B = MKeys[I + 1];
+	const glm::vec3& Before = MKeys[I > 0 ? I - 1 : I].Position;
+	const glm::vec3& After = MKeys[std::min(I + 2, MKeys.size() - 1)].Position;
+	const float T = (Time - A.Time) / (B.Time - A.Time);
+
+	return {Time, catmullRom(Before, A.Position, B.Position, After, T), A.Yaw + (B.Yaw - A.Yaw) * T,
+		A.Pitch + (B.Pitch - A.Pitch) * T, A.Zoom + (B.Zoom - A.Zoom) * T};
+}
+
+float CameraPath::getDuration() const
+{
+	return MKeys.empty() ? 0.0f : MKeys.back().Time;
+}
+
+int CameraPath::getScene() const
+{
+	return MScene;
+}
+
+size_t CameraPath::getKeyCount() const
+{
+	return MKeys.size();
+}
@@ -0,0 +1,243 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : CameraReplay.cpp
+Description : Implementations for CameraReplay class
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "CameraReplay.h"
+
+#include "Camera.h"
+#include "GpuProfiler.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+	struct FrameTimeSummary
+	{
+		size_t Count = 0;
+		double AvgMs = 0.0;
+		double P95Ms = 0.0;
+		double P99Ms = 0.0;
+		double MaxMs = 0.0;
+	};
+
+	FrameTimeSummary summarizeTimes(std::vector<double> Times)
+	{
+		FrameTimeSummary Summary;
+		if (Times.empty())
+			return Summary;
+
+		std::sort(Times.begin(), Times.end());
+		double Total = 0.0;
+		for (const double Ms : Times)
+			Total += Ms;
+
+		const auto percentile = [&Times](const double Fraction)
+		{
+			return Times[std::min(Times.size() - 1, static_cast<size_t>(Fraction * static_cast<double>(Times.size())))];
+		};
+
+		Summary.Count = Times.size();
+		Summary.AvgMs = Total / static_cast<double>(Times.size());
+		Summary.P95Ms = percentile(0.95);
+		Summary.P99Ms = percentile(0.99);
+		Summary.MaxMs = Times.back();
+		return Summary;
+	}
+
+	void printSummary(const char* Label, const FrameTimeSummary& Summary)
+	{
+		std::cout << "  " << Label << " ms: avg " << Summary.AvgMs << ", p95 " << Summary.P95Ms << ", p99 " << Summary.P99Ms
+			<< ", max " << Summary.MaxMs << " over " << Summary.Count << " frames" << '\n';
+	}
+}
+
+CameraReplay& CameraReplay::getInstance()
+{
+	static CameraReplay Instance;
+	return Instance;
+}
+
+bool CameraReplay::startPlayback(const std::string& PathFile)
+{
+	if (!MPath.load(PathFile))
+		return false;
+
+	MName = std::filesystem::path(PathFile).stem().string();
+	MState = State::Warmup;
+	MFrame = 0;
+	MFrames.clear();
+	MFrames.reserve(static_cast<size_t>(MPath.getDuration() / FixedStep) + 1);
+	GpuProfiler::getInstance().setFrameListener([this](const uint64_t Frame, const double Ms) { onGpuFrame(Frame, Ms); });
+
+	std::cout << "Replaying " << PathFile << ": scene " << MPath.getScene() << ", " << MPath.getKeyCount() << " keys over "
+		<< MPath.getDuration() << " s at a fixed " << FixedStep * 1000.0f << " ms step" << '\n';
+	return true;
+}
+
+bool CameraReplay::isPlaying() const
+{
+	return MState == State::Warmup || MState == State::Measuring || MState == State::Draining;
+}
+
+bool CameraReplay::isFinished() const
+{
+	return MState == State::Finished;
+}
+
+int CameraReplay::getScene() const
+{
+	return MPath.getScene();
+}
+
+float CameraReplay::beginFrame(Camera& Camera)
+{
+	// Warmup holds the first pose; draining holds the last while the GPU times come back
+	float Time = 0.0f;
+	if (MState == State::Measuring)
+		Time = static_cast<float>(MFrame) * FixedStep;
+	else if (MState == State::Draining)
+		Time = MPath.getDuration();
+
+	const CameraKey Key = MPath.sample(Time);
+	Camera.setPose(Key.Position, Key.Yaw, Key.Pitch, Key.Zoom);
+
+	if (MState == State::Measuring)
+	{
+		if (MFrames.empty())
+			MFirstGpuFrame = GpuProfiler::getInstance().getFrameIndex();
+		MFrames.push_back({Time, 0.0, -1.0});
+	}
+
+	MFrameStart = std::chrono::steady_clock::now();
+	return FixedStep;
+}
+
+void CameraReplay::endFrame()
+{
+	switch (MState)
+	{
+	case State::Warmup:
+		if (++MFrame >= WarmupFrames)
+		{
+			MState = State::Measuring;
+			MFrame = 0;
+		}
+		break;
+	case State::Measuring:
+		MFrames.back().CpuMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - MFrameStart).count();
+		if (static_cast<float>(++MFrame) * FixedStep > MPath.getDuration())
+		{
+			MState = State::Draining;
+			MFrame = 0;
+		}
+		break;
+	case State::Draining:
+		if (++MFrame >= GpuProfiler::FramesInFlight)
+		{
+			MState = State::Finished;
+			GpuProfiler::getInstance().setFrameListener(nullptr);
+			writeResults();
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void CameraReplay::toggleRecording(const int Scene)
+{
+	if (!MRecordingActive)
+	{
+		MRecording.clear();
+		MRecording.setScene(Scene);
+		MRecordingActive = true;
+		MRecordingStart = -1.0;
+		std::cout << "Recording camera path for scene " << Scene << " (K to stop)" << '\n';
+		return;
+	}
+
+	MRecordingActive = false;
+	if (MRecording.getKeyCount() < 2)
+	{
+		std::cout << "Camera path recording too short, discarded" << '\n';
+		return;
+	}
+
+	std::error_code Error;
+	std::filesystem::create_directories("results/paths", Error);
+	std::string Path;
+	for (int Index = 1; Path.empty() || std::filesystem::exists(Path); Index++)
+		Path = "results/paths/scene" + std::to_string(MRecording.getScene()) + "_" + std::to_string(Index) + ".path";
+
+	if (MRecording.save(Path))
+	{
+		std::cout << "Camera path saved to " << Path << " (" << MRecording.getKeyCount() << " keys, " << MRecording.getDuration()
+			<< " s)" << '\n';
+	}
+}
+
+void CameraReplay::recordFrame(const Camera& Camera, const double Time)
+{
+	if (!MRecordingActive)
+		return;
+
+	if (MRecordingStart < 0.0)
+		MRecordingStart = Time;
+	MRecording.addKey(Camera, static_cast<float>(Time - MRecordingStart));
+}
+
+bool CameraReplay::isRecording() const
+{
+	return MRecordingActive;
+}
+
+void CameraReplay::onGpuFrame(const uint64_t Frame, const double Ms)
+{
+	if (Frame >= MFirstGpuFrame && Frame - MFirstGpuFrame < MFrames.size())
+		MFrames[Frame - MFirstGpuFrame].GpuMs = Ms;
+}
+
+void CameraReplay::writeResults() const
+{
+	std::error_code Error;
+	std::filesystem::create_directories("results", Error);
+
+	const std::string Path = "results/replay_" + MName + ".csv";
+	std::ofstream File(Path, std::ios::trunc);
+	File << "frame,time,cpu_ms,gpu_ms\n";
+
+	std::vector<double> CpuTimes;
+	std::vector<double> GpuTimes;
+	for (size_t I = 0; I < MFrames.size(); I++)
+	{
+		const ReplayFrame& Frame = MFrames[I];
+		File << I << ',' << Frame.Time << ',' << Frame.CpuMs << ',';
+		if (Frame.GpuMs >= 0.0)
+		{
+			File << Frame.GpuMs;
+			GpuTimes.push_back(Frame.GpuMs);
+		}
+		File << '\n';
+		CpuTimes.push_back(Frame.CpuMs);
+	}
+
+	std::cout << "Replay of " << MName << " written to " << Path << '\n';
+	printSummary("CPU", summarizeTimes(CpuTimes));
+	if (GpuTimes.empty())
+		std::cout << "  GPU: no timings (the GPU profiler needs ENABLE_PROFILER)" << '\n';
+	else
+		printSummary("GPU", summarizeTimes(GpuTimes));
+}
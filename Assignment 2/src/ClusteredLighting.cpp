@@ -0,0 +1,175 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : ClusteredLighting.cpp
+Description : Implementations for ClusteredLighting class
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "ClusteredLighting.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// Binding points used by the cluster compute shaders and the lighting shader
+	constexpr GLuint LightBinding = 0;
+	constexpr GLuint ClusterBinding = 1;
+	constexpr GLuint LightCountBinding = 2;
+	constexpr GLuint LightIndexBinding = 3;
+
+	constexpr unsigned int CullGroupSize = 128;
+}
+
+ClusteredLighting::ClusteredLighting()
+	: MBuildShader("resources/shaders/ClusterBuild.comp"),
+	  MCullShader("resources/shaders/ClusterCull.comp"),
+	  MLightCount(0), MLightCapacity(0), MScreenSize(0.0f), MBuiltProjection(0.0f)
+{
+	glGenBuffers(1, &MLightBuffer);
+	glGenBuffers(1, &MClusterBuffer);
+	glGenBuffers(1, &MLightCountBuffer);
+	glGenBuffers(1, &MLightIndexBuffer);
+
+	// Cluster bounds: two vec4 per cluster
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, MClusterBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, ClusterCount * 2 * sizeof(glm::vec4), nullptr, GL_DYNAMIC_COPY);
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, MLightCountBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, ClusterCount * sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+
+	// Fixed-capacity light list per cluster, so culling needs no global atomics
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, MLightIndexBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, ClusterCount * MaxLightsPerCluster * sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void ClusteredLighting::uploadLights(const std::vector<PointLight>& Lights)
+{
+	std::vector<GpuPointLight> GpuLights(Lights.size());
+	for (size_t I = 0; I < Lights.size(); I++)
+	{
+		const PointLight& Light = Lights[I];
+		GpuLights[I].PositionRadius = glm::vec4(Light.Position, computeLightRadius(Light));
+		GpuLights[I].Colour = glm::vec4(Light.Colour, 1.0f);
+		GpuLights[I].Attenuation = glm::vec4(Light.Constant, Light.Linear, Light.Quadratic, 0.0f);
+	}
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, MLightBuffer);
+	if (GpuLights.size() > MLightCapacity)
+	{
+		MLightCapacity = std::max<size_t>(GpuLights.size(), MLightCapacity * 2);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, MLightCapacity * sizeof(GpuPointLight), nullptr, GL_DYNAMIC_DRAW);
+	}
+	if (!GpuLights.empty())
+	{
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, GpuLights.size() * sizeof(GpuPointLight), GpuLights.data());
+	}
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	MLightCount = static_cast<unsigned int>(GpuLights.size());
+}
+
+void ClusteredLighting::update(const Camera& Camera, const float Width, const float Height)
+{
+	// Cluster bounds only depend on the projection, so they are rebuilt on zoom or resize. The
+	// caller must draw with the projection of the same viewport size.
+	const glm::mat4 Projection = Camera.getProjectionMatrix(Width, Height);
+	const glm::vec2 ScreenSize(Width, Height);
+	if (Projection != MBuiltProjection || ScreenSize != MScreenSize)
+	{
+		buildClusters(Projection, ScreenSize);
+	}
+
+	MCullShader.use();
+	MCullShader.setMat4("view", Camera.getViewMatrix());
+	MCullShader.setUInt("lightCount", MLightCount);
+	MCullShader.setUInt("clusterCount", ClusterCount);
+	MCullShader.setUInt("maxLightsPerCluster", MaxLightsPerCluster);
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LightBinding, MLightBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, ClusterBinding, MClusterBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LightCountBinding, MLightCountBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LightIndexBinding, MLightIndexBuffer);
+
+	MCullShader.dispatch((ClusterCount + CullGroupSize - 1) / CullGroupSize);
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void ClusteredLighting::bind(const Shader& Shader) const
+{
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LightBinding, MLightBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LightCountBinding, MLightCountBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LightIndexBinding, MLightIndexBuffer);
+
+	// Depth slice = log(-z) * scale + bias, matching the exponential slices in ClusterBuild.comp
+	const float LogDepthRange = std::log(FarPlane / NearPlane);
+	Shader.setUInt("pointLightCount", MLightCount);
+	Shader.setUVec3("clusterGridSize", glm::uvec3(ClusterGridX, ClusterGridY, ClusterGridZ));
+	Shader.setVec2("clusterScreenSize", MScreenSize);
+	Shader.setFloat("clusterScale", static_cast<float>(ClusterGridZ) / LogDepthRange);
+	Shader.setFloat("clusterBias", -static_cast<float>(ClusterGridZ) * std::log(NearPlane) / LogDepthRange);
+	Shader.setUInt("maxLightsPerCluster", MaxLightsPerCluster);
+}
+
+void ClusteredLighting::cleanup()
+{
+	MBuildShader.cleanup();
+	MCullShader.cleanup();
+
+	const GLuint Buffers[] = {MLightBuffer, MClusterBuffer, MLightCountBuffer, MLightIndexBuffer};
+	glDeleteBuffers(4, Buffers);
+	MLightBuffer = MClusterBuffer = MLightCountBuffer = MLightIndexBuffer = 0;
+	MLightCapacity = 0;
+	MLightCount = 0;
+}
+
+unsigned int ClusteredLighting::getLightCount() const
+{
+	return MLightCount;
+}
+
+GLuint ClusteredLighting::getLightBuffer() const
+{
+	return MLightBuffer;
+}
+
+float ClusteredLighting::computeLightRadius(const PointLight& Light)
+{
+	// Distance at which the brightest channel falls below 5/256, i.e. no visible contribution
+	const float MaxChannel = std::max({Light.Colour.r, Light.Colour.g, Light.Colour.b});
+	if (MaxChannel <= 0.0f)
+		return 0.0f;
+
+	const float Cutoff = 256.0f / 5.0f * MaxChannel;
+	if (Light.Quadratic <= 0.0f)
+		return Light.Linear > 0.0f ? (Cutoff - Light.Constant) / Light.Linear : FarPlane;
+
+	const float Discriminant = Light.Linear * Light.Linear - 4.0f * Light.Quadratic * (Light.Constant - Cutoff);
+	return (-Light.Linear + std::sqrt(Discriminant)) / (2.0f * Light.Quadratic);
+}
+
+void ClusteredLighting::buildClusters(const glm::mat4& Projection, const glm::vec2& ScreenSize)
+{
+	MBuildShader.use();
+	MBuildShader.setMat4("inverseProjection", glm::inverse(Projection));
+	MBuildShader.setUVec3("gridSize", glm::uvec3(ClusterGridX, ClusterGridY, ClusterGridZ));
+	MBuildShader.setVec2("screenSize", ScreenSize);
+	MBuildShader.setFloat("zNear", NearPlane);
+	MBuildShader.setFloat("zFar", FarPlane);
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, ClusterBinding, MClusterBuffer);
+	MBuildShader.dispatch(ClusterGridX, ClusterGridY, ClusterGridZ);
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+	MBuiltProjection = Projection;
+	MScreenSize = ScreenSize;
+}
@@ -0,0 +1,67 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : CommandBuffer.cpp
+Description : Implementations for CommandBuffer class
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "CommandBuffer.h"
+
+#include "Model.h"
+#include "RenderQueue.h"
+
+#include <new>
+
+CommandBuffer::CommandBuffer(const size_t PacketsPerChunk)
+	: MMemory(PacketsPerChunk * sizeof(DrawPacket) + alignof(DrawPacket)), MPacketsPerChunk(PacketsPerChunk)
+{
+}
+
+void CommandBuffer::push(const DrawPacket& Packet)
+{
+	if (MChunks.empty() || MChunks.back().Count == MPacketsPerChunk)
+		MChunks.push_back({MMemory.allocate<DrawPacket>(MPacketsPerChunk), 0});
+
+	Chunk& Current = MChunks.back();
+	new (&Current.Packets[Current.Count]) DrawPacket(Packet);
+	Current.Count++;
+	MSize++;
+}
+
+void CommandBuffer::draw(const Shader& Program, const GLuint Texture, const GeometryHandle Geometry, const glm::mat4& Transform, const GLenum CullFace)
+{
+	push({RenderQueue::makeKey(Program.Id, Texture, CullFace, Geometry), &Program, Texture, Geometry, CullFace, Transform});
+}
+
+void CommandBuffer::draw(const Shader& Program, const Model& Model, const glm::mat4& Transform, const GLenum CullFace)
+{
+	for (const Mesh& Mesh : Model.getMeshes())
+	{
+		const GLuint Texture = Mesh.Textures.empty() ? 0 : Mesh.Textures[0].Id;
+		draw(Program, Texture, Mesh.getGeometry(), Transform, CullFace);
+	}
+}
+
+void CommandBuffer::reset()
+{
+	MMemory.reset();
+	MChunks.clear();
+	MSize = 0;
+}
+
+size_t CommandBuffer::size() const
+{
+	return MSize;
+}
+
+size_t CommandBuffer::getMemoryBytes() const
+{
+	return MMemory.getReservedBytes();
+}
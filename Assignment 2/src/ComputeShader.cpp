@@ -0,0 +1,87 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : ComputeShader.cpp
+Description : Implementations for ComputeShader class
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "ComputeShader.h"
+
+#include "GLStateCache.h"
+#include "ShaderCache.h"
+
+ComputeShader::ComputeShader(const char* ComputePath, const std::string& Defines)
+{
+	Id = ShaderCache::getInstance().acquireComputeProgram(ComputePath, Defines);
+}
+
+void ComputeShader::use() const
+{
+	GLStateCache::getInstance().useProgram(Id);
+}
+
+void ComputeShader::dispatch(const GLuint GroupsX, const GLuint GroupsY, const GLuint GroupsZ) const
+{
+	glDispatchCompute(GroupsX, GroupsY, GroupsZ);
+}
+
+void ComputeShader::setInt(const std::string& Name, const int Value) const
+{
+	glUniform1i(glGetUniformLocation(Id, Name.c_str()), Value);
+}
+
+void ComputeShader::setUInt(const std::string& Name, const unsigned int Value) const
+{
+	glUniform1ui(glGetUniformLocation(Id, Name.c_str()), Value);
+}
+
+void ComputeShader::setFloat(const std::string& Name, const float Value) const
+{
+	glUniform1f(glGetUniformLocation(Id, Name.c_str()), Value);
+}
+
+void ComputeShader::setVec2(const std::string& Name, const glm::vec2& Value) const
+{
+	glUniform2fv(glGetUniformLocation(Id, Name.c_str()), 1, &Value[0]);
+}
+
+void ComputeShader::setIVec2(const std::string& Name, const glm::ivec2& Value) const
+{
+	glUniform2iv(glGetUniformLocation(Id, Name.c_str()), 1, &Value[0]);
+}
+
+void ComputeShader::setVec3(const std::string& Name, const glm::vec3& Value) const
+{
+	glUniform3fv(glGetUniformLocation(Id, Name.c_str()), 1, &Value[0]);
+}
+
+void ComputeShader::setUVec3(const std::string& Name, const glm::uvec3& Value) const
+{
+	glUniform3uiv(glGetUniformLocation(Id, Name.c_str()), 1, &Value[0]);
+}
+
+void ComputeShader::setVec4(const std::string& Name, const glm::vec4& Value) const
+{
+	glUniform4fv(glGetUniformLocation(Id, Name.c_str()), 1, &Value[0]);
+}
+
+void ComputeShader::setMat4(const std::string& Name, const glm::mat4& Mat) const
+{
+	glUniformMatrix4fv(glGetUniformLocation(Id, Name.c_str()), 1, GL_FALSE, &Mat[0][0]);
+}
+
+void ComputeShader::cleanup()
+{
+	if (Id != 0)
+	{
+		ShaderCache::getInstance().releaseProgram(Id);
+		Id = 0;
+	}
+}
@@ -0,0 +1,217 @@
+#include "DataScene.h"
+#include "GLStateCache.h"
+#include "GpuProfiler.h"
+#include "Profiler.h"
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+
+DataScene::DataScene(Camera& camera, LightManager& lightManager, const std::string& name)
+    : Name(name),
+    LightingShader("resources/shaders/VertexShader.vert", "resources/shaders/FragmentShader.frag"),
+    SkyboxShader("resources/shaders/SkyboxVertexShader.vert", "resources/shaders/SkyboxFragmentShader.frag"),
+    TerrainShader("resources/shaders/TerrainVertexShader.vert", "resources/shaders/TerrainFragmentShader.frag"),
+    LSkybox(ResidencyManager::getInstance().acquireSkybox()),
+    GCamera(camera),
+    GLightManager(lightManager),
+    material(),
+    TerrainNode(InvalidNode)
+{
+    std::cout << Name << " constructor called" << std::endl;
+    if (!loadDescription()) {
+        return;
+    }
+
+    // Models and terrain are acquired here like the hand-written scenes acquire theirs; the
+    // models that are not resident yet load in parallel. Batching reads their CPU geometry.
+    CpuGeometryPolicy Policy = usesStaticBatching() ? CpuGeometryPolicy::Keep : CpuGeometryPolicy::Release;
+    std::vector<ModelRequest> Requests;
+    for (const SceneModelRecord& Record : Description.getModels()) {
+        Requests.push_back({ Description.getString(Record.Path), Description.getString(Record.Texture), Policy });
+    }
+    Models = ResidencyManager::getInstance().acquireModels(Requests);
+
+    if (const SceneTerrainRecord* Record = Description.getTerrain()) {
+        SceneTerrain = ResidencyManager::getInstance().acquireTerrain(HeightMapInfo{ Description.getString(Record->HeightMap), Record->Width, Record->Depth, Record->CellSpacing });
+    }
+}
+
+bool DataScene::usesStaticBatching() const {
+    return Description.isLoaded() && (Description.getHeader().Flags & SceneStaticBatching) != 0;
+}
+
+bool DataScene::loadDescription() {
+    namespace fs = std::filesystem;
+    const fs::path TextPath = fs::path("resources/scenes") / (Name + ".scene");
+    const fs::path BinaryPath = fs::path("cache/scenes") / (Name + ".bin");
+
+    // Recompile when the text has been edited since the binary was written
+    std::error_code Error;
+    bool Stale = !fs::exists(BinaryPath, Error) ||
+        (fs::exists(TextPath, Error) && fs::last_write_time(TextPath, Error) > fs::last_write_time(BinaryPath, Error));
+    if (Stale) {
+        fs::create_directories(BinaryPath.parent_path(), Error);
+        if (!SceneDescription::compile(TextPath.string(), BinaryPath.string())) {
+            std::cerr << "Failed to compile scene description " << TextPath.string() << std::endl;
+            return false;
+        }
+    }
+
+    auto Start = std::chrono::steady_clock::now();
+    if (!Description.loadBinary(BinaryPath.string())) {
+        return false;
+    }
+    double Ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+    std::cout << Name << ": loaded " << BinaryPath.string() << " (" << Description.getEntities().size() << " entities) in " << Ms << " ms" << std::endl;
+    return true;
+}
+
+void DataScene::load() {
+    std::cout << "Loading resources for " << Name << "..." << std::endl;
+    // Initialize lighting, then take the point lights from the description
+    GLightManager.initialize();
+
+    // Set material properties
+    material.Ambient = glm::vec3(1.0f, 1.0f, 1.0f);
+    material.Diffuse = glm::vec3(1.0f, 1.0f, 1.0f);
+    material.Specular = glm::vec3(0.5f, 0.5f, 0.5f);
+    material.Shininess = 32.0f;
+
+    World.clear();
+    Batches.clear();
+    if (!Description.isLoaded()) {
+        return;
+    }
+
+    std::vector<PointLight>& Lights = GLightManager.getPointLights();
+    if (Lights.size() < Description.getLights().size()) {
+        Lights.resize(Description.getLights().size());
+    }
+    for (size_t I = 0; I < Description.getLights().size(); I++) {
+        const SceneLightRecord& Light = Description.getLights()[I];
+        Lights[I] = { glm::vec3(0.0f), glm::vec3(Light.Colour[0], Light.Colour[1], Light.Colour[2]), Light.Constant, Light.Linear, Light.Quadratic };
+    }
+
+    // Terrain is its own root; groups are stored parents first, so their nodes can be created in order
+    World.reserve(Description.getGroups().size() + Description.getEntities().size() + 1);
+    if (const SceneTerrainRecord* Record = Description.getTerrain()) {
+        TerrainNode = World.createGroup(InvalidNode, glm::vec3(0.0f), glm::vec3(Record->Scale[0], Record->Scale[1], Record->Scale[2]));
+    }
+
+    std::vector<NodeId> Groups;
+    Groups.reserve(Description.getGroups().size());
+    for (const SceneGroupRecord& Group : Description.getGroups()) {
+        NodeId Parent = Group.Parent == SceneNoParent ? InvalidNode : Groups[Group.Parent];
+        Groups.push_back(World.createGroup(Parent, glm::vec3(Group.Position[0], Group.Position[1], Group.Position[2]),
+            glm::vec3(Group.Scale[0], Group.Scale[1], Group.Scale[2])));
+    }
+
+    for (const SceneEntityRecord& Record : Description.getEntities()) {
+        NodeId Parent = Record.Group == SceneNoParent ? InvalidNode : Groups[Record.Group];
+        glm::vec3 Position(Record.Position[0], Record.Position[1], Record.Position[2]);
+        glm::vec3 Scale(Record.Scale[0], Record.Scale[1], Record.Scale[2]);
+
+        Entity Id;
+        if (Record.Model == SceneNoModel) {
+            // A light without a marker only needs a transform
+            Id = World.createEntity(Parent, Position, Scale, BoundingSphere{});
+        }
+        else {
+            Id = addEntity(World, *Models[Record.Model], Parent, Position, Scale, (Record.Flags & SceneEntityTextured) != 0);
+            World.getRegistry().get<RenderableComponent>(Id).SolidColour = glm::vec3(Record.Colour[0], Record.Colour[1], Record.Colour[2]);
+        }
+
+        if (Record.Light >= 0) {
+            World.getRegistry().add(Id, PointLightComponent{ static_cast<uint32_t>(Record.Light) });
+        }
+    }
+
+    World.updateTransforms();
+    World.updateLights(Lights);
+    std::cout << Name << ": " << World.getRegistry().getEntityCount() << " entities" << std::endl;
+
+    // Nothing moves after load, so the textured entities can be merged once into world-space batches
+    if (usesStaticBatching()) {
+        World.getRegistry().each<RenderableComponent>([this](Entity Id, const RenderableComponent& Renderable) {
+            if (Renderable.Textured) {
+                Batches.add(*Renderable.Source, World.getWorld(Id));
+            }
+        });
+        if (Batches.build()) {
+            Batches.upload();
+        }
+        Batches.printStats(Name);
+    }
+}
+
+void DataScene::update(float deltaTime) {
+    PROFILE_ZONE("DataScene::update");
+    // Nothing moves after load, so the transforms return straight away; the lights are
+    // copied every frame because the light manager can be reset by another scene
+    World.updateTransforms();
+    World.updateLights(GLightManager.getPointLights());
+}
+
+void DataScene::render() {
+    PROFILE_ZONE("DataScene::render");
+    // Clear the screen
+    const float* Clear = Description.isLoaded() ? Description.getHeader().ClearColour : nullptr;
+    glClearColor(Clear ? Clear[0] : 0.1f, Clear ? Clear[1] : 0.1f, Clear ? Clear[2] : 0.1f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    if (SceneTerrain) {
+        PROFILE_GPU("Terrain");
+        TerrainShader.use();
+        TerrainShader.setMat4("view", GCamera.getViewMatrix());
+        TerrainShader.setMat4("projection", GCamera.getProjectionMatrix(800, 600));
+        TerrainShader.setMat4("model", World.getGraph().getWorld(TerrainNode));
+        SceneTerrain->DrawTerrain();
+        GLStateCache::getInstance().setCullFace(GL_BACK);
+    }
+
+    // Set spotlight properties based on camera position and direction
+    GLightManager.setSpotLightPosition(GCamera.VPosition);
+    GLightManager.setSpotLightDirection(GCamera.VFront);
+
+    // Textured entities that are inside the view frustum
+    {
+        PROFILE_GPU("Textured models");
+        bindLightingShader(LightingShader, GCamera, GLightManager, material, true);
+        if (Batches.isUploaded()) {
+            // The entities are still culled for the solid pass below
+            Frustum View = GCamera.getFrustum(800, 600);
+            World.cull(View);
+            Batches.draw(LightingShader, View);
+            showCullingStats(Batches.getCullingStats().LastVisible, Batches.getCullingStats().LastCulled);
+        }
+        else {
+            drawVisibleEntities(LightingShader, World, GCamera);
+        }
+    }
+
+    // Solid entities, including the point light spheres
+    {
+        PROFILE_GPU("Light spheres");
+        bindLightingShader(LightingShader, GCamera, GLightManager, material, false);
+        drawSolidEntities(LightingShader, World, GLightManager);
+    }
+
+    LightingShader.flushVariantTiming();
+
+    // Render skybox
+    LSkybox->render(SkyboxShader, GCamera, 800, 600);
+}
+
+void DataScene::cleanup() {
+    std::cout << "Cleaning up " << Name << " resources..." << std::endl;
+    LightingShader.printVariantTimings();
+    World.getCuller().printStats(Name);
+    Batches.clear();
+
+    // Release shaders (the shader cache keeps the programs for the next scene)
+    LightingShader.cleanup();
+    SkyboxShader.cleanup();
+    TerrainShader.cleanup();
+
+    // Models, skybox and terrain stay resident for the next scene until the residency manager evicts them
+}
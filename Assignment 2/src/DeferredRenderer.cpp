@@ -0,0 +1,249 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : DeferredRenderer.cpp
+Description : Implementations for DeferredRenderer class
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "DeferredRenderer.h"
+
+#include "GLStateCache.h"
+
+#include <iostream>
+
+namespace
+{
+	// Sphere_LowPoly has radius 0.5 but its faces sit closer; 2.4x keeps the light's sphere inside
+	constexpr float LightVolumeScale = 2.4f;
+
+	GLuint createTarget(const GLenum InternalFormat, const int Width, const int Height)
+	{
+		GLuint Texture;
+		glGenTextures(1, &Texture);
+		glBindTexture(GL_TEXTURE_2D, Texture);
+		glTexStorage2D(GL_TEXTURE_2D, 1, InternalFormat, Width, Height);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		return Texture;
+	}
+
+	void checkFramebuffer(const char* Name)
+	{
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+			std::cerr << "ERROR::FRAMEBUFFER::" << Name << "_INCOMPLETE" << '\n';
+	}
+}
+
+DeferredRenderer::DeferredRenderer()
+	: MGeometryShader("resources/shaders/VertexShader.vert", "resources/shaders/GBuffer.frag"),
+	  MDirectionalShader("resources/shaders/FullScreen.vert", "resources/shaders/DeferredDirectional.frag"),
+	  MPointLightShader("resources/shaders/DeferredPointLight.vert", "resources/shaders/DeferredPointLight.frag"),
+	  MPresentShader("resources/shaders/FullScreen.vert", "resources/shaders/DeferredPresent.frag"),
+	  MGBuffer(0), MAlbedoSpecular(0), MNormalShininess(0), MDepth(0),
+	  MLitBuffer(0), MLitColour(0), MLitDepth(0), MWidth(0), MHeight(0)
+{
+	// Full-screen passes generate their triangle from gl_VertexID, but core profile still needs a VAO
+	glGenVertexArrays(1, &MEmptyVao);
+}
+
+void DeferredRenderer::beginGeometryPass(const int Width, const int Height)
+{
+	resize(Width, Height);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, MGBuffer);
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+void DeferredRenderer::bindGeometryShader(const Camera& Camera, const Material& Material, const bool Textured)
+{
+	ShaderVariant Variant;
+	Variant.HasTexture = Textured;
+	MGeometryShader.selectVariant(Variant);
+	MGeometryShader.use();
+	MGeometryShader.setMat4("view", Camera.getViewMatrix());
+	MGeometryShader.setMat4("projection", Camera.getProjectionMatrix(static_cast<float>(MWidth), static_cast<float>(MHeight)));
+	MGeometryShader.setMaterial(Material);
+}
+
+void DeferredRenderer::lightingPass(const Camera& Camera, const LightManager& LightManager, const GLuint LightBuffer,
+                                    const unsigned int LightCount, const Model& LightVolume)
+{
+	const glm::mat4 View = Camera.getViewMatrix();
+	const glm::mat4 Projection = Camera.getProjectionMatrix(static_cast<float>(MWidth), static_cast<float>(MHeight));
+	const glm::mat4 InverseViewProjection = glm::inverse(Projection * View);
+
+	// The lit target gets its own copy of the scene depth so light volumes and the skybox can
+	// depth test against it while the G-buffer depth is being sampled
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, MGBuffer);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, MLitBuffer);
+	glBlitFramebuffer(0, 0, MWidth, MHeight, 0, 0, MWidth, MHeight, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+	glBindFramebuffer(GL_FRAMEBUFFER, MLitBuffer);
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	GLStateCache& State = GLStateCache::getInstance();
+	State.bindTexture(0, GL_TEXTURE_2D, MAlbedoSpecular);
+	State.bindTexture(1, GL_TEXTURE_2D, MNormalShininess);
+	State.bindTexture(2, GL_TEXTURE_2D, MDepth);
+
+	// 1. Directional and spot light over every covered pixel
+	ShaderVariant Variant = LightManager.getShaderVariant(false);
+	Variant.PointLights = PointLightPath::Uniforms;
+	Variant.NumPointLights = 0;
+	MDirectionalShader.selectVariant(Variant);
+	MDirectionalShader.use();
+	MDirectionalShader.setInt("gAlbedoSpecular", 0);
+	MDirectionalShader.setInt("gNormalShininess", 1);
+	MDirectionalShader.setInt("gDepth", 2);
+	MDirectionalShader.setMat4("inverseViewProjection", InverseViewProjection);
+	MDirectionalShader.setVec3("viewPos", Camera.VPosition);
+	LightManager.updateLighting(MDirectionalShader);
+
+	glDisable(GL_DEPTH_TEST);
+	State.bindVertexArray(MEmptyVao);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	State.recordDraw();
+	MDirectionalShader.flushVariantTiming();
+
+	// 2. Point lights: back faces of each light's sphere, drawn where scene depth is in front of
+	// them, so only pixels inside or in front of the volume are shaded and the camera may be inside
+	if (LightManager.isPointLightsOn() && LightCount > 0)
+	{
+		MPointLightShader.use();
+		MPointLightShader.setInt("gAlbedoSpecular", 0);
+		MPointLightShader.setInt("gNormalShininess", 1);
+		MPointLightShader.setInt("gDepth", 2);
+		MPointLightShader.setMat4("view", View);
+		MPointLightShader.setMat4("projection", Projection);
+		MPointLightShader.setMat4("inverseViewProjection", InverseViewProjection);
+		MPointLightShader.setVec2("screenSize", glm::vec2(MWidth, MHeight));
+		MPointLightShader.setVec3("viewPos", Camera.VPosition);
+		MPointLightShader.setFloat("volumeScale", LightVolumeScale);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, LightBuffer);
+
+		glEnable(GL_DEPTH_TEST);
+		glDepthFunc(GL_GEQUAL);
+		glDepthMask(GL_FALSE);
+		glEnable(GL_CULL_FACE);
+		State.setCullFace(GL_FRONT);
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_ONE, GL_ONE);
+
+		LightVolume.drawInstanced(static_cast<GLsizei>(LightCount));
+
+		glDisable(GL_BLEND);
+		State.setCullFace(GL_BACK);
+		glDisable(GL_CULL_FACE);
+		glDepthMask(GL_TRUE);
+		glDepthFunc(GL_LESS);
+	}
+
+	glEnable(GL_DEPTH_TEST);
+}
+
+void DeferredRenderer::present() const
+{
+	// A draw rather than a blit, since the window's framebuffer is multisampled
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glDisable(GL_DEPTH_TEST);
+
+	MPresentShader.use();
+	MPresentShader.setInt("litImage", 0);
+	GLStateCache& State = GLStateCache::getInstance();
+	State.bindTexture(0, GL_TEXTURE_2D, MLitColour);
+
+	State.bindVertexArray(MEmptyVao);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	State.recordDraw();
+
+	glEnable(GL_DEPTH_TEST);
+}
+
+void DeferredRenderer::cleanup()
+{
+	deleteTargets();
+
+	if (MEmptyVao != 0)
+	{
+		glDeleteVertexArrays(1, &MEmptyVao);
+		MEmptyVao = 0;
+	}
+
+	MGeometryShader.printVariantTimings();
+	MDirectionalShader.printVariantTimings();
+
+	MGeometryShader.cleanup();
+	MDirectionalShader.cleanup();
+	MPointLightShader.cleanup();
+	MPresentShader.cleanup();
+}
+
+Shader& DeferredRenderer::getGeometryShader()
+{
+	return MGeometryShader;
+}
+
+void DeferredRenderer::resize(const int Width, const int Height)
+{
+	if (Width == MWidth && Height == MHeight && MGBuffer != 0)
+		return;
+
+	deleteTargets();
+	MWidth = Width;
+	MHeight = Height;
+
+	// G-buffer: albedo + specular strength (RGBA8), normal + shininess (RGBA16F), depth
+	MAlbedoSpecular = createTarget(GL_RGBA8, Width, Height);
+	MNormalShininess = createTarget(GL_RGBA16F, Width, Height);
+	MDepth = createTarget(GL_DEPTH_COMPONENT32F, Width, Height);
+
+	glGenFramebuffers(1, &MGBuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, MGBuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, MAlbedoSpecular, 0);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, MNormalShininess, 0);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, MDepth, 0);
+	constexpr GLenum Attachments[] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+	glDrawBuffers(2, Attachments);
+	checkFramebuffer("GBUFFER");
+
+	// Lit target: HDR colour so many overlapping lights can accumulate without clamping early
+	MLitColour = createTarget(GL_RGBA16F, Width, Height);
+	MLitDepth = createTarget(GL_DEPTH_COMPONENT32F, Width, Height);
+
+	glGenFramebuffers(1, &MLitBuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, MLitBuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, MLitColour, 0);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, MLitDepth, 0);
+	checkFramebuffer("LIT");
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	// Texture creation bound state behind the cache's back
+	GLStateCache::getInstance().invalidate();
+}
+
+void DeferredRenderer::deleteTargets()
+{
+	if (MGBuffer != 0)
+	{
+		glDeleteFramebuffers(1, &MGBuffer);
+		glDeleteFramebuffers(1, &MLitBuffer);
+		const GLuint Textures[] = {MAlbedoSpecular, MNormalShininess, MDepth, MLitColour, MLitDepth};
+		glDeleteTextures(5, Textures);
+	}
+
+	MGBuffer = MAlbedoSpecular = MNormalShininess = MDepth = 0;
+	MLitBuffer = MLitColour = MLitDepth = 0;
+	MWidth = MHeight = 0;
+}
@@ -0,0 +1,81 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : EntityRegistry.cpp
+Description : Implementations for EntityRegistry class
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "EntityRegistry.h"
+
+#include <iostream>
+
+Entity EntityRegistry::create()
+{
+	uint32_t Index;
+	if (!MFreeIndices.empty())
+	{
+		Index = MFreeIndices.back();
+		MFreeIndices.pop_back();
+	}
+	else
+	{
+		Index = static_cast<uint32_t>(MGenerations.size());
+		if (Index > EntityIndexMask)
+		{
+			std::cerr << "EntityRegistry: out of entity ids" << '\n';
+			return NullEntity;
+		}
+		MGenerations.push_back(0);
+	}
+
+	MAliveCount++;
+	return (static_cast<uint32_t>(MGenerations[Index]) << EntityIndexBits) | Index;
+}
+
+void EntityRegistry::destroy(const Entity Id)
+{
+	if (!isAlive(Id))
+		return;
+
+	for (const std::unique_ptr<ComponentPoolBase>& Pool : MPools)
+	{
+		if (Pool)
+			Pool->remove(Id);
+	}
+
+	const uint32_t Index = entityIndex(Id);
+	MGenerations[Index]++;
+	MFreeIndices.push_back(Index);
+	MAliveCount--;
+}
+
+void EntityRegistry::clear()
+{
+	for (const std::unique_ptr<ComponentPoolBase>& Pool : MPools)
+	{
+		if (Pool)
+			Pool->clear();
+	}
+
+	MGenerations.clear();
+	MFreeIndices.clear();
+	MAliveCount = 0;
+}
+
+bool EntityRegistry::isAlive(const Entity Id) const
+{
+	const uint32_t Index = entityIndex(Id);
+	return Id != NullEntity && Index < MGenerations.size() && MGenerations[Index] == entityGeneration(Id);
+}
+
+size_t EntityRegistry::getEntityCount() const
+{
+	return MAliveCount;
+}
@@ -0,0 +1,130 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : EntityWorld.cpp
+Description : Implementations for EntityWorld class
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "EntityWorld.h"
+
+#include "LightManager.h"
+#include "Profiler.h"
+
+void EntityWorld::clear()
+{
+	MRegistry.clear();
+	MGraph.clear();
+	MCuller.clear();
+	MVisible.clear();
+	MBoundsDirty = false;
+}
+
+void EntityWorld::reserve(const size_t Count)
+{
+	MGraph.reserve(Count);
+	MRegistry.getPool<TransformComponent>().reserve(Count);
+	MRegistry.getPool<BoundsComponent>().reserve(Count);
+}
+
+NodeId EntityWorld::createGroup(const NodeId Parent, const glm::vec3& Position, const glm::vec3& Scale)
+{
+	return MGraph.createNode(Parent, Position, glm::quat(1.0f, 0.0f, 0.0f, 0.0f), Scale);
+}
+
+Entity EntityWorld::createEntity(const NodeId Parent, const glm::vec3& Position, const glm::vec3& Scale, const BoundingSphere& LocalBounds)
+{
+	const Entity Id = MRegistry.create();
+	if (Id == NullEntity)
+		return NullEntity;
+
+	MRegistry.add(Id, TransformComponent{createGroup(Parent, Position, Scale)});
+	MRegistry.add(Id, BoundsComponent{LocalBounds, LocalBounds});
+	MBoundsDirty = true;
+	return Id;
+}
+
+unsigned int EntityWorld::updateTransforms()
+{
+	PROFILE_ZONE("EntityWorld::updateTransforms");
+	const unsigned int Updated = MGraph.update();
+
+	ComponentPool<BoundsComponent>& Bounds = MRegistry.getPool<BoundsComponent>();
+	const bool Resized = MCuller.getCount() != Bounds.size();
+	if (Updated == 0 && !MBoundsDirty && !Resized)
+		return 0;
+
+	// Something moved: one linear pass over the packed bounds, with the culler slots kept in
+	// the same order as the dense array so cull() maps a visible slot straight to its entity
+	ComponentPool<TransformComponent>& Transforms = MRegistry.getPool<TransformComponent>();
+	const std::vector<Entity>& Entities = Bounds.getEntities();
+	std::vector<BoundsComponent>& Spheres = Bounds.getComponents();
+	if (Resized)
+		MCuller.clear();
+
+	for (size_t Slot = 0; Slot < Entities.size(); Slot++)
+	{
+		BoundsComponent& Sphere = Spheres[Slot];
+		if (const TransformComponent* Transform = Transforms.tryGet(Entities[Slot]))
+			Sphere.World = Sphere.Local.transformed(MGraph.getWorld(Transform->Node));
+
+		if (Resized)
+			MCuller.add(Sphere.World);
+		else
+			MCuller.update(static_cast<uint32_t>(Slot), Sphere.World);
+	}
+
+	MBoundsDirty = false;
+	return Updated;
+}
+
+void EntityWorld::updateLights(std::vector<PointLight>& Lights)
+{
+	MRegistry.each<PointLightComponent, TransformComponent>([&](Entity, const PointLightComponent& Light, const TransformComponent& Transform)
+	{
+		if (Light.LightIndex < Lights.size())
+			Lights[Light.LightIndex].Position = glm::vec3(MGraph.getWorld(Transform.Node)[3]);
+	});
+}
+
+const std::vector<Entity>& EntityWorld::cull(const Frustum& Frustum)
+{
+	const std::vector<Entity>& Entities = MRegistry.getPool<BoundsComponent>().getEntities();
+	const std::vector<uint32_t>& Slots = MCuller.cull(Frustum);
+
+	MVisible.resize(Slots.size());
+	for (size_t I = 0; I < Slots.size(); I++)
+		MVisible[I] = Entities[Slots[I]];
+	return MVisible;
+}
+
+const std::vector<Entity>& EntityWorld::getVisible() const
+{
+	return MVisible;
+}
+
+const glm::mat4& EntityWorld::getWorld(const Entity Id)
+{
+	return MGraph.getWorld(MRegistry.get<TransformComponent>(Id).Node);
+}
+
+EntityRegistry& EntityWorld::getRegistry()
+{
+	return MRegistry;
+}
+
+SceneGraph& EntityWorld::getGraph()
+{
+	return MGraph;
+}
+
+const FrustumCuller& EntityWorld::getCuller() const
+{
+	return MCuller;
+}
@@ -0,0 +1,227 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : FrustumCulling.cpp
+Description : Implementations for batched SIMD frustum culling of bounding spheres
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "FrustumCulling.h"
+
+#include <immintrin.h>
+#include <iostream>
+
+namespace
+{
+	// Writes the index of every set bit in Mask, offset by Base
+	size_t appendVisible(unsigned int Mask, const uint32_t Base, uint32_t* Visible)
+	{
+		size_t Written = 0;
+		while (Mask != 0)
+		{
+			unsigned long Bit = 0;
+#ifdef _MSC_VER
+			_BitScanForward(&Bit, Mask);
+#else
+			Bit = static_cast<unsigned long>(__builtin_ctz(Mask));
+#endif
+			Visible[Written++] = Base + static_cast<uint32_t>(Bit);
+			Mask &= Mask - 1;
+		}
+		return Written;
+	}
+}
+
+size_t cullSpheresScalar(const Frustum& Frustum, const float* X, const float* Y, const float* Z, const float* Radius,
+                         const size_t Count, uint32_t* Visible)
+{
+	size_t VisibleCount = 0;
+	for (size_t I = 0; I < Count; I++)
+	{
+		bool Inside = true;
+		for (const glm::vec4& Plane : Frustum.Planes)
+		{
+			if (Plane.x * X[I] + Plane.y * Y[I] + Plane.z * Z[I] + Plane.w < -Radius[I])
+			{
+				Inside = false;
+				break;
+			}
+		}
+		if (Inside)
+			Visible[VisibleCount++] = static_cast<uint32_t>(I);
+	}
+	return VisibleCount;
+}
+
+size_t cullSpheresSse(const Frustum& Frustum, const float* X, const float* Y, const float* Z, const float* Radius,
+                      const size_t Count, uint32_t* Visible)
+{
+	__m128 PlaneX[6], PlaneY[6], PlaneZ[6], PlaneW[6];
+	for (int P = 0; P < 6; P++)
+	{
+		PlaneX[P] = _mm_set1_ps(Frustum.Planes[P].x);
+		PlaneY[P] = _mm_set1_ps(Frustum.Planes[P].y);
+		PlaneZ[P] = _mm_set1_ps(Frustum.Planes[P].z);
+		PlaneW[P] = _mm_set1_ps(Frustum.Planes[P].w);
+	}
+
+	size_t VisibleCount = 0;
+	size_t I = 0;
+	for (; I + 4 <= Count; I += 4)
+	{
+		const __m128 SphereX = _mm_loadu_ps(X + I);
+		const __m128 SphereY = _mm_loadu_ps(Y + I);
+		const __m128 SphereZ = _mm_loadu_ps(Z + I);
+		const __m128 NegativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(Radius + I));
+
+		// A sphere survives a plane when its signed distance is at least -radius
+		__m128 Inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (int P = 0; P < 6; P++)
+		{
+			__m128 Distance = _mm_add_ps(_mm_mul_ps(PlaneX[P], SphereX), PlaneW[P]);
+			Distance = _mm_add_ps(_mm_mul_ps(PlaneY[P], SphereY), Distance);
+			Distance = _mm_add_ps(_mm_mul_ps(PlaneZ[P], SphereZ), Distance);
+			Inside = _mm_and_ps(Inside, _mm_cmpge_ps(Distance, NegativeRadius));
+		}
+
+		VisibleCount += appendVisible(static_cast<unsigned int>(_mm_movemask_ps(Inside)), static_cast<uint32_t>(I),
+		                              Visible + VisibleCount);
+	}
+
+	// Remainder that does not fill a register
+	const size_t Tail = cullSpheresScalar(Frustum, X + I, Y + I, Z + I, Radius + I, Count - I, Visible + VisibleCount);
+	for (size_t T = 0; T < Tail; T++)
+	{
+		Visible[VisibleCount + T] += static_cast<uint32_t>(I);
+	}
+	return VisibleCount + Tail;
+}
+
+#ifdef __AVX__
+size_t cullSpheresAvx(const Frustum& Frustum, const float* X, const float* Y, const float* Z, const float* Radius,
+                      const size_t Count, uint32_t* Visible)
+{
+	__m256 PlaneX[6], PlaneY[6], PlaneZ[6], PlaneW[6];
+	for (int P = 0; P < 6; P++)
+	{
+		PlaneX[P] = _mm256_set1_ps(Frustum.Planes[P].x);
+		PlaneY[P] = _mm256_set1_ps(Frustum.Planes[P].y);
+		PlaneZ[P] = _mm256_set1_ps(Frustum.Planes[P].z);
+		PlaneW[P] = _mm256_set1_ps(Frustum.Planes[P].w);
+	}
+
+	size_t VisibleCount = 0;
+	size_t I = 0;
+	for (; I + 8 <= Count; I += 8)
+	{
+		const __m256 SphereX = _mm256_loadu_ps(X + I);
+		const __m256 SphereY = _mm256_loadu_ps(Y + I);
+		const __m256 SphereZ = _mm256_loadu_ps(Z + I);
+		const __m256 NegativeRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(Radius + I));
+
+		__m256 Inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (int P = 0; P < 6; P++)
+		{
+			__m256 Distance = _mm256_add_ps(_mm256_mul_ps(PlaneX[P], SphereX), PlaneW[P]);
+			Distance = _mm256_add_ps(_mm256_mul_ps(PlaneY[P], SphereY), Distance);
+			Distance = _mm256_add_ps(_mm256_mul_ps(PlaneZ[P], SphereZ), Distance);
+			Inside = _mm256_and_ps(Inside, _mm256_cmp_ps(Distance, NegativeRadius, _CMP_GE_OQ));
+		}
+
+		VisibleCount += appendVisible(static_cast<unsigned int>(_mm256_movemask_ps(Inside)), static_cast<uint32_t>(I),
+		                              Visible + VisibleCount);
+	}
+
+	// The last 0-7 spheres go through the SSE path
+	const size_t Tail = cullSpheresSse(Frustum, X + I, Y + I, Z + I, Radius + I, Count - I, Visible + VisibleCount);
+	for (size_t T = 0; T < Tail; T++)
+	{
+		Visible[VisibleCount + T] += static_cast<uint32_t>(I);
+	}
+	return VisibleCount + Tail;
+}
+#endif
+
+size_t cullSpheres(const Frustum& Frustum, const float* X, const float* Y, const float* Z, const float* Radius,
+                   const size_t Count, uint32_t* Visible)
+{
+#ifdef __AVX__
+	return cullSpheresAvx(Frustum, X, Y, Z, Radius, Count, Visible);
+#else
+	return cullSpheresSse(Frustum, X, Y, Z, Radius, Count, Visible);
+#endif
+}
+
+void FrustumCuller::clear()
+{
+	MX.clear();
+	MY.clear();
+	MZ.clear();
+	MRadius.clear();
+	MVisible.clear();
+	MStats = {};
+}
+
+uint32_t FrustumCuller::add(const BoundingSphere& Sphere)
+{
+	MX.push_back(Sphere.Centre.x);
+	MY.push_back(Sphere.Centre.y);
+	MZ.push_back(Sphere.Centre.z);
+	MRadius.push_back(Sphere.Radius);
+	return static_cast<uint32_t>(MX.size() - 1);
+}
+
+void FrustumCuller::update(const uint32_t Index, const BoundingSphere& Sphere)
+{
+	MX[Index] = Sphere.Centre.x;
+	MY[Index] = Sphere.Centre.y;
+	MZ[Index] = Sphere.Centre.z;
+	MRadius[Index] = Sphere.Radius;
+}
+
+const std::vector<uint32_t>& FrustumCuller::cull(const Frustum& Frustum)
+{
+	MVisible.resize(MX.size());
+	const size_t VisibleCount = cullSpheres(Frustum, MX.data(), MY.data(), MZ.data(), MRadius.data(), MX.size(),
+	                                        MVisible.data());
+	MVisible.resize(VisibleCount);
+
+	MStats.LastVisible = static_cast<unsigned int>(VisibleCount);
+	MStats.LastCulled = static_cast<unsigned int>(MX.size() - VisibleCount);
+	MStats.Frames++;
+	MStats.TotalVisible += MStats.LastVisible;
+	MStats.TotalCulled += MStats.LastCulled;
+	return MVisible;
+}
+
+const std::vector<uint32_t>& FrustumCuller::getVisible() const
+{
+	return MVisible;
+}
+
+size_t FrustumCuller::getCount() const
+{
+	return MX.size();
+}
+
+const CullingStats& FrustumCuller::getStats() const
+{
+	return MStats;
+}
+
+void FrustumCuller::printStats(const std::string& Label) const
+{
+	if (MStats.Frames == 0)
+		return;
+
+	std::cout << "[Culling] " << Label << ": " << MX.size() << " instances, avg "
+		<< static_cast<double>(MStats.TotalVisible) / MStats.Frames << " visible / "
+		<< static_cast<double>(MStats.TotalCulled) / MStats.Frames << " culled per frame over "
+		<< MStats.Frames << " frames" << '\n';
+}
@@ -0,0 +1,159 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : GLStateCache.cpp
+Description : Implementations for GLStateCache class
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "GLStateCache.h"
+
+#include <glfw3.h>
+#include <iostream>
+
+namespace
+{
+	constexpr double ReportInterval = 2.0;
+}
+
+GLStateCache& GLStateCache::getInstance()
+{
+	static GLStateCache Instance;
+	return Instance;
+}
+
+void GLStateCache::useProgram(const GLuint Program)
+{
+	const bool Skip = MFiltering && MProgram == Program;
+	count(Skip);
+	if (Skip)
+		return;
+
+	glUseProgram(Program);
+	MProgram = Program;
+}
+
+void GLStateCache::bindVertexArray(const GLuint Vao)
+{
+	const bool Skip = MFiltering && MVao == Vao;
+	count(Skip);
+	if (Skip)
+		return;
+
+	glBindVertexArray(Vao);
+	MVao = Vao;
+}
+
+void GLStateCache::bindTexture(const GLuint Unit, const GLenum Target, const GLuint Texture)
+{
+	// Only 2D and cube map bindings are tracked; anything else is always forwarded
+	GLuint* Bound = nullptr;
+	if (Unit < MaxTextureUnits)
+	{
+		if (Target == GL_TEXTURE_2D)
+			Bound = &MUnits[Unit].Texture2D;
+		else if (Target == GL_TEXTURE_CUBE_MAP)
+			Bound = &MUnits[Unit].TextureCube;
+	}
+
+	const bool Skip = MFiltering && Bound != nullptr && *Bound == Texture;
+	count(Skip);
+	if (Skip)
+		return;
+
+	activeTexture(Unit);
+	glBindTexture(Target, Texture);
+	if (Bound != nullptr)
+		*Bound = Texture;
+}
+
+void GLStateCache::setCullFace(const GLenum Face)
+{
+	const bool Skip = MFiltering && MCullFace == Face;
+	count(Skip);
+	if (Skip)
+		return;
+
+	glCullFace(Face);
+	MCullFace = Face;
+}
+
+void GLStateCache::recordDraw()
+{
+	MFrame.Draws++;
+}
+
+void GLStateCache::invalidate()
+{
+	MProgram = MVao = MActiveUnit = Unknown;
+	MCullFace = Unknown;
+	for (TextureUnit& Unit : MUnits)
+		Unit = {};
+}
+
+void GLStateCache::setFiltering(const bool Enabled)
+{
+	MFiltering = Enabled;
+	MTotal = {};
+	MTotalFrames = 0;
+}
+
+bool GLStateCache::isFiltering() const
+{
+	return MFiltering;
+}
+
+void GLStateCache::beginFrame()
+{
+	invalidate();
+	MFrame = {};
+}
+
+void GLStateCache::endFrame()
+{
+	MTotal.Issued += MFrame.Issued;
+	MTotal.Skipped += MFrame.Skipped;
+	MTotal.Draws += MFrame.Draws;
+	MTotalFrames++;
+
+	const double Now = glfwGetTime();
+	if (Now - MLastReport < ReportInterval)
+		return;
+	MLastReport = Now;
+
+	std::cout << "[GLState] " << (MFiltering ? "filtered" : "unfiltered") << ", per frame: "
+		<< MTotal.Issued / MTotalFrames << " state calls issued, " << MTotal.Skipped / MTotalFrames << " skipped, "
+		<< MTotal.Draws / MTotalFrames << " draws" << '\n';
+	MTotal = {};
+	MTotalFrames = 0;
+}
+
+const GLStateCallStats& GLStateCache::getFrameStats() const
+{
+	return MFrame;
+}
+
+void GLStateCache::activeTexture(const GLuint Unit)
+{
+	const bool Skip = MFiltering && MActiveUnit == Unit;
+	count(Skip);
+	if (Skip)
+		return;
+
+	glActiveTexture(GL_TEXTURE0 + Unit);
+	MActiveUnit = Unit;
+}
+
+void GLStateCache::count(const bool Skipped)
+{
+	if (Skipped)
+		MFrame.Skipped++;
+	else
+		MFrame.Issued++;
+}
@@ -0,0 +1,461 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : GeometryArena.cpp
+Description : Implementations for GeometryArena and RangeAllocator classes
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "GeometryArena.h"
+
+#include "GLStateCache.h"
+#include "Mesh.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+
+namespace
+{
+	// 16 MB of vertices and 8 MB of indices, enough for the terrain plus a few models before growing
+	constexpr GLuint InitialVertexCapacity = 1u << 19;
+	constexpr GLuint InitialIndexCapacity = 1u << 21;
+
+	constexpr GLuint VertexBinding = 0;
+
+	double toMegabytes(const size_t Bytes)
+	{
+		return static_cast<double>(Bytes) / (1024.0 * 1024.0);
+	}
+}
+
+void RangeAllocator::reset(const GLuint Capacity, const GLuint Used)
+{
+	MFreeBlocks.clear();
+	MCapacity = Capacity;
+	MUsed = Used;
+	if (Used < Capacity)
+		MFreeBlocks[Used] = Capacity - Used;
+}
+
+void RangeAllocator::grow(const GLuint NewCapacity)
+{
+	if (NewCapacity <= MCapacity)
+		return;
+
+	release(MCapacity, NewCapacity - MCapacity);
+	MUsed += NewCapacity - MCapacity;  // release() counted the new space as freed
+	MCapacity = NewCapacity;
+}
+
+bool RangeAllocator::allocate(const GLuint Count, GLuint& Offset)
+{
+	if (Count == 0)
+	{
+		Offset = 0;
+		return true;
+	}
+
+	for (auto It = MFreeBlocks.begin(); It != MFreeBlocks.end(); ++It)
+	{
+		if (It->second < Count)
+			continue;
+
+		Offset = It->first;
+		const GLuint Remaining = It->second - Count;
+		MFreeBlocks.erase(It);
+		if (Remaining > 0)
+			MFreeBlocks[Offset + Count] = Remaining;
+
+		MUsed += Count;
+		return true;
+	}
+	return false;
+}
+
+void RangeAllocator::release(GLuint Offset, GLuint Count)
+{
+	if (Count == 0)
+		return;
+
+	MUsed -= Count;
+
+	// Merge with the block after, then with the block before
+	const auto Next = MFreeBlocks.find(Offset + Count);
+	if (Next != MFreeBlocks.end())
+	{
+		Count += Next->second;
+		MFreeBlocks.erase(Next);
+	}
+
+	auto Previous = MFreeBlocks.lower_bound(Offset);
+	if (Previous != MFreeBlocks.begin())
+	{
+		--Previous;
+		if (Previous->first + Previous->second == Offset)
+		{
+			Previous->second += Count;
+			return;
+		}
+	}
+
+	MFreeBlocks[Offset] = Count;
+}
+
+GLuint RangeAllocator::getCapacity() const
+{
+	return MCapacity;
+}
+
+GLuint RangeAllocator::getUsed() const
+{
+	return MUsed;
+}
+
+GLuint RangeAllocator::getLargestFree() const
+{
+	GLuint Largest = 0;
+	for (const auto& [Offset, Count] : MFreeBlocks)
+		Largest = std::max(Largest, Count);
+	return Largest;
+}
+
+GLuint RangeAllocator::getTrailingFree() const
+{
+	if (MFreeBlocks.empty())
+		return 0;
+	const auto& [Offset, Count] = *MFreeBlocks.rbegin();
+	return Offset + Count == MCapacity ? Count : 0;
+}
+
+unsigned int RangeAllocator::getFreeBlockCount() const
+{
+	return static_cast<unsigned int>(MFreeBlocks.size());
+}
+
+float RangeAllocator::getFragmentation() const
+{
+	const GLuint Free = MCapacity - MUsed;
+	if (Free == 0)
+		return 0.0f;
+	return 1.0f - static_cast<float>(getLargestFree()) / static_cast<float>(Free);
+}
+
+bool RangeAllocator::isPacked() const
+{
+	if (MFreeBlocks.empty())
+		return true;
+	return MFreeBlocks.size() == 1 && MFreeBlocks.begin()->first == MUsed;
+}
+
+GeometryArena& GeometryArena::getInstance()
+{
+	static GeometryArena Instance;
+	return Instance;
+}
+
+GeometryHandle GeometryArena::allocate(const std::vector<Vertex>& Vertices, const std::vector<unsigned int>& Indices)
+{
+	if (MVao == 0)
+		createBuffers();
+
+	const auto VertexCount = static_cast<GLuint>(Vertices.size());
+	const auto IndexCount = static_cast<GLuint>(Indices.size());
+
+	// When no free block fits, grow until the free space at the end does: the total used is no
+	// guide, since fragmented free space in the middle cannot take the request
+	GLuint BaseVertex = 0;
+	if (!MVertexAllocator.allocate(VertexCount, BaseVertex))
+	{
+		growVertices(MVertexAllocator.getCapacity() - MVertexAllocator.getTrailingFree() + VertexCount);
+		if (!MVertexAllocator.allocate(VertexCount, BaseVertex))
+		{
+			std::cerr << "[GeometryArena] Could not fit " << VertexCount << " vertices after growing" << '\n';
+			return InvalidGeometry;
+		}
+	}
+
+	GLuint FirstIndex = 0;
+	if (!MIndexAllocator.allocate(IndexCount, FirstIndex))
+	{
+		growIndices(MIndexAllocator.getCapacity() - MIndexAllocator.getTrailingFree() + IndexCount);
+		if (!MIndexAllocator.allocate(IndexCount, FirstIndex))
+		{
+			std::cerr << "[GeometryArena] Could not fit " << IndexCount << " indices after growing" << '\n';
+			MVertexAllocator.release(BaseVertex, VertexCount);
+			return InvalidGeometry;
+		}
+	}
+
+	// Upload through the copy target so the element binding of whichever VAO is bound is untouched
+	glBindBuffer(GL_COPY_WRITE_BUFFER, MVertexBuffer);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(BaseVertex) * sizeof(Vertex), Vertices.size() * sizeof(Vertex), Vertices.data());
+	glBindBuffer(GL_COPY_WRITE_BUFFER, MIndexBuffer);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(FirstIndex) * sizeof(unsigned int), Indices.size() * sizeof(unsigned int), Indices.data());
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	GeometrySpan Span;
+	Span.BaseVertex = static_cast<GLint>(BaseVertex);
+	Span.FirstIndex = FirstIndex;
+	Span.IndexCount = static_cast<GLsizei>(IndexCount);
+	Span.VertexCount = VertexCount;
+
+	GeometryHandle Handle;
+	if (!MFreeHandles.empty())
+	{
+		Handle = MFreeHandles.back();
+		MFreeHandles.pop_back();
+		MSpans[Handle] = Span;
+		MLive[Handle] = true;
+	}
+	else
+	{
+		Handle = static_cast<GeometryHandle>(MSpans.size());
+		MSpans.push_back(Span);
+		MLive.push_back(true);
+	}
+	return Handle;
+}
+
+void GeometryArena::release(const GeometryHandle Handle)
+{
+	if (Handle >= MSpans.size() || !MLive[Handle])
+		return;
+
+	const GeometrySpan& Span = MSpans[Handle];
+	MVertexAllocator.release(static_cast<GLuint>(Span.BaseVertex), Span.VertexCount);
+	MIndexAllocator.release(Span.FirstIndex, static_cast<GLuint>(Span.IndexCount));
+
+	MSpans[Handle] = {};
+	MLive[Handle] = false;
+	MFreeHandles.push_back(Handle);
+}
+
+const GeometrySpan& GeometryArena::getSpan(const GeometryHandle Handle) const
+{
+	static const GeometrySpan Empty;
+	if (Handle >= MSpans.size() || !MLive[Handle])
+		return Empty;
+	return MSpans[Handle];
+}
+
+size_t GeometryArena::getByteSize(const GeometryHandle Handle) const
+{
+	const GeometrySpan& Span = getSpan(Handle);
+	return Span.VertexCount * sizeof(Vertex) + static_cast<size_t>(Span.IndexCount) * sizeof(unsigned int);
+}
+
+void GeometryArena::bind() const
+{
+	GLStateCache::getInstance().bindVertexArray(MVao);
+}
+
+void GeometryArena::draw(const GeometryHandle Handle, const GLsizei InstanceCount) const
+{
+	const GeometrySpan& Span = getSpan(Handle);
+	if (Span.IndexCount == 0)
+		return;
+
+	// The arena VAO is left bound; the state cache skips rebinding it for the next draw
+	GLStateCache& State = GLStateCache::getInstance();
+	State.bindVertexArray(MVao);
+	glDrawElementsInstancedBaseVertex(GL_TRIANGLES, Span.IndexCount, GL_UNSIGNED_INT,
+	                                  reinterpret_cast<void*>(static_cast<uintptr_t>(Span.FirstIndex) * sizeof(unsigned int)),
+	                                  InstanceCount, Span.BaseVertex);
+	State.recordDraw();
+}
+
+void GeometryArena::defragment()
+{
+	if (MVao == 0 || (MVertexAllocator.isPacked() && MIndexAllocator.isPacked()))
+		return;
+
+	const GeometryArenaStats Before = getStats();
+
+	std::vector<GeometryHandle> Live;
+	for (GeometryHandle Handle = 0; Handle < MSpans.size(); Handle++)
+	{
+		if (MLive[Handle])
+			Live.push_back(Handle);
+	}
+
+	// Copy every live span to the front of fresh buffers of the same size, keeping their order
+	GLuint NewVertexBuffer = 0;
+	GLuint NewIndexBuffer = 0;
+	glGenBuffers(1, &NewVertexBuffer);
+	glGenBuffers(1, &NewIndexBuffer);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, NewVertexBuffer);
+	glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(MVertexAllocator.getCapacity()) * sizeof(Vertex), nullptr, GL_STATIC_DRAW);
+
+	std::sort(Live.begin(), Live.end(), [this](const GeometryHandle A, const GeometryHandle B) { return MSpans[A].BaseVertex < MSpans[B].BaseVertex; });
+	glBindBuffer(GL_COPY_READ_BUFFER, MVertexBuffer);
+	GLuint PackedVertices = 0;
+	for (const GeometryHandle Handle : Live)
+	{
+		GeometrySpan& Span = MSpans[Handle];
+		if (Span.VertexCount > 0)
+		{
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(Span.BaseVertex) * sizeof(Vertex),
+			                    static_cast<GLintptr>(PackedVertices) * sizeof(Vertex), static_cast<GLsizeiptr>(Span.VertexCount) * sizeof(Vertex));
+		}
+		Span.BaseVertex = static_cast<GLint>(PackedVertices);
+		PackedVertices += Span.VertexCount;
+	}
+
+	// Indices are relative to the base vertex, so they move without being rewritten
+	glBindBuffer(GL_COPY_WRITE_BUFFER, NewIndexBuffer);
+	glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(MIndexAllocator.getCapacity()) * sizeof(unsigned int), nullptr, GL_STATIC_DRAW);
+
+	std::sort(Live.begin(), Live.end(), [this](const GeometryHandle A, const GeometryHandle B) { return MSpans[A].FirstIndex < MSpans[B].FirstIndex; });
+	glBindBuffer(GL_COPY_READ_BUFFER, MIndexBuffer);
+	GLuint PackedIndices = 0;
+	for (const GeometryHandle Handle : Live)
+	{
+		GeometrySpan& Span = MSpans[Handle];
+		if (Span.IndexCount > 0)
+		{
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(Span.FirstIndex) * sizeof(unsigned int),
+			                    static_cast<GLintptr>(PackedIndices) * sizeof(unsigned int), static_cast<GLsizeiptr>(Span.IndexCount) * sizeof(unsigned int));
+		}
+		Span.FirstIndex = PackedIndices;
+		PackedIndices += static_cast<GLuint>(Span.IndexCount);
+	}
+
+	glBindBuffer(GL_COPY_READ_BUFFER, 0);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	glDeleteBuffers(1, &MVertexBuffer);
+	glDeleteBuffers(1, &MIndexBuffer);
+	MVertexBuffer = NewVertexBuffer;
+	MIndexBuffer = NewIndexBuffer;
+	attachBuffers();
+
+	MVertexAllocator.reset(MVertexAllocator.getCapacity(), PackedVertices);
+	MIndexAllocator.reset(MIndexAllocator.getCapacity(), PackedIndices);
+
+	std::cout << "[GeometryArena] Defragmented " << Live.size() << " spans: " << Before.FreeBlocks << " free blocks -> "
+		<< getStats().FreeBlocks << '\n';
+}
+
+void GeometryArena::shutdown()
+{
+	if (MVao == 0)
+		return;
+
+	const GLuint Buffers[] = {MVertexBuffer, MIndexBuffer};
+	glDeleteBuffers(2, Buffers);
+	glDeleteVertexArrays(1, &MVao);
+	MVao = MVertexBuffer = MIndexBuffer = 0;
+
+	MVertexAllocator.reset(0);
+	MIndexAllocator.reset(0);
+	MSpans.clear();
+	MLive.clear();
+	MFreeHandles.clear();
+}
+
+GeometryArenaStats GeometryArena::getStats() const
+{
+	GeometryArenaStats Stats;
+	Stats.Allocations = static_cast<unsigned int>(std::count(MLive.begin(), MLive.end(), true));
+	Stats.VertexBytesUsed = static_cast<size_t>(MVertexAllocator.getUsed()) * sizeof(Vertex);
+	Stats.VertexBytesCapacity = static_cast<size_t>(MVertexAllocator.getCapacity()) * sizeof(Vertex);
+	Stats.IndexBytesUsed = static_cast<size_t>(MIndexAllocator.getUsed()) * sizeof(unsigned int);
+	Stats.IndexBytesCapacity = static_cast<size_t>(MIndexAllocator.getCapacity()) * sizeof(unsigned int);
+	Stats.FreeBlocks = MVertexAllocator.getFreeBlockCount() + MIndexAllocator.getFreeBlockCount();
+	Stats.VertexFragmentation = MVertexAllocator.getFragmentation();
+	Stats.IndexFragmentation = MIndexAllocator.getFragmentation();
+	return Stats;
+}
+
+void GeometryArena::printStats(const char* Label) const
+{
+	const GeometryArenaStats Stats = getStats();
+	std::cout << "[GeometryArena] " << Label << ": " << Stats.Allocations << " spans" << '\n';
+	std::cout << "  vertices : " << toMegabytes(Stats.VertexBytesUsed) << " / " << toMegabytes(Stats.VertexBytesCapacity)
+		<< " MB, fragmentation " << Stats.VertexFragmentation * 100.0f << "%" << '\n';
+	std::cout << "  indices  : " << toMegabytes(Stats.IndexBytesUsed) << " / " << toMegabytes(Stats.IndexBytesCapacity)
+		<< " MB, fragmentation " << Stats.IndexFragmentation * 100.0f << "%" << '\n';
+	std::cout << "  free blocks : " << Stats.FreeBlocks << '\n';
+}
+
+void GeometryArena::createBuffers()
+{
+	glGenVertexArrays(1, &MVao);
+	glGenBuffers(1, &MVertexBuffer);
+	glGenBuffers(1, &MIndexBuffer);
+
+	glBindBuffer(GL_COPY_WRITE_BUFFER, MVertexBuffer);
+	glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(InitialVertexCapacity) * sizeof(Vertex), nullptr, GL_STATIC_DRAW);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, MIndexBuffer);
+	glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(InitialIndexCapacity) * sizeof(unsigned int), nullptr, GL_STATIC_DRAW);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	MVertexAllocator.reset(InitialVertexCapacity);
+	MIndexAllocator.reset(InitialIndexCapacity);
+
+	// The vertex format is described once; only the buffer behind binding 0 ever changes
+	GLStateCache::getInstance().bindVertexArray(MVao);
+	glEnableVertexAttribArray(0);
+	glVertexAttribFormat(0, 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, Position));
+	glVertexAttribBinding(0, VertexBinding);
+	glEnableVertexAttribArray(1);
+	glVertexAttribFormat(1, 3, GL_FLOAT, GL_FALSE, offsetof(Vertex, Normal));
+	glVertexAttribBinding(1, VertexBinding);
+	glEnableVertexAttribArray(2);
+	glVertexAttribFormat(2, 2, GL_FLOAT, GL_FALSE, offsetof(Vertex, TexCoords));
+	glVertexAttribBinding(2, VertexBinding);
+
+	attachBuffers();
+}
+
+void GeometryArena::growVertices(const GLuint MinCapacity)
+{
+	GLuint Capacity = MVertexAllocator.getCapacity();
+	while (Capacity < MinCapacity)
+		Capacity *= 2;
+
+	MVertexBuffer = resizeBuffer(MVertexBuffer, static_cast<size_t>(MVertexAllocator.getCapacity()) * sizeof(Vertex), static_cast<size_t>(Capacity) * sizeof(Vertex));
+	MVertexAllocator.grow(Capacity);
+	attachBuffers();
+	std::cout << "[GeometryArena] Vertex buffer grown to " << toMegabytes(static_cast<size_t>(Capacity) * sizeof(Vertex)) << " MB" << '\n';
+}
+
+void GeometryArena::growIndices(const GLuint MinCapacity)
+{
+	GLuint Capacity = MIndexAllocator.getCapacity();
+	while (Capacity < MinCapacity)
+		Capacity *= 2;
+
+	MIndexBuffer = resizeBuffer(MIndexBuffer, static_cast<size_t>(MIndexAllocator.getCapacity()) * sizeof(unsigned int), static_cast<size_t>(Capacity) * sizeof(unsigned int));
+	MIndexAllocator.grow(Capacity);
+	attachBuffers();
+	std::cout << "[GeometryArena] Index buffer grown to " << toMegabytes(static_cast<size_t>(Capacity) * sizeof(unsigned int)) << " MB" << '\n';
+}
+
+GLuint GeometryArena::resizeBuffer(const GLuint Buffer, const size_t OldBytes, const size_t NewBytes)
+{
+	GLuint Resized = 0;
+	glGenBuffers(1, &Resized);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, Resized);
+	glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(NewBytes), nullptr, GL_STATIC_DRAW);
+	glBindBuffer(GL_COPY_READ_BUFFER, Buffer);
+	glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, static_cast<GLsizeiptr>(OldBytes));
+	glBindBuffer(GL_COPY_READ_BUFFER, 0);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	glDeleteBuffers(1, &Buffer);
+	return Resized;
+}
+
+void GeometryArena::attachBuffers() const
+{
+	GLStateCache::getInstance().bindVertexArray(MVao);
+	glBindVertexBuffer(VertexBinding, MVertexBuffer, 0, sizeof(Vertex));
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, MIndexBuffer);
+}
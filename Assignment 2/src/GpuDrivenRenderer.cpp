@@ -0,0 +1,376 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : GpuDrivenRenderer.cpp
+Description : Implementations for GpuDrivenRenderer class
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "GpuDrivenRenderer.h"
+
+#include "GeometryArena.h"
+#include "GLStateCache.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+namespace
+{
+	// Binding points used by GpuCull.comp and GpuDriven.vert (0-3 belong to the clustered lighting)
+	constexpr GLuint InstanceBinding = 4;
+	constexpr GLuint ModelBinding = 5;
+	constexpr GLuint CommandBinding = 6;
+	constexpr GLuint VisibleBinding = 7;
+	constexpr GLuint CounterBinding = 8;
+
+	constexpr GLuint HiZUnit = 0;
+	constexpr GLuint ImpostorAlbedoUnit = 0;
+	constexpr GLuint ImpostorNormalUnit = 1;
+
+	constexpr unsigned int CullGroupSize = 64;
+
+	// Visible, occluded and impostor instance counters
+	constexpr GLsizeiptr CounterBytes = 3 * sizeof(GLuint);
+
+	// The fade rides in the top 8 bits of a visible entry
+	constexpr size_t MaxInstances = size_t(1) << 24;
+
+	// Impostor distances while impostors are off; no instance is ever this far away
+	constexpr float NeverFade = 1e30f;
+}
+
+GpuDrivenRenderer::GpuDrivenRenderer()
+	: MCullShader("resources/shaders/GpuCull.comp"),
+	  MOcclusionCullShader("resources/shaders/GpuCull.comp", "#define HIZ_OCCLUSION\n"),
+	  MTexture(0), MImpostors(nullptr), MImpostorStart(0.0f), MImpostorEnd(0.0f), MImpostorsEnabled(true),
+	  MReadbackFences(), MReadbackIndex(0), MVisibleCount(0), MOccludedCount(0), MImpostorCount(0)
+{
+	glGenBuffers(1, &MInstanceBuffer);
+	glGenBuffers(1, &MModelBuffer);
+	glGenBuffers(1, &MCommandBuffer);
+	glGenBuffers(1, &MCommandTemplate);
+	glGenBuffers(1, &MVisibleBuffer);
+	glGenBuffers(1, &MCounterBuffer);
+	glGenBuffers(ReadbackLatency, MReadbackBuffers);
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, MCounterBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, CounterBytes, nullptr, GL_DYNAMIC_COPY);
+	for (const GLuint Buffer : MReadbackBuffers)
+	{
+		glBindBuffer(GL_COPY_WRITE_BUFFER, Buffer);
+		glBufferData(GL_COPY_WRITE_BUFFER, CounterBytes, nullptr, GL_STREAM_READ);
+	}
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void GpuDrivenRenderer::clearInstances()
+{
+	MInstances.clear();
+}
+
+void GpuDrivenRenderer::addInstance(const Model& Model, const glm::mat4& Transform)
+{
+	GpuInstance Instance = {};
+	Instance.Transform = Transform;
+	Instance.ModelId = registerModel(Model);
+	MInstances.push_back(Instance);
+}
+
+GLuint GpuDrivenRenderer::registerModel(const Model& Model)
+{
+	if (const auto It = MModelIds.find(&Model); It != MModelIds.end())
+		return It->second;
+
+	const BoundingSphere& Sphere = Model.getBoundingSphere();
+	GpuModelBounds Bounds = {};
+	Bounds.Sphere = glm::vec4(Sphere.Centre, Sphere.Radius);
+	Bounds.FirstCommand = static_cast<GLuint>(MCommands.size());
+	Bounds.ImpostorCommand = NoImpostor;
+
+	// Meshes already share the geometry arena buffers; each mesh becomes one indirect command
+	for (const Mesh& Mesh : Model.getMeshes())
+	{
+		const GeometrySpan& Span = GeometryArena::getInstance().getSpan(Mesh.getGeometry());
+		DrawElementsIndirectCommand Command = {};
+		Command.Count = static_cast<GLuint>(Span.IndexCount);
+		Command.FirstIndex = Span.FirstIndex;
+		Command.BaseVertex = Span.BaseVertex;
+		MCommands.push_back(Command);
+
+		if (MTexture == 0 && !Mesh.Textures.empty())
+			MTexture = Mesh.Textures[0].Id;
+	}
+	Bounds.CommandCount = static_cast<GLuint>(MCommands.size()) - Bounds.FirstCommand;
+
+	const auto Id = static_cast<GLuint>(MModels.size());
+	MModels.push_back(Bounds);
+	MModelIds[&Model] = Id;
+	return Id;
+}
+
+void GpuDrivenRenderer::setImpostors(const ImpostorAtlas* Atlas, const float Start, const float End)
+{
+	MImpostors = Atlas;
+	MImpostorStart = Start;
+	MImpostorEnd = std::max(End, Start + 0.001f);
+}
+
+void GpuDrivenRenderer::setImpostorsEnabled(const bool Enabled)
+{
+	MImpostorsEnabled = Enabled;
+}
+
+void GpuDrivenRenderer::upload()
+{
+	if (MInstances.size() > MaxInstances)
+		std::cerr << "[GpuDriven] " << MInstances.size() << " instances, only the first " << MaxInstances << " can be addressed" << '\n';
+
+	// Each mesh reserves room in the visible list for every instance of its model
+	std::vector<GLuint> InstancesPerModel(MModels.size(), 0);
+	for (const GpuInstance& Instance : MInstances)
+		InstancesPerModel[Instance.ModelId]++;
+
+	GLuint VisibleCapacity = 0;
+	for (size_t ModelId = 0; ModelId < MModels.size(); ModelId++)
+	{
+		const GpuModelBounds& Bounds = MModels[ModelId];
+		for (GLuint Command = Bounds.FirstCommand; Command < Bounds.FirstCommand + Bounds.CommandCount; Command++)
+		{
+			MCommands[Command].InstanceCount = 0;
+			MCommands[Command].BaseInstance = VisibleCapacity;
+			VisibleCapacity += InstancesPerModel[ModelId];
+		}
+	}
+
+	// Impostor commands follow the geometry ones and reserve the same room per model
+	MImpostorCommands.clear();
+	for (const auto& [Source, ModelId] : MModelIds)
+	{
+		GpuModelBounds& Bounds = MModels[ModelId];
+		const int Layer = MImpostors ? MImpostors->getLayer(*Source) : -1;
+		if (Layer < 0)
+		{
+			Bounds.ImpostorCommand = NoImpostor;
+			continue;
+		}
+
+		const GeometrySpan& Span = GeometryArena::getInstance().getSpan(MImpostors->getQuad());
+		DrawElementsIndirectCommand Command = {};
+		Command.Count = static_cast<GLuint>(Span.IndexCount);
+		Command.FirstIndex = Span.FirstIndex;
+		Command.BaseVertex = Span.BaseVertex;
+		Command.BaseInstance = VisibleCapacity;
+		VisibleCapacity += InstancesPerModel[ModelId];
+
+		Bounds.ImpostorCommand = static_cast<GLuint>(MCommands.size() + MImpostorCommands.size());
+		Bounds.ImpostorLayer = static_cast<GLuint>(Layer);
+		MImpostorCommands.push_back(Command);
+	}
+
+	std::vector<DrawElementsIndirectCommand> Commands = MCommands;
+	Commands.insert(Commands.end(), MImpostorCommands.begin(), MImpostorCommands.end());
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, MInstanceBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, MInstances.size() * sizeof(GpuInstance), MInstances.data(), GL_STATIC_DRAW);
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, MModelBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, MModels.size() * sizeof(GpuModelBounds), MModels.data(), GL_STATIC_DRAW);
+
+	// The template holds the commands with zero instances and is copied over the live buffer every frame
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, MCommandTemplate);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, Commands.size() * sizeof(DrawElementsIndirectCommand), Commands.data(), GL_STATIC_DRAW);
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, MCommandBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, Commands.size() * sizeof(DrawElementsIndirectCommand), Commands.data(), GL_DYNAMIC_COPY);
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, MVisibleBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, std::max<GLuint>(VisibleCapacity, 1) * sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	std::cout << "[GpuDriven] " << MInstances.size() << " instances, " << MModels.size() << " models, "
+		<< MCommands.size() << " indirect commands, " << MImpostorCommands.size() << " impostor commands" << '\n';
+}
+
+void GpuDrivenRenderer::cull(const Camera& Camera, const HiZBuffer* Occluders)
+{
+	if (MInstances.empty())
+		return;
+
+	readBackVisibleCount();
+
+	// Reset the instance counts and the counters
+	const auto CommandBytes = static_cast<GLsizeiptr>((MCommands.size() + MImpostorCommands.size()) * sizeof(DrawElementsIndirectCommand));
+	glBindBuffer(GL_COPY_READ_BUFFER, MCommandTemplate);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, MCommandBuffer);
+	glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, CommandBytes);
+
+	constexpr GLuint Zero[3] = {0, 0, 0};
+	glBindBuffer(GL_COPY_WRITE_BUFFER, MCounterBuffer);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, 0, CounterBytes, Zero);
+
+	const ComputeShader& CullShader = Occluders ? MOcclusionCullShader : MCullShader;
+	const Frustum ViewFrustum = Camera.getFrustum(800, 600);
+	CullShader.use();
+	for (int Plane = 0; Plane < 6; Plane++)
+	{
+		CullShader.setVec4("frustumPlanes[" + std::to_string(Plane) + "]", ViewFrustum.Planes[Plane]);
+	}
+	CullShader.setUInt("instanceCount", static_cast<unsigned int>(MInstances.size()));
+
+	const bool Impostors = MImpostorsEnabled && !MImpostorCommands.empty();
+	CullShader.setVec3("cameraPosition", Camera.VPosition);
+	CullShader.setFloat("impostorStart", Impostors ? MImpostorStart : NeverFade);
+	CullShader.setFloat("impostorEnd", Impostors ? MImpostorEnd : 2.0f * NeverFade);
+
+	if (Occluders)
+	{
+		CullShader.setMat4("view", Camera.getViewMatrix());
+		CullShader.setMat4("projection", Camera.getProjectionMatrix(800, 600));
+		CullShader.setFloat("zNear", NearPlane);
+		Occluders->bind(CullShader, HiZUnit);
+	}
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, InstanceBinding, MInstanceBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, ModelBinding, MModelBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CommandBinding, MCommandBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, VisibleBinding, MVisibleBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CounterBinding, MCounterBuffer);
+
+	CullShader.dispatch((static_cast<GLuint>(MInstances.size()) + CullGroupSize - 1) / CullGroupSize);
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+
+	// Queue a copy of this frame's counter for a later, non-blocking read
+	glBindBuffer(GL_COPY_READ_BUFFER, MCounterBuffer);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, MReadbackBuffers[MReadbackIndex]);
+	glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, CounterBytes);
+	MReadbackFences[MReadbackIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	MReadbackIndex = (MReadbackIndex + 1) % ReadbackLatency;
+
+	glBindBuffer(GL_COPY_READ_BUFFER, 0);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void GpuDrivenRenderer::draw(const Shader& Shader) const
+{
+	if (MCommands.empty() || MInstances.empty())
+		return;
+
+	GLStateCache::getInstance().bindTexture(0, GL_TEXTURE_2D, MTexture);
+	Shader.setInt("texture_diffuse1", 0);
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, InstanceBinding, MInstanceBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, VisibleBinding, MVisibleBuffer);
+
+	// One call for the whole population; culled meshes simply have an instance count of zero
+	GeometryArena::getInstance().bind();
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, MCommandBuffer);
+	glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(MCommands.size()), 0);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	GLStateCache::getInstance().recordDraw();
+}
+
+void GpuDrivenRenderer::drawImpostors(const Shader& Shader) const
+{
+	if (MImpostorCommands.empty() || !MImpostorsEnabled || MInstances.empty())
+		return;
+
+	MImpostors->bind(Shader, ImpostorAlbedoUnit, ImpostorNormalUnit);
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, InstanceBinding, MInstanceBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, ModelBinding, MModelBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, VisibleBinding, MVisibleBuffer);
+
+	// The quad commands sit after the geometry commands in the same buffer
+	const auto Offset = static_cast<GLintptr>(MCommands.size() * sizeof(DrawElementsIndirectCommand));
+	GeometryArena::getInstance().bind();
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, MCommandBuffer);
+	glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<const void*>(Offset),
+		static_cast<GLsizei>(MImpostorCommands.size()), 0);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	GLStateCache::getInstance().recordDraw();
+}
+
+void GpuDrivenRenderer::cleanup()
+{
+	MCullShader.cleanup();
+	MOcclusionCullShader.cleanup();
+
+	for (GLsync& Fence : MReadbackFences)
+	{
+		if (Fence != nullptr)
+		{
+			glDeleteSync(Fence);
+			Fence = nullptr;
+		}
+	}
+
+	const GLuint Buffers[] = {
+		MInstanceBuffer, MModelBuffer, MCommandBuffer, MCommandTemplate, MVisibleBuffer, MCounterBuffer
+	};
+	glDeleteBuffers(6, Buffers);
+	glDeleteBuffers(ReadbackLatency, MReadbackBuffers);
+	MInstanceBuffer = MModelBuffer = MCommandBuffer = MCommandTemplate = MVisibleBuffer = MCounterBuffer = 0;
+
+	MModels.clear();
+	MCommands.clear();
+	MImpostorCommands.clear();
+	MInstances.clear();
+	MModelIds.clear();
+	MImpostors = nullptr;
+}
+
+unsigned int GpuDrivenRenderer::getInstanceCount() const
+{
+	return static_cast<unsigned int>(MInstances.size());
+}
+
+unsigned int GpuDrivenRenderer::getCommandCount() const
+{
+	return static_cast<unsigned int>(MCommands.size());
+}
+
+unsigned int GpuDrivenRenderer::getVisibleCount() const
+{
+	return MVisibleCount;
+}
+
+unsigned int GpuDrivenRenderer::getOccludedCount() const
+{
+	return MOccludedCount;
+}
+
+unsigned int GpuDrivenRenderer::getImpostorCount() const
+{
+	return MImpostorCount;
+}
+
+void GpuDrivenRenderer::readBackVisibleCount()
+{
+	// This slot was written ReadbackLatency frames ago; skip it if the GPU has not caught up
+	GLsync& Fence = MReadbackFences[MReadbackIndex];
+	if (Fence == nullptr)
+		return;
+
+	const GLenum Status = glClientWaitSync(Fence, 0, 0);
+	if (Status == GL_ALREADY_SIGNALED || Status == GL_CONDITION_SATISFIED)
+	{
+		glBindBuffer(GL_COPY_READ_BUFFER, MReadbackBuffers[MReadbackIndex]);
+		GLuint Counters[3] = {0, 0, 0};
+		glGetBufferSubData(GL_COPY_READ_BUFFER, 0, CounterBytes, Counters);
+		MVisibleCount = Counters[0];
+		MOccludedCount = Counters[1];
+		MImpostorCount = Counters[2];
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+	}
+	glDeleteSync(Fence);
+	Fence = nullptr;
+}
@@ -0,0 +1,265 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : GpuProfiler.cpp
+Description : Implementations for GpuProfiler class
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "GpuProfiler.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <utility>
+
+namespace
+{
+	const char* const CsvPath = "profiles/gpu_passes.csv";
+
+	double percentile(const std::vector<float>& Sorted, const double Fraction)
+	{
+		const size_t Index = std::min(Sorted.size() - 1, static_cast<size_t>(Fraction * static_cast<double>(Sorted.size())));
+		return Sorted[Index];
+	}
+}
+
+GpuProfiler& GpuProfiler::getInstance()
+{
+	static GpuProfiler Instance;
+	return Instance;
+}
+
+void GpuProfiler::beginFrame()
+{
+	// The slot being reused was submitted FramesInFlight frames ago
+	MCurrent = &MSlots[MFrameIndex % FramesInFlight];
+	if (MCurrent->Pending)
+		resolve(*MCurrent);
+
+	MCurrent->Passes.clear();
+	MCurrent->UsedQueries = 0;
+	MCurrent->Frame = MFrameIndex;
+	MCurrent->Pending = true;
+	MOpenPasses.clear();
+
+	beginPass("Frame");
+}
+
+void GpuProfiler::endFrame()
+{
+	while (!MOpenPasses.empty())
+		endPass();
+
+	MCurrent = nullptr;
+	MFrameIndex++;
+}
+
+void GpuProfiler::beginPass(const char* Name)
+{
+	// Passes issued outside a frame, such as during a scene load, are not timed
+	if (!MCurrent)
+		return;
+
+	const GLuint Query = acquireQuery(*MCurrent);
+	glQueryCounter(Query, GL_TIMESTAMP);
+	MOpenPasses.push_back(MCurrent->Passes.size());
+	MCurrent->Passes.push_back({Name, Query, 0, static_cast<uint32_t>(MOpenPasses.size() - 1)});
+}
+
+void GpuProfiler::endPass()
+{
+	if (!MCurrent || MOpenPasses.empty())
+		return;
+
+	const GLuint Query = acquireQuery(*MCurrent);
+	glQueryCounter(Query, GL_TIMESTAMP);
+	MCurrent->Passes[MOpenPasses.back()].EndQuery = Query;
+	MOpenPasses.pop_back();
+}
+
+void GpuProfiler::setFrameListener(FrameListener Listener)
+{
+	MFrameListener = std::move(Listener);
+}
+
+uint64_t GpuProfiler::getFrameIndex() const
+{
+	return MFrameIndex;
+}
+
+void GpuProfiler::toggleOverlay()
+{
+	MOverlay = !MOverlay;
+	std::cout << "GPU pass overlay " << (MOverlay ? "on" : "off") << '\n';
+	if (!MOverlay)
+		printStats();
+}
+
+bool GpuProfiler::isOverlayEnabled() const
+{
+	return MOverlay;
+}
+
+std::string GpuProfiler::getOverlayText() const
+{
+	std::ostringstream Text;
+	Text << std::fixed << std::setprecision(2) << "GPU ms";
+	for (const GpuPassStats& Stats : getStats())
+	{
+		// Passes of a scene that is no longer active stop receiving samples
+		if (Stats.LastFrame + 2 * FramesInFlight >= MFrameIndex)
+			Text << " | " << Stats.Name << ' ' << Stats.AvgMs;
+	}
+	return Text.str();
+}
+
+std::vector<GpuPassStats> GpuProfiler::getStats() const
+{
+	std::vector<GpuPassStats> Result;
+	Result.reserve(MHistory.size());
+	for (const PassHistory& History : MHistory)
+	{
+		if (History.Samples.empty())
+			continue;
+
+		std::vector<float> Sorted = History.Samples;
+		std::sort(Sorted.begin(), Sorted.end());
+
+		double Total = 0.0;
+		for (const float Ms : Sorted)
+			Total += Ms;
+
+		Result.push_back({History.Name, History.Depth, History.LastFrame, static_cast<unsigned int>(Sorted.size()), Sorted.front(),
+			Total / static_cast<double>(Sorted.size()), percentile(Sorted, 0.95), percentile(Sorted, 0.99)});
+	}
+	return Result;
+}
+
+void GpuProfiler::printStats() const
+{
+	if (MHistory.empty())
+		return;
+
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << "[GpuProfiler] Last " << WindowFrames << " frames per pass, min / avg / p95 / p99 ms ("
+		<< MDroppedFrames << " frames dropped)" << '\n';
+	for (const GpuPassStats& Stats : getStats())
+	{
+		std::cout << "  " << std::string(Stats.Depth * 2, ' ') << Stats.Name << ": " << Stats.MinMs << " / " << Stats.AvgMs
+			<< " / " << Stats.P95Ms << " / " << Stats.P99Ms << " over " << Stats.Samples << " samples" << '\n';
+	}
+	std::cout << std::defaultfloat;
+}
+
+void GpuProfiler::shutdown()
+{
+	printStats();
+
+	for (FrameSlot& Slot : MSlots)
+	{
+		if (!Slot.Queries.empty())
+			glDeleteQueries(static_cast<GLsizei>(Slot.Queries.size()), Slot.Queries.data());
+		Slot = FrameSlot();
+	}
+	MCurrent = nullptr;
+	MOpenPasses.clear();
+	MHistory.clear();
+
+	if (MCsv.is_open())
+		MCsv.close();
+}
+
+GLuint GpuProfiler::acquireQuery(FrameSlot& Slot)
+{
+	// Each slot keeps the queries it has ever needed, so steady frames generate none
+	if (Slot.UsedQueries == Slot.Queries.size())
+	{
+		GLuint Query;
+		glGenQueries(1, &Query);
+		Slot.Queries.push_back(Query);
+	}
+	return Slot.Queries[Slot.UsedQueries++];
+}
+
+void GpuProfiler::resolve(FrameSlot& Slot)
+{
+	Slot.Pending = false;
+	if (Slot.Passes.empty())
+		return;
+
+	// Timestamps complete in submission order, so the frame's last query answers for all of them
+	GLint Available = 0;
+	glGetQueryObjectiv(Slot.Passes.front().EndQuery, GL_QUERY_RESULT_AVAILABLE, &Available);
+	if (!Available)
+	{
+		MDroppedFrames++;
+		return;
+	}
+
+	if (!MCsv.is_open() && !MCsvFailed)
+	{
+		std::error_code Error;
+		std::filesystem::create_directories(std::filesystem::path(CsvPath).parent_path(), Error);
+		MCsv.open(CsvPath);
+		if (!MCsv)
+		{
+			std::cerr << "Failed to open GPU profiler output: " << CsvPath << '\n';
+			MCsvFailed = true;
+		}
+		else
+		{
+			MCsv << "frame,pass,depth,ms" << '\n';
+		}
+	}
+
+	for (const PassQuery& Pass : Slot.Passes)
+	{
+		if (Pass.EndQuery == 0)
+			continue;
+
+		GLuint64 Start, End;
+		glGetQueryObjectui64v(Pass.StartQuery, GL_QUERY_RESULT, &Start);
+		glGetQueryObjectui64v(Pass.EndQuery, GL_QUERY_RESULT, &End);
+		const float Ms = static_cast<float>(static_cast<double>(End - Start) / 1.0e6);
+
+		addSample(Pass, Slot.Frame, Ms);
+		if (Pass.Depth == 0 && MFrameListener)
+			MFrameListener(Slot.Frame, Ms);
+		if (MCsv.is_open())
+			MCsv << Slot.Frame << ',' << Pass.Name << ',' << Pass.Depth << ',' << Ms << '\n';
+	}
+}
+
+void GpuProfiler::addSample(const PassQuery& Pass, const uint64_t Frame, const float Ms)
+{
+	auto It = std::find_if(MHistory.begin(), MHistory.end(), [&Pass](const PassHistory& History)
+	{
+		return History.Depth == Pass.Depth && History.Name == Pass.Name;
+	});
+	if (It == MHistory.end())
+	{
+		MHistory.push_back({Pass.Name, Pass.Depth, {}, 0, 0});
+		MHistory.back().Samples.reserve(WindowFrames);
+		It = MHistory.end() - 1;
+	}
+	It->LastFrame = Frame;
+
+	if (It->Samples.size() < WindowFrames)
+	{
+		It->Samples.push_back(Ms);
+	}
+	else
+	{
+		It->Samples[It->Next] = Ms;
+		It->Next = (It->Next + 1) % WindowFrames;
+	}
+}
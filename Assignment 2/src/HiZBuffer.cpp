@@ -0,0 +1,155 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : HiZBuffer.cpp
+Description : Implementations for HiZBuffer class
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "HiZBuffer.h"
+
+#include "GLStateCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+	constexpr GLuint BuildGroupSize = 8;
+}
+
+HiZBuffer::HiZBuffer()
+	: MDepthShader("resources/shaders/DepthOnly.vert", "resources/shaders/DepthOnly.frag"),
+	  MBuildShader("resources/shaders/HiZBuild.comp"),
+	  MFramebuffer(0), MDepth(0), MPyramid(0), MWidth(0), MHeight(0), MLevels(0), MPreviousFramebuffer(0)
+{
+}
+
+void HiZBuffer::beginOccluderPass(const Camera& Camera, const int Width, const int Height)
+{
+	resize(Width, Height);
+
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &MPreviousFramebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, MFramebuffer);
+	glClear(GL_DEPTH_BUFFER_BIT);
+
+	MDepthShader.use();
+	MDepthShader.setMat4("view", Camera.getViewMatrix());
+	MDepthShader.setMat4("projection", Camera.getProjectionMatrix(800, 600));
+}
+
+const Shader& HiZBuffer::getDepthShader() const
+{
+	return MDepthShader;
+}
+
+void HiZBuffer::endOccluderPass()
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(MPreviousFramebuffer));
+	buildPyramid();
+}
+
+void HiZBuffer::bind(const ComputeShader& Shader, const GLuint Unit) const
+{
+	GLStateCache::getInstance().bindTexture(Unit, GL_TEXTURE_2D, MPyramid);
+
+	Shader.setInt("hiZ", static_cast<int>(Unit));
+	Shader.setVec2("hiZSize", glm::vec2(MWidth, MHeight));
+	Shader.setInt("hiZLevels", MLevels);
+}
+
+void HiZBuffer::cleanup()
+{
+	MDepthShader.cleanup();
+	MBuildShader.cleanup();
+
+	if (MFramebuffer != 0)
+	{
+		glDeleteFramebuffers(1, &MFramebuffer);
+		const GLuint Textures[] = {MDepth, MPyramid};
+		glDeleteTextures(2, Textures);
+	}
+	MFramebuffer = MDepth = MPyramid = 0;
+	MWidth = MHeight = MLevels = 0;
+}
+
+void HiZBuffer::resize(const int Width, const int Height)
+{
+	if (Width == MWidth && Height == MHeight && MFramebuffer != 0)
+		return;
+
+	if (MFramebuffer != 0)
+	{
+		glDeleteFramebuffers(1, &MFramebuffer);
+		const GLuint Textures[] = {MDepth, MPyramid};
+		glDeleteTextures(2, Textures);
+	}
+
+	MWidth = Width;
+	MHeight = Height;
+	MLevels = static_cast<int>(std::floor(std::log2(static_cast<float>(std::max(Width, Height))))) + 1;
+
+	glGenTextures(1, &MDepth);
+	glBindTexture(GL_TEXTURE_2D, MDepth);
+	glTexStorage2D(GL_TEXTURE_2D, 1, GL_DEPTH_COMPONENT32F, Width, Height);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	// Nearest filtering within and between mips so every sample is a true farthest depth
+	glGenTextures(1, &MPyramid);
+	glBindTexture(GL_TEXTURE_2D, MPyramid);
+	glTexStorage2D(GL_TEXTURE_2D, MLevels, GL_R32F, Width, Height);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glGenFramebuffers(1, &MFramebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, MFramebuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, MDepth, 0);
+	glDrawBuffer(GL_NONE);
+	glReadBuffer(GL_NONE);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cerr << "ERROR::FRAMEBUFFER::HIZ_INCOMPLETE" << '\n';
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	// Texture creation bound state behind the cache's back
+	GLStateCache::getInstance().invalidate();
+}
+
+void HiZBuffer::buildPyramid() const
+{
+	MBuildShader.use();
+	MBuildShader.setInt("sceneDepth", 0);
+	GLStateCache::getInstance().bindTexture(0, GL_TEXTURE_2D, MDepth);
+
+	// Level 0 is a copy of the occluder depth, each further level reduces the one before it
+	int SourceWidth = MWidth;
+	int SourceHeight = MHeight;
+	for (int Level = 0; Level < MLevels; Level++)
+	{
+		const int TargetWidth = Level == 0 ? MWidth : std::max(SourceWidth / 2, 1);
+		const int TargetHeight = Level == 0 ? MHeight : std::max(SourceHeight / 2, 1);
+
+		glBindImageTexture(0, MPyramid, std::max(Level - 1, 0), GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+		glBindImageTexture(1, MPyramid, Level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+		MBuildShader.setInt("copyDepth", Level == 0 ? 1 : 0);
+		MBuildShader.setIVec2("sourceSize", glm::ivec2(SourceWidth, SourceHeight));
+		MBuildShader.setIVec2("targetSize", glm::ivec2(TargetWidth, TargetHeight));
+		MBuildShader.dispatch((TargetWidth + BuildGroupSize - 1) / BuildGroupSize, (TargetHeight + BuildGroupSize - 1) / BuildGroupSize);
+		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+		SourceWidth = TargetWidth;
+		SourceHeight = TargetHeight;
+	}
+
+	glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+}
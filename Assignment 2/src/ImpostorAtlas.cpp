@@ -0,0 +1,217 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : ImpostorAtlas.cpp
+Description : Implementations for ImpostorAtlas class
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "ImpostorAtlas.h"
+
+#include "GLStateCache.h"
+#include "Model.h"
+
+#include <gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+	// Inverse of EncodeHemiOctahedron in Impostor.vert: a point of [-1, 1]^2 to a direction with y >= 0
+	glm::vec3 decodeHemiOctahedron(const glm::vec2 Point)
+	{
+		const float X = (Point.x + Point.y) * 0.5f;
+		const float Z = (Point.x - Point.y) * 0.5f;
+		return glm::normalize(glm::vec3(X, 1.0f - std::abs(X) - std::abs(Z), Z));
+	}
+
+	// Must match ImpostorBasis in Impostor.vert, so a baked view and the quad showing it share their axes
+	void impostorBasis(const glm::vec3& Direction, glm::vec3& Right, glm::vec3& Up)
+	{
+		const glm::vec3 WorldUp = std::abs(Direction.y) > 0.999f ? glm::vec3(0.0f, 0.0f, -1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+		Right = glm::normalize(glm::cross(WorldUp, Direction));
+		Up = glm::cross(Direction, Right);
+	}
+
+	// Box-filtered mips of a power-of-two view never mix two views; stop at one texel per view
+	int getLevelCount()
+	{
+		return static_cast<int>(std::log2(static_cast<float>(ImpostorAtlas::FramePixels))) + 1;
+	}
+}
+
+ImpostorAtlas::ImpostorAtlas()
+	: MBakeShader("resources/shaders/ImpostorBake.vert", "resources/shaders/ImpostorBake.frag"),
+	  MAlbedo(0), MNormals(0), MFramebuffer(0), MDepth(0), MQuad(InvalidGeometry), MLayerCount(0)
+{
+}
+
+void ImpostorAtlas::bake(const std::vector<const Model*>& Models)
+{
+	release();
+	if (Models.empty())
+		return;
+
+	const auto Start = std::chrono::steady_clock::now();
+	const int Size = Frames * FramePixels;
+	MLayerCount = static_cast<int>(Models.size());
+
+	if (MQuad == InvalidGeometry)
+	{
+		const std::vector<Vertex> Corners = {
+			{{-1.0f, -1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f}},
+			{{1.0f, -1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 0.0f}},
+			{{1.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 1.0f}},
+			{{-1.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f}}
+		};
+		MQuad = GeometryArena::getInstance().allocate(Corners, {0, 1, 2, 0, 2, 3});
+	}
+
+	for (GLuint* Texture : {&MAlbedo, &MNormals})
+	{
+		glGenTextures(1, Texture);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, *Texture);
+		glTexStorage3D(GL_TEXTURE_2D_ARRAY, getLevelCount(), GL_RGBA8, Size, Size, MLayerCount);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	}
+
+	glGenRenderbuffers(1, &MDepth);
+	glBindRenderbuffer(GL_RENDERBUFFER, MDepth);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, Size, Size);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	GLint PreviousFramebuffer = 0;
+	GLint Viewport[4];
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &PreviousFramebuffer);
+	glGetIntegerv(GL_VIEWPORT, Viewport);
+
+	glGenFramebuffers(1, &MFramebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, MFramebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, MDepth);
+	const GLenum Attachments[] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+	glDrawBuffers(2, Attachments);
+
+	// Leaves are single-sided, so both faces are baked
+	glDisable(GL_CULL_FACE);
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	MBakeShader.use();
+
+	for (int Layer = 0; Layer < MLayerCount; Layer++)
+	{
+		const Model& Source = *Models[Layer];
+		glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, MAlbedo, 0, Layer);
+		glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, MNormals, 0, Layer);
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+			std::cerr << "ERROR::FRAMEBUFFER::IMPOSTOR_INCOMPLETE" << '\n';
+
+		glViewport(0, 0, Size, Size);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		// Every view is an orthographic look at the bounding sphere from twice its radius
+		const BoundingSphere& Sphere = Source.getBoundingSphere();
+		const float Radius = std::max(Sphere.Radius, 1e-4f);
+		MBakeShader.setMat4("projection", glm::ortho(-Radius, Radius, -Radius, Radius, 0.0f, 4.0f * Radius));
+
+		for (int Y = 0; Y < Frames; Y++)
+		{
+			for (int X = 0; X < Frames; X++)
+			{
+				const glm::vec3 Direction = decodeHemiOctahedron(glm::vec2(X, Y) / static_cast<float>(Frames - 1) * 2.0f - 1.0f);
+				glm::vec3 Right;
+				glm::vec3 Up;
+				impostorBasis(Direction, Right, Up);
+
+				MBakeShader.setMat4("view", glm::lookAt(Sphere.Centre + Direction * (2.0f * Radius), Sphere.Centre, Up));
+				glViewport(X * FramePixels, Y * FramePixels, FramePixels, FramePixels);
+				Source.draw(MBakeShader);
+			}
+		}
+		MLayers[&Source] = Layer;
+	}
+
+	glEnable(GL_CULL_FACE);
+	glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(PreviousFramebuffer));
+	glViewport(Viewport[0], Viewport[1], Viewport[2], Viewport[3]);
+
+	for (const GLuint Texture : {MAlbedo, MNormals})
+	{
+		glBindTexture(GL_TEXTURE_2D_ARRAY, Texture);
+		glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+	}
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+	// Texture creation bound state behind the cache's back
+	GLStateCache::getInstance().invalidate();
+
+	const double Ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+	std::cout << "[Impostors] baked " << MLayerCount << " models, " << Frames << "x" << Frames << " views of " << FramePixels
+		<< " px, " << static_cast<double>(getByteSize()) / (1024.0 * 1024.0) << " MB in " << Ms << " ms" << '\n';
+}
+
+int ImpostorAtlas::getLayer(const Model& Model) const
+{
+	const auto It = MLayers.find(&Model);
+	return It == MLayers.end() ? -1 : It->second;
+}
+
+GeometryHandle ImpostorAtlas::getQuad() const
+{
+	return MQuad;
+}
+
+void ImpostorAtlas::bind(const Shader& Shader, const GLuint AlbedoUnit, const GLuint NormalUnit) const
+{
+	GLStateCache::getInstance().bindTexture(AlbedoUnit, GL_TEXTURE_2D_ARRAY, MAlbedo);
+	GLStateCache::getInstance().bindTexture(NormalUnit, GL_TEXTURE_2D_ARRAY, MNormals);
+	Shader.setInt("impostorAlbedo", static_cast<int>(AlbedoUnit));
+	Shader.setInt("impostorNormals", static_cast<int>(NormalUnit));
+	Shader.setFloat("impostorFrames", static_cast<float>(Frames));
+}
+
+size_t ImpostorAtlas::getByteSize() const
+{
+	// Two RGBA8 arrays with their mip chains
+	size_t Bytes = 0;
+	for (int Level = 0; Level < getLevelCount(); Level++)
+	{
+		const size_t Side = static_cast<size_t>(Frames * FramePixels) >> Level;
+		Bytes += Side * Side * 4;
+	}
+	return Bytes * 2 * static_cast<size_t>(MLayerCount);
+}
+
+void ImpostorAtlas::release()
+{
+	if (MFramebuffer != 0)
+	{
+		glDeleteFramebuffers(1, &MFramebuffer);
+		glDeleteRenderbuffers(1, &MDepth);
+		const GLuint Textures[] = {MAlbedo, MNormals};
+		glDeleteTextures(2, Textures);
+	}
+	MAlbedo = MNormals = MFramebuffer = MDepth = 0;
+	MLayerCount = 0;
+	MLayers.clear();
+}
+
+void ImpostorAtlas::cleanup()
+{
+	release();
+	MBakeShader.cleanup();
+	if (MQuad != InvalidGeometry)
+	{
+		GeometryArena::getInstance().release(MQuad);
+		MQuad = InvalidGeometry;
+	}
+}
@@ -1,9 +1,8 @@
 #include "InputManager.h"
+#include "CameraReplay.h"
+#include "GpuProfiler.h"
+#include "Profiler.h"
 #include "Scene.h"
-#include "Scene1.h"
-#include "Scene2.h" 
-#include "Scene3.h" 
-#include "Scene4.h" 
 #include <iostream>
 
 extern std::unique_ptr<Scene> currentScene;
@@ -11,6 +10,9 @@ extern SceneType activeScene;
 extern Camera GCamera;
 extern LightManager GLightManager;
 
+// Keys handled by the active scene rather than the input manager
+constexpr int SceneKeys[] = {GLFW_KEY_EQUAL, GLFW_KEY_MINUS, GLFW_KEY_V, GLFW_KEY_B, GLFW_KEY_G, GLFW_KEY_O, GLFW_KEY_I};
+
 InputManager::InputManager(Camera& Camera, LightManager& LightManager)
     : MCamera(Camera), MLightManager(LightManager), MWireframe(false), MCursorVisible(false),
     MFirstMouse(true), MLastX(800 / 2.0f), MLastY(600 / 2.0f)
@@ -20,13 +22,20 @@ InputManager::InputManager(Camera& Camera, LightManager& LightManager)
         {GLFW_KEY_2, false},
         {GLFW_KEY_3, false},
         {GLFW_KEY_4, false},
+        {GLFW_KEY_5, false},
         {GLFW_KEY_C, false},
+        {GLFW_KEY_K, false},
+        {GLFW_KEY_P, false},
+        {GLFW_KEY_R, false},
+        {GLFW_KEY_T, false},
         {GLFW_KEY_X, false}
     };
 }
 
 void InputManager::processInput(GLFWwindow* Window, const float DeltaTime)
 {
+    PROFILE_ZONE("InputManager::processInput");
+
     if (glfwGetKey(Window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(Window, true);
 
@@ -39,6 +48,23 @@ void InputManager::processInput(GLFWwindow* Window, const float DeltaTime)
         changeScene(3);
     if (glfwGetKey(Window, GLFW_KEY_4) == GLFW_PRESS)
         changeScene(4);
+    if (glfwGetKey(Window, GLFW_KEY_5) == GLFW_PRESS)
+        changeScene(5);
+
+    // Forward scene-specific keys to the active scene once per press
+    for (int Key : SceneKeys)
+    {
+        if (glfwGetKey(Window, Key) == GLFW_PRESS && !MKeyState[Key])
+        {
+            MKeyState[Key] = true;
+            if (currentScene)
+                currentScene->handleKey(Key);
+        }
+        else if (glfwGetKey(Window, Key) == GLFW_RELEASE)
+        {
+            MKeyState[Key] = false;
+        }
+    }
 
     // Handle wireframe toggle (X key)
     if (glfwGetKey(Window, GLFW_KEY_X) == GLFW_PRESS && !MKeyState[GLFW_KEY_X])
@@ -51,6 +77,51 @@ void InputManager::processInput(GLFWwindow* Window, const float DeltaTime)
         MKeyState[GLFW_KEY_X] = false;
     }
 
+    // Handle render queue toggle (R key)
+    if (glfwGetKey(Window, GLFW_KEY_R) == GLFW_PRESS && !MKeyState[GLFW_KEY_R])
+    {
+        MKeyState[GLFW_KEY_R] = true;
+        Scene::toggleRenderQueue();
+    }
+    else if (glfwGetKey(Window, GLFW_KEY_R) == GLFW_RELEASE)
+    {
+        MKeyState[GLFW_KEY_R] = false;
+    }
+
+    // Handle profiler capture (P key)
+    if (glfwGetKey(Window, GLFW_KEY_P) == GLFW_PRESS && !MKeyState[GLFW_KEY_P])
+    {
+        MKeyState[GLFW_KEY_P] = true;
+        if (!Profiler::getInstance().isCapturing())
+            Profiler::getInstance().beginCapture();
+    }
+    else if (glfwGetKey(Window, GLFW_KEY_P) == GLFW_RELEASE)
+    {
+        MKeyState[GLFW_KEY_P] = false;
+    }
+
+    // Handle GPU pass overlay toggle (T key)
+    if (glfwGetKey(Window, GLFW_KEY_T) == GLFW_PRESS && !MKeyState[GLFW_KEY_T])
+    {
+        MKeyState[GLFW_KEY_T] = true;
+        GpuProfiler::getInstance().toggleOverlay();
+    }
+    else if (glfwGetKey(Window, GLFW_KEY_T) == GLFW_RELEASE)
+    {
+        MKeyState[GLFW_KEY_T] = false;
+    }
+
+    // Handle camera path recording (K key)
+    if (glfwGetKey(Window, GLFW_KEY_K) == GLFW_PRESS && !MKeyState[GLFW_KEY_K])
+    {
+        MKeyState[GLFW_KEY_K] = true;
+        CameraReplay::getInstance().toggleRecording(static_cast<int>(activeScene) + 1);
+    }
+    else if (glfwGetKey(Window, GLFW_KEY_K) == GLFW_RELEASE)
+    {
+        MKeyState[GLFW_KEY_K] = false;
+    }
+
     // Handle cursor visibility toggle (C key)
     if (glfwGetKey(Window, GLFW_KEY_C) == GLFW_PRESS && !MKeyState[GLFW_KEY_C])
     {
@@ -103,51 +174,17 @@ void InputManager::toggleCursorVisibility(GLFWwindow* Window)
 void InputManager::changeScene(int sceneNumber) {
     std::cout << "Changing to scene " << sceneNumber << std::endl;
 
-    SceneType newScene = static_cast<SceneType>(sceneNumber - 1);  // Assuming sceneNumber 1 corresponds to SCENE_1, 2 to SCENE_2, etc.
+    if (sceneNumber < 1 || sceneNumber > 5) {
+        std::cerr << "Invalid scene number!" << std::endl;
+        return;
+    }
 
-    if (currentScene == nullptr || activeScene != newScene) {
-        if (currentScene) {
-            std::cout << "Cleaning up current scene..." << std::endl;
-            currentScene->cleanup();  // Clean up the previous scene
-        }
+    // A recorded path belongs to one scene, so leaving it ends the recording
+    if (CameraReplay::getInstance().isRecording() && static_cast<SceneType>(sceneNumber - 1) != activeScene)
+        CameraReplay::getInstance().toggleRecording(static_cast<int>(activeScene) + 1);
 
-        std::cout << "Attempting to create new scene..." << std::endl;
-
-        switch (newScene) {
-        case SceneType::SCENE_1:
-            std::cout << "Switching to Scene 1..." << std::endl;
-            currentScene = std::make_unique<Scene1>(GCamera, GLightManager);
-            break;
-        case SceneType::SCENE_2:
-            std::cout << "Switching to Scene 2..." << std::endl;
-            currentScene = std::make_unique<Scene2>(GCamera, GLightManager);  // Assuming Scene2 is implemented
-            break;
-        case SceneType::SCENE_3:
-            std::cout << "Switching to Scene 3..." << std::endl;
-            currentScene = std::make_unique<Scene3>(GCamera, GLightManager);  // Assuming Scene2 is implemented
-            break;
-        case SceneType::SCENE_4:
-            std::cout << "Switching to Scene 4..." << std::endl;
-            currentScene = std::make_unique<Scene4>(GCamera, GLightManager);  // Assuming Scene2 is implemented
-            break;
-        default:
-            std::cerr << "Invalid scene number!" << std::endl;
-            return;
-        }
-
-        if (currentScene) {
-            currentScene->load();
-            std::cout << "Scene loaded successfully." << std::endl;
-        }
-        else {
-            std::cerr << "Failed to load the new scene." << std::endl;
-        }
-
-        activeScene = newScene;
-    }
-    else {
-        std::cout << "Already in the active scene, no need to switch." << std::endl;
-    }
+    // Scene 1 corresponds to SCENE_1, 2 to SCENE_2, etc.
+    Scene::switchScene(static_cast<SceneType>(sceneNumber - 1), currentScene, activeScene, GCamera, GLightManager);
 }
 void InputManager::frameBufferSizeCallback(GLFWwindow* Window, const int Width, const int Height)
 {
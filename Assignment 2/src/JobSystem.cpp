@@ -0,0 +1,307 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : JobSystem.cpp
+Description : Implementations for JobSystem class
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "JobSystem.h"
+
+#include "Profiler.h"
+
+#include <algorithm>
+
+namespace
+{
+	constexpr unsigned int NoQueue = UINT32_MAX;
+
+	// Deque owned by the calling thread: 0 for the main thread, 1..N for the workers
+	thread_local unsigned int CurrentQueue = NoQueue;
+}
+
+bool JobCounter::isDone() const
+{
+	return MPending.load(std::memory_order_acquire) == 0;
+}
+
+int JobCounter::getPending() const
+{
+	return MPending.load(std::memory_order_acquire);
+}
+
+JobSystem& JobSystem::getInstance()
+{
+	static JobSystem Instance;
+	return Instance;
+}
+
+JobSystem::~JobSystem()
+{
+	shutdown();
+}
+
+unsigned int JobSystem::defaultWorkerCount()
+{
+	const unsigned int Cores = std::thread::hardware_concurrency();
+	return Cores > 1 ? Cores - 1 : 0;
+}
+
+void JobSystem::initialize(const unsigned int WorkerCount)
+{
+	shutdown();
+
+	MMainThread = std::this_thread::get_id();
+	CurrentQueue = 0;
+
+	MQueues.clear();
+	for (unsigned int I = 0; I <= WorkerCount; I++)
+		MQueues.push_back(std::make_unique<WorkerQueue>());
+
+	MRunning = true;
+	for (unsigned int I = 1; I <= WorkerCount; I++)
+		MWorkers.emplace_back(&JobSystem::workerLoop, this, I);
+}
+
+void JobSystem::shutdown()
+{
+	if (!MRunning)
+		return;
+
+	{
+		std::lock_guard<std::mutex> Lock(MSleepMutex);
+		MRunning = false;
+	}
+	MWake.notify_all();
+
+	for (std::thread& Worker : MWorkers)
+		Worker.join();
+	MWorkers.clear();
+
+	// Anything still queued was never waited on; drop it with the queues
+	MQueues.clear();
+	MQueuedJobs = 0;
+	MMainJobs.clear();
+}
+
+void JobSystem::run(std::function<void()> Function, JobCounter* Counter)
+{
+	if (Counter)
+		Counter->MPending.fetch_add(1, std::memory_order_relaxed);
+
+	push(Job{std::move(Function), Counter});
+}
+
+void JobSystem::run(std::function<void()> Function, JobCounter* Counter, JobCounter& DependsOn)
+{
+	if (Counter)
+		Counter->MPending.fetch_add(1, std::memory_order_relaxed);
+
+	// finish() takes the same lock before releasing continuations, so a dependency reaching
+	// zero either sees this job in the list or this check sees it at zero
+	{
+		std::lock_guard<std::mutex> Lock(DependsOn.MMutex);
+		if (!DependsOn.isDone())
+		{
+			DependsOn.MContinuations.push_back(Job{std::move(Function), Counter});
+			return;
+		}
+	}
+
+	push(Job{std::move(Function), Counter});
+}
+
+void JobSystem::wait(JobCounter& Counter)
+{
+	const unsigned int Queue = CurrentQueue == NoQueue ? 0 : CurrentQueue;
+	const bool OnMainThread = isMainThread();
+
+	// Help out instead of blocking; the main thread also services GL requests the jobs it is
+	// waiting for may have queued
+	while (!Counter.isDone())
+	{
+		if (OnMainThread && runMainThreadJobs() > 0)
+			continue;
+		if (MQueues.empty() || !tryRunOne(Queue))
+			std::this_thread::yield();
+	}
+
+	std::lock_guard<std::mutex> Lock(Counter.MMutex);
+}
+
+void JobSystem::parallelFor(const size_t Count, size_t Grain, const std::function<void(size_t, size_t)>& Function)
+{
+	Grain = std::max<size_t>(Grain, 1);
+	if (Count <= Grain || MWorkers.empty())
+	{
+		if (Count > 0)
+			Function(0, Count);
+		return;
+	}
+
+	// The calling thread takes the first chunk itself, then helps with the rest in wait()
+	JobCounter Counter;
+	for (size_t Begin = Grain; Begin < Count; Begin += Grain)
+	{
+		const size_t End = std::min(Begin + Grain, Count);
+		run([&Function, Begin, End] { Function(Begin, End); }, &Counter);
+	}
+
+	Function(0, Grain);
+	wait(Counter);
+}
+
+void JobSystem::runOnMainThread(std::function<void()> Function, JobCounter* Counter)
+{
+	if (MQueues.empty() || isMainThread())
+	{
+		Function();
+		return;
+	}
+
+	if (Counter)
+		Counter->MPending.fetch_add(1, std::memory_order_relaxed);
+
+	std::lock_guard<std::mutex> Lock(MMainMutex);
+	MMainJobs.push_back(Job{std::move(Function), Counter});
+}
+
+unsigned int JobSystem::runMainThreadJobs()
+{
+	std::vector<Job> Jobs;
+	{
+		std::lock_guard<std::mutex> Lock(MMainMutex);
+		Jobs.swap(MMainJobs);
+	}
+
+	for (Job& Current : Jobs)
+		execute(Current);
+	return static_cast<unsigned int>(Jobs.size());
+}
+
+unsigned int JobSystem::getWorkerCount() const
+{
+	return static_cast<unsigned int>(MWorkers.size());
+}
+
+bool JobSystem::isMainThread() const
+{
+	return std::this_thread::get_id() == MMainThread;
+}
+
+unsigned int JobSystem::getThreadIndex()
+{
+	return CurrentQueue == NoQueue ? 0 : CurrentQueue;
+}
+
+void JobSystem::push(Job&& NewJob)
+{
+	if (MQueues.empty())
+	{
+		// Not initialized: behave like a single-threaded engine
+		execute(NewJob);
+		return;
+	}
+
+	// Workers keep what they spawn; the main thread deals its jobs out round-robin so the
+	// workers start on them without all stealing from one deque
+	unsigned int Queue = CurrentQueue;
+	if (Queue == NoQueue || Queue == 0)
+		Queue = MNextQueue.fetch_add(1, std::memory_order_relaxed) % static_cast<unsigned int>(MQueues.size());
+
+	{
+		std::lock_guard<std::mutex> Lock(MQueues[Queue]->Mutex);
+		MQueues[Queue]->Jobs.push_back(std::move(NewJob));
+	}
+
+	MQueuedJobs.fetch_add(1, std::memory_order_release);
+	{
+		std::lock_guard<std::mutex> Lock(MSleepMutex);
+	}
+	MWake.notify_one();
+}
+
+bool JobSystem::tryRunOne(const unsigned int Queue)
+{
+	Job Current;
+	bool Found = false;
+
+	// Own deque from the back, newest first
+	{
+		WorkerQueue& Own = *MQueues[Queue];
+		std::lock_guard<std::mutex> Lock(Own.Mutex);
+		if (!Own.Jobs.empty())
+		{
+			Current = std::move(Own.Jobs.back());
+			Own.Jobs.pop_back();
+			Found = true;
+		}
+	}
+
+	// Then steal the oldest job from the next non-empty deque
+	const unsigned int QueueCount = static_cast<unsigned int>(MQueues.size());
+	for (unsigned int Offset = 1; !Found && Offset < QueueCount; Offset++)
+	{
+		WorkerQueue& Victim = *MQueues[(Queue + Offset) % QueueCount];
+		std::lock_guard<std::mutex> Lock(Victim.Mutex);
+		if (!Victim.Jobs.empty())
+		{
+			Current = std::move(Victim.Jobs.front());
+			Victim.Jobs.pop_front();
+			Found = true;
+		}
+	}
+
+	if (!Found)
+		return false;
+
+	MQueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+	execute(Current);
+	return true;
+}
+
+void JobSystem::execute(Job& Current)
+{
+	Current.Function();
+	finish(Current.Counter);
+}
+
+void JobSystem::finish(JobCounter* Counter)
+{
+	if (!Counter)
+		return;
+
+	// Decrement under the counter's lock: wait() takes it once before returning, so a counter
+	// on the waiter's stack is not destroyed while the last job is still releasing it
+	std::vector<Job> Continuations;
+	{
+		std::lock_guard<std::mutex> Lock(Counter->MMutex);
+		if (Counter->MPending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			Continuations.swap(Counter->MContinuations);
+	}
+
+	// Last job of the counter: release whatever was waiting on it
+	for (Job& Continuation : Continuations)
+		push(std::move(Continuation));
+}
+
+void JobSystem::workerLoop(const unsigned int Queue)
+{
+	CurrentQueue = Queue;
+	PROFILE_THREAD("Worker " + std::to_string(Queue));
+
+	while (MRunning)
+	{
+		if (tryRunOne(Queue))
+			continue;
+
+		std::unique_lock<std::mutex> Lock(MSleepMutex);
+		MWake.wait(Lock, [this] { return !MRunning || MQueuedJobs.load(std::memory_order_acquire) > 0; });
+	}
+}
@@ -19,10 +19,15 @@ Mail : ayoub.ahmad@mds.ac.nz
 #include "Camera.h"
 #include "Camera.h"
 
-LightManager::LightManager() = default;
+LightManager::LightManager()
+	: MPointLights(ActivePointLights)
+{
+}
 
 void LightManager::initialize()
 {
+	MPointLights.assign(ActivePointLights, {});
+	MPointLightPath = PointLightPath::Uniforms;
 	MPointLights[0] = {glm::vec3(-2.0f, 0.5f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), 1.0f, 0.09f, 0.032f}; // Red light
 	MPointLights[1] = {glm::vec3(2.0f, 0.5f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), 1.0f, 0.09f, 0.032f}; // Blue light
 	MDirectionalLight = {glm::vec3(-0.2f, -1.0f, -0.3f), glm::vec3(0.4f, 0.4f, 0.4f), 0.1f};
@@ -38,11 +43,16 @@ void LightManager::initialize()
 
 void LightManager::updateLighting(const Shader& Shader) const
 {
-	Shader.setVec3("directionalLight.direction", MDirectionalLight.Direction);
-	Shader.setVec3("directionalLight.color", MDirectionalLight.Colour);
-	Shader.setFloat("directionalLight.ambientStrength", MDirectionalLight.AmbientStrength);
+	// Disabled lights are compiled out of the selected variant, so only enabled ones are uploaded
+	if (MDirectionalLightOn)
+	{
+		Shader.setVec3("directionalLight.direction", MDirectionalLight.Direction);
+		Shader.setVec3("directionalLight.color", MDirectionalLight.Colour);
+		Shader.setFloat("directionalLight.ambientStrength", MDirectionalLight.AmbientStrength);
+	}
 
-	for (int I = 0; I < 2; I++)
+	const bool UniformPointLights = MPointLightsOn && MPointLightPath == PointLightPath::Uniforms;
+	for (int I = 0; UniformPointLights && I < ActivePointLights; I++)
 	{
 		Shader.setVec3("pointLights[" + std::to_string(I) + "].position", MPointLights[I].Position);
 		Shader.setVec3("pointLights[" + std::to_string(I) + "].color", MPointLights[I].Colour);
@@ -51,6 +61,9 @@ void LightManager::updateLighting(const Shader& Shader) const
 		Shader.setFloat("pointLights[" + std::to_string(I) + "].quadratic", MPointLights[I].Quadratic);
 	}
 
+	if (!MSpotLightOn)
+		return;
+
 	Shader.setVec3("spotLight.position", MSpotLight.Position);
 	Shader.setVec3("spotLight.direction", MSpotLight.Direction);
 	Shader.setVec3("spotLight.color", MSpotLight.Colour);
@@ -61,6 +74,20 @@ void LightManager::updateLighting(const Shader& Shader) const
 	Shader.setFloat("spotLight.quadratic", MSpotLight.Quadratic);
 }
 
+ShaderVariant LightManager::getShaderVariant(const bool Textured) const
+{
+	ShaderVariant Variant;
+	Variant.HasTexture = Textured;
+	Variant.HasDirectionalLight = MDirectionalLightOn;
+	Variant.HasSpotLight = MSpotLightOn;
+	if (MPointLightsOn)
+	{
+		Variant.PointLights = MPointLightPath;
+		Variant.NumPointLights = MPointLightPath == PointLightPath::Uniforms ? ActivePointLights : 0;
+	}
+	return Variant;
+}
+
 void LightManager::togglePointLights()
 {
 	MPointLightsOn = !MPointLightsOn;
@@ -113,3 +140,18 @@ PointLight& LightManager::getPointLight(int Index)
 {
 	return MPointLights[Index];
 }
+
+std::vector<PointLight>& LightManager::getPointLights()
+{
+	return MPointLights;
+}
+
+void LightManager::setPointLightPath(const PointLightPath Path)
+{
+	MPointLightPath = Path;
+}
+
+PointLightPath LightManager::getPointLightPath() const
+{
+	return MPointLightPath;
+}
@@ -0,0 +1,72 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : LinearAllocator.cpp
+Description : Implementations for LinearAllocator class
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "LinearAllocator.h"
+
+#include <algorithm>
+#include <cstdint>
+
+LinearAllocator::LinearAllocator(const size_t BlockBytes)
+	: MBlockBytes(BlockBytes)
+{
+}
+
+void* LinearAllocator::allocate(const size_t Bytes, const size_t Alignment)
+{
+	// Try the current block, then any block kept from an earlier frame, then a new one big
+	// enough for this request even if it is larger than the block size
+	while (true)
+	{
+		if (MCurrent < MBlocks.size())
+		{
+			Block& Current = MBlocks[MCurrent];
+			const uintptr_t Base = reinterpret_cast<uintptr_t>(Current.Memory.get());
+			const uintptr_t Aligned = (Base + MOffset + Alignment - 1) & ~(static_cast<uintptr_t>(Alignment) - 1);
+			const size_t Offset = static_cast<size_t>(Aligned - Base);
+			if (Offset + Bytes <= Current.Size)
+			{
+				MOffset = Offset + Bytes;
+				MUsed += Bytes;
+				return Current.Memory.get() + Offset;
+			}
+
+			MCurrent++;
+			MOffset = 0;
+			continue;
+		}
+
+		const size_t Size = std::max(MBlockBytes, Bytes + Alignment);
+		MBlocks.push_back(Block{std::make_unique<std::byte[]>(Size), Size});
+	}
+}
+
+void LinearAllocator::reset()
+{
+	MCurrent = 0;
+	MOffset = 0;
+	MUsed = 0;
+}
+
+size_t LinearAllocator::getUsedBytes() const
+{
+	return MUsed;
+}
+
+size_t LinearAllocator::getReservedBytes() const
+{
+	size_t Total = 0;
+	for (const Block& Block : MBlocks)
+		Total += Block.Size;
+	return Total;
+}
@@ -14,10 +14,59 @@ Mail : ayoub.ahmad@mds.ac.nz
 
 #include "Mesh.h"
 
-Mesh::Mesh(std::vector<Vertex> Vertices, std::vector<unsigned int> Indices, std::vector<Texture> Textures)
-	: Vertices(std::move(Vertices)), Indices(std::move(Indices)), Textures(std::move(Textures))
+#include "GLStateCache.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+Mesh::Mesh(std::vector<Vertex>&& Vertices, std::vector<unsigned int>&& Indices, const CpuGeometryPolicy Policy)
+	: MVertices(std::move(Vertices)), MIndices(std::move(Indices)), MGeometry(InvalidGeometry)
 {
+	computeBounds();
 	setupMesh();
+
+	// The arena holds the only copy the renderer reads; swap rather than clear so the
+	// allocations are actually freed
+	if (Policy == CpuGeometryPolicy::Release)
+	{
+		std::vector<Vertex>().swap(MVertices);
+		std::vector<unsigned int>().swap(MIndices);
+	}
+}
+
+Mesh::~Mesh()
+{
+	cleanup();
+}
+
+Mesh::Mesh(Mesh&& Other) noexcept
+	: Textures(std::move(Other.Textures)), Bounds(Other.Bounds), Sphere(Other.Sphere),
+	  MVertices(std::move(Other.MVertices)), MIndices(std::move(Other.MIndices)), MGeometry(Other.MGeometry)
+{
+	Other.MGeometry = InvalidGeometry;
+}
+
+Mesh& Mesh::operator=(Mesh&& Other) noexcept
+{
+	if (this != &Other)
+	{
+		cleanup();
+		Textures = std::move(Other.Textures);
+		Bounds = Other.Bounds;
+		Sphere = Other.Sphere;
+		MVertices = std::move(Other.MVertices);
+		MIndices = std::move(Other.MIndices);
+		MGeometry = Other.MGeometry;
+		Other.MGeometry = InvalidGeometry;
+	}
+	return *this;
 }
 
 void Mesh::draw(const Shader& Shader) const
@@ -26,7 +75,6 @@ void Mesh::draw(const Shader& Shader) const
 	unsigned int SpecularNr = 1;
 	for (unsigned int I = 0; I < Textures.size(); I++)
 	{
-		glActiveTexture(GL_TEXTURE0 + I);
 		std::string Number;
 		std::string Name = Textures[I].Type;
 		if (Name == "texture_diffuse")
@@ -35,60 +83,152 @@ void Mesh::draw(const Shader& Shader) const
 			Number = std::to_string(SpecularNr++);
 
 		Shader.setInt(Name + Number, I);
-		glBindTexture(GL_TEXTURE_2D, Textures[I].Id);
+		GLStateCache::getInstance().bindTexture(I, GL_TEXTURE_2D, Textures[I].Id);
 	}
 
-	glBindVertexArray(MVao);
-	glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(Indices.size()), GL_UNSIGNED_INT, nullptr);
-	glBindVertexArray(0);
+	drawInstanced(1);
+}
 
-	glActiveTexture(GL_TEXTURE0);
+void Mesh::drawInstanced(const GLsizei InstanceCount) const
+{
+	GeometryArena::getInstance().draw(MGeometry, InstanceCount);
 }
 
 void Mesh::cleanup() {
-	// Delete VAO, VBO, and EBO
-	if (MVao != 0) {
-		glDeleteVertexArrays(1, &MVao);
-		MVao = 0;
+	// Return the vertex and index ranges to the arena
+	if (MGeometry != InvalidGeometry) {
+		GeometryArena::getInstance().release(MGeometry);
+		MGeometry = InvalidGeometry;
+	}
+}
+
+GeometryHandle Mesh::getGeometry() const
+{
+	return MGeometry;
+}
+
+bool Mesh::hasCpuGeometry() const
+{
+	return !MVertices.empty();
+}
+
+const std::vector<Vertex>& Mesh::getVertices() const
+{
+	return MVertices;
+}
+
+const std::vector<unsigned int>& Mesh::getIndices() const
+{
+	return MIndices;
+}
+
+void Mesh::setupMesh()
+{
+	MGeometry = GeometryArena::getInstance().allocate(MVertices, MIndices);
+}
+
+void Mesh::computeBounds()
+{
+	if (MVertices.empty())
+		return;
+
+	Bounds = {MVertices[0].Position, MVertices[0].Position};
+	for (const Vertex& Vertex : MVertices)
+	{
+		Bounds.Min = glm::min(Bounds.Min, Vertex.Position);
+		Bounds.Max = glm::max(Bounds.Max, Vertex.Position);
 	}
-	if (MVbo != 0) {
-		glDeleteBuffers(1, &MVbo);
-		MVbo = 0;
+
+	// Centred on the box, sized by the furthest vertex rather than the box corner
+	Sphere.Centre = Bounds.getCentre();
+	float RadiusSquared = 0.0f;
+	for (const Vertex& Vertex : MVertices)
+	{
+		const glm::vec3 Offset = Vertex.Position - Sphere.Centre;
+		RadiusSquared = std::max(RadiusSquared, glm::dot(Offset, Offset));
 	}
-	if (MEbo != 0) {
-		glDeleteBuffers(1, &MEbo);
-		MEbo = 0;
+	Sphere.Radius = std::sqrt(RadiusSquared);
+}
+
+namespace
+{
+	static_assert(sizeof(Vertex) == 32, "hashVertex reads a Vertex as four 64-bit words");
+
+	// 64x64 -> 128-bit multiply folded back to 64 bits, the mixing step of wyhash
+	uint64_t multiplyMix(const uint64_t A, const uint64_t B)
+	{
+#ifdef _MSC_VER
+		uint64_t High;
+		const uint64_t Low = _umul128(A, B, &High);
+		return Low ^ High;
+#else
+		const unsigned __int128 Product = static_cast<unsigned __int128>(A) * B;
+		return static_cast<uint64_t>(Product) ^ static_cast<uint64_t>(Product >> 64);
+#endif
 	}
 
-	// Delete textures
-	for (auto& texture : Textures) {
-		if (texture.Id != 0) {
-			glDeleteTextures(1, &texture.Id);
-			texture.Id = 0;
+	// wyhash over the vertex's 32 bytes. -0.0 is folded into 0.0 first, since Vertex::operator==
+	// treats them as the same vertex.
+	uint64_t hashVertex(const Vertex& Vertex)
+	{
+		uint32_t Bits[8];
+		std::memcpy(Bits, &Vertex, sizeof(Bits));
+		for (uint32_t& Word : Bits)
+		{
+			if (Word == 0x80000000u)
+				Word = 0;
 		}
+
+		uint64_t Words[4];
+		std::memcpy(Words, Bits, sizeof(Words));
+
+		constexpr uint64_t Secret0 = 0xa0761d6478bd642full;
+		constexpr uint64_t Secret1 = 0xe7037ed1a0b428dbull;
+		constexpr uint64_t Secret2 = 0x8ebc6af09c88c6e3ull;
+		const uint64_t Seed = multiplyMix(Words[0] ^ Secret1, Words[1] ^ Secret0) ^ multiplyMix(Words[2] ^ Secret2, Words[3] ^ Secret0);
+		return multiplyMix(Seed ^ Secret1, sizeof(Vertex) ^ Secret0);
 	}
 }
 
-void Mesh::setupMesh()
+void deduplicateVertices(const std::vector<Vertex>& Corners, std::vector<Vertex>& Vertices, std::vector<unsigned int>& Indices)
 {
-	glGenVertexArrays(1, &MVao);
-	glGenBuffers(1, &MVbo);
-	glGenBuffers(1, &MEbo);
-
-	glBindVertexArray(MVao);
-	glBindBuffer(GL_ARRAY_BUFFER, MVbo);
-	glBufferData(GL_ARRAY_BUFFER, Vertices.size() * sizeof(Vertex), Vertices.data(), GL_STATIC_DRAW);
-
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, MEbo);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, Indices.size() * sizeof(unsigned int), Indices.data(), GL_STATIC_DRAW);
-
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), static_cast<void*>(nullptr));
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, Normal)));
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-	                      reinterpret_cast<void*>(offsetof(Vertex, TexCoords)));
-
-	glBindVertexArray(0);
+	constexpr uint32_t EmptySlot = UINT32_MAX;
+
+	// Each slot holds the vertex's index and the high half of its hash, so most probes that
+	// miss are rejected without comparing vertices. At most half the slots ever fill.
+	struct Slot
+	{
+		uint32_t Tag;
+		uint32_t Index;
+	};
+
+	const size_t SlotCount = std::bit_ceil(std::max<size_t>(Corners.size() * 2, 16));
+	const size_t Mask = SlotCount - 1;
+	std::vector<Slot> Table(SlotCount, Slot{0, EmptySlot});
+
+	Indices.reserve(Indices.size() + Corners.size());
+
+	for (const Vertex& Vertex : Corners)
+	{
+		const uint64_t Hash = hashVertex(Vertex);
+		const uint32_t Tag = static_cast<uint32_t>(Hash >> 32);
+
+		// Linear probing finds the vertex or the empty slot it belongs in, in the same walk
+		size_t Position = static_cast<size_t>(Hash) & Mask;
+		while (true)
+		{
+			Slot& Entry = Table[Position];
+			if (Entry.Index == EmptySlot)
+			{
+				Entry = {Tag, static_cast<uint32_t>(Vertices.size())};
+				Vertices.push_back(Vertex);
+				break;
+			}
+			if (Entry.Tag == Tag && Vertices[Entry.Index] == Vertex)
+				break;
+			Position = (Position + 1) & Mask;
+		}
+
+		Indices.push_back(Table[Position].Index);
+	}
 }
@@ -13,46 +13,152 @@ Mail : ayoub.ahmad@mds.ac.nz
 **************************************************************************/
 
 #include "Model.h"
-
-#define TINYOBJLOADER_IMPLEMENTATION
-#include "tiny_obj_loader.h"
+#include "JobSystem.h"
+#include "ObjParser.h"
+#include "Profiler.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
+#include <algorithm>
 #include <iostream>
-#include <unordered_map>
 #include <fstream>
 
-Model::Model(const std::string& ModelPath, const std::string& TexturePath)
+namespace
+{
+	const std::string TextureDirectory = "resources/textures";
+}
+
+Model::Model(const std::string& ModelPath, const std::string& TexturePath, const CpuGeometryPolicy Policy)
+	: Model(read(ModelPath, TexturePath), Policy)
+{
+}
+
+Model::Model(ModelSource&& Source, const CpuGeometryPolicy Policy)
+{
+	PROFILE_ZONE("Model::upload");
+	MMeshes.reserve(Source.Meshes.size());
+	for (ModelSource::MeshSource& Mesh : Source.Meshes)
+		MMeshes.emplace_back(std::move(Mesh.Vertices), std::move(Mesh.Indices), Policy);
+	computeBounds();
+
+	Texture Texture;
+	Texture.Id = createTexture(Source.Image);
+	MTextureBytes += estimateTextureBytes(Texture.Id);
+	Texture.Type = "texture_diffuse";
+	Texture.Path = Source.TexturePath;
+	MTexturesLoaded.push_back(Texture);
+	MTexturePath = Source.TexturePath;
+
+	// Apply the texture to all meshes
+	for (auto& Mesh : MMeshes)
+	{
+		Mesh.Textures.push_back(Texture);
+	}
+}
+
+ModelSource Model::read(const std::string& ModelPath, const std::string& TexturePath)
+{
+	PROFILE_ZONE("Model::read");
+	ModelSource Source;
+	readMeshes(ModelPath, Source);
+
+	const std::string FullPath = TextureDirectory + '/' + TexturePath;
+	std::cout << "Loading texture: " << FullPath << '\n';
+	Source.Image = decodeImage(FullPath);
+	Source.TexturePath = TexturePath;
+	return Source;
+}
+
+Model::~Model()
+{
+	cleanup();
+}
+
+Model::Model(Model&& Other) noexcept
+	: MMeshes(std::move(Other.MMeshes)), MTexturesLoaded(std::move(Other.MTexturesLoaded)),
+	  MTexturePath(std::move(Other.MTexturePath)), MBounds(Other.MBounds), MSphere(Other.MSphere), MTextureBytes(Other.MTextureBytes)
+{
+	Other.MTextureBytes = 0;
+}
+
+Model& Model::operator=(Model&& Other) noexcept
 {
-	this->MDirectory = "resources/textures"; // Set the directory for textures
-	loadModel(ModelPath);
-	loadTexture(TexturePath);
+	if (this != &Other)
+	{
+		cleanup();
+		MMeshes = std::move(Other.MMeshes);
+		MTexturesLoaded = std::move(Other.MTexturesLoaded);
+		MTexturePath = std::move(Other.MTexturePath);
+		MBounds = Other.MBounds;
+		MSphere = Other.MSphere;
+		MTextureBytes = Other.MTextureBytes;
+		Other.MMeshes.clear();
+		Other.MTexturesLoaded.clear();
+		Other.MTextureBytes = 0;
+	}
+	return *this;
 }
 
 void Model::draw(const Shader& Shader) const
 {
+	PROFILE_ZONE("Model::draw");
 	for (const auto& Mesh : MMeshes)
 		Mesh.draw(Shader);
 }
 
+void Model::drawInstanced(const GLsizei InstanceCount) const
+{
+	for (const auto& Mesh : MMeshes)
+		Mesh.drawInstanced(InstanceCount);
+}
+
 void Model::cleanup() {
-	for (Mesh& mesh : MMeshes) {  // Assuming `meshes` is a std::vector<Mesh>
-		mesh.cleanup();  // Call cleanup on each Mesh in the Model
+	// Each mesh returns its geometry to the arena as it is destroyed
+	MMeshes.clear();
+
+	// Meshes share the model's textures, so they are deleted once, here
+	for (Texture& texture : MTexturesLoaded) {
+		if (texture.Id != 0)
+			glDeleteTextures(1, &texture.Id);
 	}
+	MTexturesLoaded.clear();
+	MTextureBytes = 0;
+}
+
+const std::vector<Mesh>& Model::getMeshes() const
+{
+	return MMeshes;
+}
+
+const Aabb& Model::getBounds() const
+{
+	return MBounds;
 }
 
-void Model::loadModel(const std::string& Path)
+const BoundingSphere& Model::getBoundingSphere() const
 {
-	stbi_set_flip_vertically_on_load(true);
+	return MSphere;
+}
 
-	tinyobj::attrib_t Attrib;
-	std::vector<tinyobj::shape_t> Shapes;
-	std::vector<tinyobj::material_t> Materials;
+ResidentSize Model::getResidentSize() const
+{
+	ResidentSize Size;
+	Size.GpuBytes = MTextureBytes;
+	for (const Mesh& Mesh : MMeshes)
+	{
+		Size.GpuBytes += GeometryArena::getInstance().getByteSize(Mesh.getGeometry());
+		Size.CpuBytes += Mesh.getVertices().capacity() * sizeof(Vertex) + Mesh.getIndices().capacity() * sizeof(unsigned int);
+	}
+	return Size;
+}
+
+void Model::readMeshes(const std::string& Path, ModelSource& Source)
+{
+	ObjGeometry Geometry;
 	std::string Warn, Err;
 
-	bool Ret = LoadObj(&Attrib, &Shapes, &Materials, &Warn, &Err, Path.c_str(), nullptr, true);
+	bool Ret = parseObj(Path, Geometry, Warn, Err);
 
 	if (!Warn.empty())
 	{
@@ -70,80 +176,86 @@ void Model::loadModel(const std::string& Path)
 		return;
 	}
 
-	for (const auto& Shape : Shapes)
+	// Shapes only read the shared attributes, so each one is expanded and deduplicated on its own job
+	Source.Meshes.resize(Geometry.Shapes.size());
+	JobSystem::getInstance().parallelFor(Geometry.Shapes.size(), 1, [&](const size_t FirstShape, const size_t LastShape)
 	{
-		std::vector<Vertex> Vertices;
-		std::vector<unsigned int> Indices;
-		std::vector<Texture> Textures;
-
-		std::unordered_map<Vertex, uint32_t> UniqueVertices = {};
-
-		for (const auto& Index : Shape.mesh.indices)
+		for (size_t ShapeIndex = FirstShape; ShapeIndex < LastShape; ShapeIndex++)
 		{
-			Vertex Vertex = {};
-
-			Vertex.Position = {
-				Attrib.vertices[3 * Index.vertex_index + 0],
-				Attrib.vertices[3 * Index.vertex_index + 1],
-				Attrib.vertices[3 * Index.vertex_index + 2]
-			};
+			const ObjGeometry::Shape& Shape = Geometry.Shapes[ShapeIndex];
+			std::vector<Vertex> Corners;
+			Corners.reserve(Shape.Corners.size());
 
-			if (Index.normal_index >= 0)
+			for (const auto& Index : Shape.Corners)
 			{
-				Vertex.Normal = {
-					Attrib.normals[3 * Index.normal_index + 0],
-					Attrib.normals[3 * Index.normal_index + 1],
-					Attrib.normals[3 * Index.normal_index + 2]
-				};
-			}
+				Vertex Vertex = {};
 
-			if (Index.texcoord_index >= 0)
-			{
-				Vertex.TexCoords = {
-					Attrib.texcoords[2 * Index.texcoord_index + 0],
-					Attrib.texcoords[2 * Index.texcoord_index + 1]
+				Vertex.Position = {
+					Geometry.Positions[3 * Index.vertex_index + 0],
+					Geometry.Positions[3 * Index.vertex_index + 1],
+					Geometry.Positions[3 * Index.vertex_index + 2]
 				};
-			}
 
-			if (!UniqueVertices.contains(Vertex))
-			{
-				UniqueVertices[Vertex] = static_cast<uint32_t>(Vertices.size());
-				Vertices.push_back(Vertex);
+				if (Index.normal_index >= 0)
+				{
+					Vertex.Normal = {
+						Geometry.Normals[3 * Index.normal_index + 0],
+						Geometry.Normals[3 * Index.normal_index + 1],
+						Geometry.Normals[3 * Index.normal_index + 2]
+					};
+				}
+
+				if (Index.texcoord_index >= 0)
+				{
+					Vertex.TexCoords = {
+						Geometry.TexCoords[2 * Index.texcoord_index + 0],
+						Geometry.TexCoords[2 * Index.texcoord_index + 1]
+					};
+				}
+
+				Corners.push_back(Vertex);
 			}
 
-			Indices.push_back(UniqueVertices[Vertex]);
+			ModelSource::MeshSource& Mesh = Source.Meshes[ShapeIndex];
+			deduplicateVertices(Corners, Mesh.Vertices, Mesh.Indices);
 		}
-
-		Mesh Mesh(Vertices, Indices, Textures);
-		MMeshes.push_back(Mesh);
-	}
+	});
 }
 
-void Model::loadTexture(const std::string& Path)
+void Model::computeBounds()
 {
-	const std::string FullPath = MDirectory + '/' + Path;
-	std::cout << "Loading texture: " << FullPath << '\n';
+	// Whole-model bounds enclose every mesh's sphere
+	if (MMeshes.empty())
+		return;
 
-	Texture Texture;
-	Texture.Id = textureFromFile(FullPath.c_str(), MDirectory);
-	Texture.Type = "texture_diffuse";
-	Texture.Path = Path;
-	MTexturesLoaded.push_back(Texture);
+	MBounds = MMeshes[0].Bounds;
+	for (const auto& Mesh : MMeshes)
+		MBounds = MBounds.merged(Mesh.Bounds);
 
-	// Apply the texture to all meshes
-	for (auto& Mesh : MMeshes)
-	{
-		Mesh.Textures.push_back(Texture);
-	}
+	MSphere.Centre = MBounds.getCentre();
+	MSphere.Radius = 0.0f;
+	for (const auto& Mesh : MMeshes)
+		MSphere.Radius = std::max(MSphere.Radius, glm::length(Mesh.Sphere.Centre - MSphere.Centre) + Mesh.Sphere.Radius);
+}
+
+void DecodedImage::PixelDeleter::operator()(unsigned char* Pixels) const
+{
+	stbi_image_free(Pixels);
 }
 
 unsigned int textureFromFile(const char* Path, const std::string& Directory, bool Gamma)
 {
-	const auto Filename = std::string(Path);
+	return createTexture(decodeImage(Path));
+}
+
+DecodedImage decodeImage(const std::string& Path)
+{
+	PROFILE_ZONE("decodeImage");
+	DecodedImage Image;
 
 	// Print the absolute path
 	char AbsPath[1024];
-	_fullpath(AbsPath, Filename.c_str(), sizeof(AbsPath));
+	_fullpath(AbsPath, Path.c_str(), sizeof(AbsPath));
 	//std::cout << "Absolute path: " << AbsPath << '\n';
 
 	// Check if file exists
@@ -151,41 +263,53 @@ unsigned int textureFromFile(const char* Path, const std::string& Directory, boo
 	if (!File.good())
 	{
 		std::cerr << "File does not exist: " << AbsPath << '\n';
-		return 0;
+		return Image;
 	}
 	File.close();
 
+	// The flip flag is per thread so workers decoding at the same time do not race on it
+	stbi_set_flip_vertically_on_load_thread(true);
+	Image.Pixels.reset(stbi_load(Path.c_str(), &Image.Width, &Image.Height, &Image.Components, 0));
+	if (!Image.Pixels)
+		std::cerr << "Texture failed to load at path: " << Path << '\n';
+	return Image;
+}
+
+unsigned int createTexture(const DecodedImage& Image)
+{
+	if (!Image.Pixels)
+		return 0;
+
+	GLenum Format = 0;
+	if (Image.Components == 1)
+		Format = GL_RED;
+	else if (Image.Components == 3)
+		Format = GL_RGB;
+	else if (Image.Components == 4)
+		Format = GL_RGBA;
+
 	unsigned int TextureId;
 	glGenTextures(1, &TextureId);
+	glBindTexture(GL_TEXTURE_2D, TextureId);
+	glTexImage2D(GL_TEXTURE_2D, 0, Format, Image.Width, Image.Height, 0, Format, GL_UNSIGNED_BYTE, Image.Pixels.get());
+	glGenerateMipmap(GL_TEXTURE_2D);
 
-	int Width, Height, NrComponents;
-	unsigned char* Data = stbi_load(Filename.c_str(), &Width, &Height, &NrComponents, 0);
-	if (Data)
-	{
-		GLenum Format = 0;
-		if (NrComponents == 1)
-			Format = GL_RED;
-		else if (NrComponents == 3)
-			Format = GL_RGB;
-		else if (NrComponents == 4)
-			Format = GL_RGBA;
-
-		glBindTexture(GL_TEXTURE_2D, TextureId);
-		glTexImage2D(GL_TEXTURE_2D, 0, Format, Width, Height, 0, Format, GL_UNSIGNED_BYTE, Data);
-		glGenerateMipmap(GL_TEXTURE_2D);
-
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		stbi_image_free(Data);
-	}
-	else
-	{
-		std::cerr << "Texture failed to load at path: " << Filename << '\n';
-		stbi_image_free(Data);
-	}
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
 	return TextureId;
 }
+
+size_t estimateTextureBytes(const unsigned int Texture)
+{
+	if (Texture == 0)
+		return 0;
+
+	GLint Width = 0, Height = 0;
+	glGetTextureLevelParameteriv(Texture, 0, GL_TEXTURE_WIDTH, &Width);
+	glGetTextureLevelParameteriv(Texture, 0, GL_TEXTURE_HEIGHT, &Height);
+	const size_t Level0 = static_cast<size_t>(Width) * Height * 4;
+	return Level0 + Level0 / 3;
+}
@@ -0,0 +1,369 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : ObjParser.cpp
+Description : Implementations for the chunked, multithreaded OBJ parser
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "ObjParser.h"
+
+#include "JobSystem.h"
+#include "Profiler.h"
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "tiny_obj_loader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+	// Smaller files, and the tail of larger ones, are not worth a job of their own
+	constexpr size_t MinChunkBytes = 64 * 1024;
+	constexpr size_t ChunksPerThread = 4;
+
+	enum class LineType
+	{
+		Other,
+		Position,
+		Normal,
+		TexCoord,
+		Face,
+		Object,
+		Group
+	};
+
+	struct ObjChunk
+	{
+		// Whole lines [Begin, End) of the file buffer
+		size_t Begin = 0;
+		size_t End = 0;
+
+		// Counted by the first pass; the totals of the chunks before this one are its offsets
+		size_t Lines = 0;
+		size_t Positions = 0;
+		size_t Normals = 0;
+		size_t TexCoords = 0;
+		size_t FirstLine = 0;
+		size_t FirstPosition = 0;
+		size_t FirstNormal = 0;
+		size_t FirstTexCoord = 0;
+
+		// Filled by the second pass. Each o or g line starts a shape before face Groups[I].first.
+		std::vector<tinyobj::face_t> Faces;
+		std::vector<std::pair<size_t, std::string>> Groups;
+		std::string Warnings;
+		std::string Errors;
+	};
+
+	// The faces of one chunk that belong to one shape, triangulated as a unit
+	struct FaceRun
+	{
+		size_t Shape;
+		size_t Chunk;
+		size_t Begin;
+		size_t End;
+		tinyobj::shape_t Triangles;
+		std::string Warnings;
+	};
+
+	bool isBlank(const char Character)
+	{
+		return Character == ' ' || Character == '\t';
+	}
+
+	LineType classifyLine(const char* Token)
+	{
+		// A blank last line leaves Token on the terminator, the only byte past it that is readable
+		if (Token[0] == '\0')
+			return LineType::Other;
+		if (Token[0] == 'v')
+		{
+			if (isBlank(Token[1]))
+				return LineType::Position;
+			if (Token[1] == 'n' && isBlank(Token[2]))
+				return LineType::Normal;
+			if (Token[1] == 't' && isBlank(Token[2]))
+				return LineType::TexCoord;
+		}
+		else if (isBlank(Token[1]))
+		{
+			if (Token[0] == 'f')
+				return LineType::Face;
+			if (Token[0] == 'o')
+				return LineType::Object;
+			if (Token[0] == 'g')
+				return LineType::Group;
+		}
+		return LineType::Other;
+	}
+
+	// Splits the buffer at line ends into chunks of roughly equal size
+	std::vector<ObjChunk> splitChunks(const char* Data, const size_t Size)
+	{
+		const size_t MaxChunks = (JobSystem::getInstance().getWorkerCount() + 1) * ChunksPerThread;
+		const size_t ChunkCount = std::clamp<size_t>(Size / MinChunkBytes, 1, MaxChunks);
+		const size_t Target = Size / ChunkCount;
+
+		std::vector<ObjChunk> Chunks;
+		Chunks.reserve(ChunkCount);
+		size_t Begin = 0;
+		while (Begin < Size)
+		{
+			size_t End = Chunks.size() + 1 == ChunkCount ? Size : std::min(Size, Begin + Target);
+			const void* LineEnd = End < Size ? std::memchr(Data + End, '\n', Size - End) : nullptr;
+			End = LineEnd ? static_cast<size_t>(static_cast<const char*>(LineEnd) - Data) + 1 : Size;
+
+			Chunks.emplace_back();
+			Chunks.back().Begin = Begin;
+			Chunks.back().End = End;
+			Begin = End;
+		}
+		return Chunks;
+	}
+
+	// First pass: terminates every line with '\0' in place, since tinyobjloader's parsers expect
+	// one terminated line, and counts the lines and attributes. A '\r' before the '\n' stays;
+	// the parsers stop at it.
+	void countChunk(char* Data, ObjChunk& Chunk)
+	{
+		size_t Position = Chunk.Begin;
+		while (Position < Chunk.End)
+		{
+			char* Line = Data + Position;
+			char* LineEnd = static_cast<char*>(std::memchr(Line, '\n', Chunk.End - Position));
+			if (!LineEnd)
+				LineEnd = Data + Chunk.End;
+			*LineEnd = '\0';
+			Position = static_cast<size_t>(LineEnd - Data) + 1;
+			Chunk.Lines++;
+
+			const char* Token = Line + std::strspn(Line, " \t");
+			switch (classifyLine(Token))
+			{
+			case LineType::Position:
+				Chunk.Positions++;
+				break;
+			case LineType::Normal:
+				Chunk.Normals++;
+				break;
+			case LineType::TexCoord:
+				Chunk.TexCoords++;
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
+	// Second pass: attributes go straight into their place in the shared arrays, faces and
+	// shape names stay with the chunk
+	void parseChunk(const char* Data, ObjChunk& Chunk, ObjGeometry& Geometry)
+	{
+		PROFILE_ZONE("parseObj chunk");
+		size_t Positions = Chunk.FirstPosition;
+		size_t Normals = Chunk.FirstNormal;
+		size_t TexCoords = Chunk.FirstTexCoord;
+
+		size_t Position = Chunk.Begin;
+		for (size_t LineIndex = 0; LineIndex < Chunk.Lines; LineIndex++)
+		{
+			const char* Line = Data + Position;
+			Position += std::strlen(Line) + 1;
+
+			const char* Token = Line + std::strspn(Line, " \t");
+			switch (classifyLine(Token))
+			{
+			case LineType::Position:
+			{
+				Token += 2;
+				float* Values = &Geometry.Positions[3 * Positions++];
+				tinyobj::parseReal3(&Values[0], &Values[1], &Values[2], &Token);
+				break;
+			}
+			case LineType::Normal:
+			{
+				Token += 3;
+				float* Values = &Geometry.Normals[3 * Normals++];
+				tinyobj::parseReal3(&Values[0], &Values[1], &Values[2], &Token);
+				break;
+			}
+			case LineType::TexCoord:
+			{
+				Token += 3;
+				float* Values = &Geometry.TexCoords[2 * TexCoords++];
+				tinyobj::parseReal2(&Values[0], &Values[1], &Token);
+				break;
+			}
+			case LineType::Face:
+			{
+				// Relative (negative) indices count back from the attributes read so far
+				Token += 2;
+				Token += std::strspn(Token, " \t");
+				const tinyobj::warning_context Context{&Chunk.Warnings, Chunk.FirstLine + LineIndex + 1};
+
+				tinyobj::face_t& Face = Chunk.Faces.emplace_back();
+				Face.vertex_indices.reserve(3);
+				while (!IS_NEW_LINE(Token[0]))
+				{
+					tinyobj::vertex_index_t Index;
+					if (!tinyobj::parseTriple(&Token, static_cast<int>(Positions), static_cast<int>(Normals), static_cast<int>(TexCoords),
+						&Index, Context))
+					{
+						Chunk.Errors += "Failed to parse `f' line (e.g. a zero value for vertex index or invalid relative vertex index). Line "
+							+ std::to_string(Context.line_number) + ".\n";
+						return;
+					}
+					Face.vertex_indices.push_back(Index);
+					Token += std::strspn(Token, " \t\r");
+				}
+				break;
+			}
+			case LineType::Object:
+			{
+				std::string Name(Token + 2);
+				if (!Name.empty() && Name.back() == '\r')
+					Name.pop_back();
+				Chunk.Groups.emplace_back(Chunk.Faces.size(), std::move(Name));
+				break;
+			}
+			case LineType::Group:
+			{
+				// Like tinyobjloader, a group named by several words keeps them all
+				std::string Name;
+				tinyobj::parseString(&Token);
+				while (!IS_NEW_LINE(Token[0]))
+				{
+					const std::string Word = tinyobj::parseString(&Token);
+					Name += (Name.empty() ? "" : " ") + Word;
+					Token += std::strspn(Token, " \t\r");
+				}
+				Chunk.Groups.emplace_back(Chunk.Faces.size(), std::move(Name));
+				break;
+			}
+			default:
+				break;
+			}
+		}
+	}
+}
+
+bool parseObj(const std::string& Path, ObjGeometry& Geometry, std::string& Warnings, std::string& Errors)
+{
+	PROFILE_ZONE("parseObj");
+	Geometry = ObjGeometry();
+
+	std::ifstream File(Path, std::ios::binary | std::ios::ate);
+	if (!File.is_open())
+	{
+		Errors += "Cannot open file [" + Path + "]\n";
+		return false;
+	}
+	const size_t Size = static_cast<size_t>(File.tellg());
+	std::vector<char> Buffer(Size + 1, '\0');
+	File.seekg(0);
+	File.read(Buffer.data(), static_cast<std::streamsize>(Size));
+	char* Data = Buffer.data();
+
+	JobSystem& Jobs = JobSystem::getInstance();
+	std::vector<ObjChunk> Chunks = splitChunks(Data, Size);
+	Jobs.parallelFor(Chunks.size(), 1, [&](const size_t First, const size_t Last)
+	{
+		for (size_t I = First; I < Last; I++)
+			countChunk(Data, Chunks[I]);
+	});
+
+	size_t Lines = 0, Positions = 0, Normals = 0, TexCoords = 0;
+	for (ObjChunk& Chunk : Chunks)
+	{
+		Chunk.FirstLine = Lines;
+		Chunk.FirstPosition = Positions;
+		Chunk.FirstNormal = Normals;
+		Chunk.FirstTexCoord = TexCoords;
+		Lines += Chunk.Lines;
+		Positions += Chunk.Positions;
+		Normals += Chunk.Normals;
+		TexCoords += Chunk.TexCoords;
+	}
+	Geometry.Positions.resize(Positions * 3);
+	Geometry.Normals.resize(Normals * 3);
+	Geometry.TexCoords.resize(TexCoords * 2);
+
+	Jobs.parallelFor(Chunks.size(), 1, [&](const size_t First, const size_t Last)
+	{
+		for (size_t I = First; I < Last; I++)
+			parseChunk(Data, Chunks[I], Geometry);
+	});
+
+	for (const ObjChunk& Chunk : Chunks)
+	{
+		Warnings += Chunk.Warnings;
+		Errors += Chunk.Errors;
+	}
+	if (!Errors.empty())
+	{
+		Geometry = ObjGeometry();
+		return false;
+	}
+
+	// Cut every chunk's faces at the o and g lines into runs, each owned by one shape
+	std::vector<std::string> ShapeNames(1);
+	std::vector<FaceRun> Runs;
+	for (size_t ChunkIndex = 0; ChunkIndex < Chunks.size(); ChunkIndex++)
+	{
+		const ObjChunk& Chunk = Chunks[ChunkIndex];
+		size_t Begin = 0;
+		for (const auto& [FirstFace, Name] : Chunk.Groups)
+		{
+			if (FirstFace > Begin)
+				Runs.push_back({ShapeNames.size() - 1, ChunkIndex, Begin, FirstFace, {}, {}});
+			ShapeNames.push_back(Name);
+			Begin = FirstFace;
+		}
+		if (Chunk.Faces.size() > Begin)
+			Runs.push_back({ShapeNames.size() - 1, ChunkIndex, Begin, Chunk.Faces.size(), {}, {}});
+	}
+
+	// Triangulating needs every position, so it waits for the parse; each run is independent
+	Jobs.parallelFor(Runs.size(), 1, [&](const size_t First, const size_t Last)
+	{
+		static const std::vector<tinyobj::tag_t> NoTags;
+		for (size_t I = First; I < Last; I++)
+		{
+			FaceRun& Run = Runs[I];
+			std::vector<tinyobj::face_t>& Faces = Chunks[Run.Chunk].Faces;
+
+			tinyobj::PrimGroup Group;
+			Group.faceGroup.assign(std::make_move_iterator(Faces.begin() + Run.Begin), std::make_move_iterator(Faces.begin() + Run.End));
+			tinyobj::exportGroupsToShape(&Run.Triangles, Group, NoTags, -1, ShapeNames[Run.Shape], true, Geometry.Positions, &Run.Warnings);
+		}
+	});
+
+	// Shapes left without a triangle, such as an o line followed by a g line, are dropped
+	size_t CurrentShape = ShapeNames.size();
+	for (const FaceRun& Run : Runs)
+	{
+		Warnings += Run.Warnings;
+		if (Run.Triangles.mesh.indices.empty())
+			continue;
+
+		if (Run.Shape != CurrentShape)
+		{
+			Geometry.Shapes.push_back({ShapeNames[Run.Shape], {}});
+			CurrentShape = Run.Shape;
+		}
+
+		std::vector<tinyobj::index_t>& Corners = Geometry.Shapes.back().Corners;
+		Corners.insert(Corners.end(), Run.Triangles.mesh.indices.begin(), Run.Triangles.mesh.indices.end());
+	}
+	return true;
+}
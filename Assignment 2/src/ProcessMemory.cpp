@@ -0,0 +1,52 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : ProcessMemory.cpp
+Description : Implementations for the process memory queries
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "ProcessMemory.h"
+
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <fstream>
+#include <unistd.h>
+#endif
+
+size_t getProcessResidentBytes()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS Counters = {};
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &Counters, sizeof(Counters)))
+		return 0;
+	return Counters.WorkingSetSize;
+#else
+	// Second field of statm is the resident page count
+	std::ifstream Statm("/proc/self/statm");
+	size_t TotalPages = 0, ResidentPages = 0;
+	if (!(Statm >> TotalPages >> ResidentPages))
+		return 0;
+	return ResidentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+void printProcessMemory(const char* Label, const size_t BeforeBytes, const size_t AfterBytes)
+{
+	const double Before = static_cast<double>(BeforeBytes) / (1024.0 * 1024.0);
+	const double After = static_cast<double>(AfterBytes) / (1024.0 * 1024.0);
+	std::cout << "[Memory] " << Label << ": process RSS " << Before << " MB before switch, "
+		<< After << " MB after load (" << (After - Before >= 0.0 ? "+" : "") << After - Before << " MB)" << '\n';
+}
@@ -0,0 +1,309 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : Profiler.cpp
+Description : Implementations for Profiler class
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <unordered_map>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define PROFILER_USE_TSC
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace
+{
+	// Synthetic main-thread zone spanning each captured frame
+	const char* const FrameZoneName = "Frame";
+
+	int64_t clockNanoseconds()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	std::string escapeJson(const std::string& Text)
+	{
+		std::string Escaped;
+		for (const char Character : Text)
+		{
+			if (Character == '"' || Character == '\\')
+				Escaped += '\\';
+			Escaped += Character;
+		}
+		return Escaped;
+	}
+}
+
+Profiler& Profiler::getInstance()
+{
+	static Profiler Instance;
+	return Instance;
+}
+
+Profiler::Profiler()
+	: MTickOrigin(now()), MClockOrigin(clockNanoseconds())
+{
+}
+
+uint64_t Profiler::now()
+{
+#ifdef PROFILER_USE_TSC
+	// A few cycles to read, against tens of nanoseconds for the OS clock
+	return __rdtsc();
+#else
+	return static_cast<uint64_t>(clockNanoseconds());
+#endif
+}
+
+void Profiler::record(const char* Name, const uint64_t Start, const uint64_t End, const uint32_t Depth)
+{
+	ThreadRing& Ring = getRing();
+	const uint64_t Slot = Ring.Written.load(std::memory_order_relaxed);
+	Ring.Events[Slot & (RingSize - 1)] = {Name, Start, End, Depth, Ring.Index};
+	Ring.Written.store(Slot + 1, std::memory_order_release);
+}
+
+void Profiler::setThreadName(const std::string& Name)
+{
+	ThreadRing& Ring = getRing();
+	std::lock_guard<std::mutex> Lock(MRingsMutex);
+	Ring.Name = Name;
+}
+
+void Profiler::endFrame()
+{
+	const uint64_t Now = now();
+	calibrate();
+
+	MFrameEvents.clear();
+	drain(MFrameEvents);
+
+	if (MFrameStart != 0)
+	{
+		MLastFrameMs = ticksToMs(Now - MFrameStart);
+
+		if (MCaptureRemaining > 0)
+		{
+			MCaptured.insert(MCaptured.end(), MFrameEvents.begin(), MFrameEvents.end());
+			MCaptured.push_back({FrameZoneName, MFrameStart, Now, 0, getRing().Index});
+			MCapturedFrames++;
+
+			if (--MCaptureRemaining == 0)
+			{
+				const std::string Path = "profiles/trace_frame" + std::to_string(MFrameIndex) + ".json";
+				if (writeChromeTrace(Path))
+					std::cout << "[Profiler] Wrote " << MCapturedFrames << " frames to " << Path << '\n';
+				printFrameSummary();
+			}
+		}
+	}
+
+	MFrameStart = Now;
+	MFrameIndex++;
+}
+
+void Profiler::beginCapture(const unsigned int Frames)
+{
+	MCaptured.clear();
+	MCapturedFrames = 0;
+	MCaptureRemaining = Frames;
+	std::cout << "[Profiler] Capturing " << Frames << " frames..." << '\n';
+}
+
+bool Profiler::isCapturing() const
+{
+	return MCaptureRemaining > 0;
+}
+
+bool Profiler::writeChromeTrace(const std::string& Path) const
+{
+	std::error_code Error;
+	const std::filesystem::path Parent = std::filesystem::path(Path).parent_path();
+	if (!Parent.empty())
+		std::filesystem::create_directories(Parent, Error);
+
+	std::ofstream File(Path);
+	if (!File)
+	{
+		std::cerr << "Failed to write profiler trace: " << Path << '\n';
+		return false;
+	}
+
+	// Complete ("X") events in microseconds from the profiler's start, plus one thread_name
+	// metadata event per thread so the viewer labels the rows
+	File << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool First = true;
+	for (const ProfileEvent& Event : MCaptured)
+	{
+		File << (First ? "" : ",") << "\n{\"name\":\"" << escapeJson(Event.Name) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << Event.Thread
+			<< ",\"ts\":" << ticksToMs(Event.Start - MTickOrigin) * 1000.0 << ",\"dur\":" << ticksToMs(Event.End - Event.Start) * 1000.0 << "}";
+		First = false;
+	}
+
+	{
+		std::lock_guard<std::mutex> Lock(const_cast<std::mutex&>(MRingsMutex));
+		for (const std::unique_ptr<ThreadRing>& Ring : MRings)
+		{
+			File << (First ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << Ring->Index
+				<< ",\"args\":{\"name\":\"" << escapeJson(Ring->Name) << "\"}}";
+			First = false;
+		}
+	}
+
+	File << "\n]}\n";
+	return static_cast<bool>(File);
+}
+
+std::vector<ProfileZoneTotal> Profiler::summarize() const
+{
+	// Rebuild each thread's call stacks: sorted by start, a zone's parent is the last zone one
+	// level up that started before it
+	std::vector<ProfileEvent> Events;
+	Events.reserve(MCaptured.size());
+	for (const ProfileEvent& Event : MCaptured)
+	{
+		if (Event.Name != FrameZoneName)
+			Events.push_back(Event);
+	}
+	std::sort(Events.begin(), Events.end(), [](const ProfileEvent& A, const ProfileEvent& B)
+	{
+		if (A.Thread != B.Thread)
+			return A.Thread < B.Thread;
+		if (A.Start != B.Start)
+			return A.Start < B.Start;
+		return A.Depth < B.Depth;
+	});
+
+	std::vector<ProfileZoneTotal> Totals;
+	std::unordered_map<std::string, size_t> Index;
+	std::vector<std::string> Stack;
+	uint32_t Thread = UINT32_MAX;
+	for (const ProfileEvent& Event : Events)
+	{
+		if (Event.Thread != Thread)
+		{
+			Thread = Event.Thread;
+			Stack.clear();
+		}
+
+		Stack.resize(Event.Depth + 1);
+		Stack[Event.Depth] = (Event.Depth > 0 ? Stack[Event.Depth - 1] + "/" : std::string()) + Event.Name;
+
+		const std::string Key = std::to_string(Thread) + ":" + Stack[Event.Depth];
+		auto [Found, Inserted] = Index.emplace(Key, Totals.size());
+		if (Inserted)
+			Totals.push_back({Stack[Event.Depth], Event.Name, Thread, Event.Depth});
+
+		ProfileZoneTotal& Total = Totals[Found->second];
+		Total.Ms += ticksToMs(Event.End - Event.Start);
+		Total.Calls++;
+	}
+	return Totals;
+}
+
+void Profiler::printFrameSummary() const
+{
+	if (MCapturedFrames == 0)
+		return;
+
+	double FrameMs = 0.0;
+	for (const ProfileEvent& Event : MCaptured)
+	{
+		if (Event.Name == FrameZoneName)
+			FrameMs += ticksToMs(Event.End - Event.Start);
+	}
+
+	const double Frames = static_cast<double>(MCapturedFrames);
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << "[Profiler] " << MCapturedFrames << " frames, " << FrameMs / Frames << " ms per frame" << '\n';
+
+	uint32_t Thread = UINT32_MAX;
+	for (const ProfileZoneTotal& Total : summarize())
+	{
+		if (Total.Thread != Thread)
+		{
+			Thread = Total.Thread;
+			std::lock_guard<std::mutex> Lock(const_cast<std::mutex&>(MRingsMutex));
+			std::cout << "  " << (Thread < MRings.size() ? MRings[Thread]->Name : std::string("?")) << '\n';
+		}
+
+		std::cout << "    " << std::string(Total.Depth * 2, ' ') << Total.Name << ": " << Total.Ms / Frames << " ms, "
+			<< Total.Calls / Frames << " calls per frame" << '\n';
+	}
+	std::cout << std::defaultfloat;
+}
+
+double Profiler::getLastFrameMs() const
+{
+	return MLastFrameMs;
+}
+
+Profiler::ThreadRing& Profiler::getRing()
+{
+	thread_local ThreadRing* Ring = nullptr;
+	if (!Ring)
+	{
+		std::lock_guard<std::mutex> Lock(MRingsMutex);
+		MRings.push_back(std::make_unique<ThreadRing>());
+		Ring = MRings.back().get();
+		Ring->Index = static_cast<uint32_t>(MRings.size() - 1);
+		Ring->Name = "Thread " + std::to_string(Ring->Index);
+	}
+	return *Ring;
+}
+
+void Profiler::drain(std::vector<ProfileEvent>& Out)
+{
+	std::lock_guard<std::mutex> Lock(MRingsMutex);
+	for (const std::unique_ptr<ThreadRing>& Ring : MRings)
+	{
+		const uint64_t Written = Ring->Written.load(std::memory_order_acquire);
+		const uint64_t Start = std::max(Ring->Read, Written > RingSize ? Written - RingSize : 0);
+		const size_t Base = Out.size();
+		for (uint64_t Slot = Start; Slot < Written; Slot++)
+			Out.push_back(Ring->Events[Slot & (RingSize - 1)]);
+
+		// Drop whatever the owner overwrote while it was being copied, including the slot it may be
+		// filling now, which is published only after the write
+		const uint64_t WrittenAfter = Ring->Written.load(std::memory_order_acquire);
+		const uint64_t Oldest = WrittenAfter + 1 > RingSize ? WrittenAfter + 1 - RingSize : 0;
+		if (Oldest > Start)
+			Out.erase(Out.begin() + static_cast<ptrdiff_t>(Base), Out.begin() + static_cast<ptrdiff_t>(Base + std::min(Oldest, Written) - Start));
+
+		Ring->Read = Written;
+	}
+}
+
+double Profiler::ticksToMs(const uint64_t Ticks) const
+{
+	return static_cast<double>(Ticks) * MMsPerTick;
+}
+
+void Profiler::calibrate()
+{
+	// Ticks per millisecond from the whole run so far, which keeps getting more precise
+	const uint64_t Ticks = now() - MTickOrigin;
+	const int64_t Nanoseconds = clockNanoseconds() - MClockOrigin;
+	if (Ticks > 0 && Nanoseconds > 0)
+		MMsPerTick = static_cast<double>(Nanoseconds) / 1.0e6 / static_cast<double>(Ticks);
+}
@@ -0,0 +1,180 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : RenderQueue.cpp
+Description : Implementations for RenderQueue class
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "RenderQueue.h"
+
+#include "GLStateCache.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace
+{
+	constexpr uint64_t ProgramBits = 20;
+	constexpr uint64_t TextureBits = 20;
+	constexpr uint64_t CullBits = 1;
+	constexpr uint64_t GeometryBits = 23;
+
+	constexpr uint64_t mask(const uint64_t Bits)
+	{
+		return (uint64_t{1} << Bits) - 1;
+	}
+
+	struct BatchTiming
+	{
+		unsigned int Thread;
+		double Ms;
+	};
+}
+
+void RenderQueue::submit(const Shader& Program, const GLuint Texture, const GeometryHandle Geometry, const glm::mat4& Transform, const GLenum CullFace)
+{
+	MImmediate.draw(Program, Texture, Geometry, Transform, CullFace);
+}
+
+void RenderQueue::submit(const Shader& Program, const Model& Model, const glm::mat4& Transform, const GLenum CullFace)
+{
+	MImmediate.draw(Program, Model, Transform, CullFace);
+}
+
+void RenderQueue::record(const size_t Count, size_t BatchSize, const std::function<void(CommandBuffer&, size_t, size_t)>& Record)
+{
+	PROFILE_ZONE("RenderQueue::record");
+	BatchSize = std::max<size_t>(BatchSize, 1);
+	const size_t Batches = (Count + BatchSize - 1) / BatchSize;
+	if (Batches == 0)
+		return;
+
+	// Buffers are created on the calling thread; the jobs only fill them
+	const size_t First = MBuffersUsed;
+	while (MBuffers.size() < First + Batches)
+		MBuffers.push_back(std::make_unique<CommandBuffer>());
+	MBuffersUsed += Batches;
+
+	std::vector<BatchTiming> Timings(Batches);
+	const auto Start = std::chrono::steady_clock::now();
+	JobSystem::getInstance().parallelFor(Batches, 1, [&](const size_t FirstBatch, const size_t LastBatch)
+	{
+		for (size_t Batch = FirstBatch; Batch < LastBatch; Batch++)
+		{
+			const auto BatchStart = std::chrono::steady_clock::now();
+			const size_t Begin = Batch * BatchSize;
+			Record(*MBuffers[First + Batch], Begin, std::min(Begin + BatchSize, Count));
+			Timings[Batch] = {JobSystem::getThreadIndex(),
+				std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - BatchStart).count()};
+		}
+	});
+
+	MPendingStats.WallMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+	MPendingStats.Batches += Batches;
+	for (size_t Batch = 0; Batch < Batches; Batch++)
+	{
+		const BatchTiming& Timing = Timings[Batch];
+		if (Timing.Thread >= MPendingStats.ThreadMs.size())
+			MPendingStats.ThreadMs.resize(Timing.Thread + 1, 0.0);
+		MPendingStats.ThreadMs[Timing.Thread] += Timing.Ms;
+		MPendingStats.Packets += MBuffers[First + Batch]->size();
+	}
+}
+
+void RenderQueue::flush()
+{
+	PROFILE_ZONE("RenderQueue::flush");
+	// Sort small key/pointer pairs rather than the packets. The sort is stable, so packets with
+	// the same key keep the order they were submitted or recorded in.
+	MSorted.clear();
+	gather(MImmediate);
+	for (size_t I = 0; I < MBuffersUsed; I++)
+		gather(*MBuffers[I]);
+	std::stable_sort(MSorted.begin(), MSorted.end(), [](const SortEntry& A, const SortEntry& B) { return A.Key < B.Key; });
+
+	GLStateCache& State = GLStateCache::getInstance();
+	GeometryArena& Arena = GeometryArena::getInstance();
+
+	const Shader* Current = nullptr;
+	for (const SortEntry& Entry : MSorted)
+	{
+		const DrawPacket& Packet = *Entry.Packet;
+		if (Packet.Program != Current)
+		{
+			Current = Packet.Program;
+			Current->use();
+			Current->setInt("texture_diffuse1", 0);
+		}
+
+		State.setCullFace(Packet.CullFace);
+		State.bindTexture(0, GL_TEXTURE_2D, Packet.Texture);
+		Current->setMat4("model", Packet.Transform);
+		Arena.draw(Packet.Geometry);
+	}
+
+	resetBuffers();
+}
+
+void RenderQueue::clear()
+{
+	resetBuffers();
+}
+
+size_t RenderQueue::size() const
+{
+	size_t Total = MImmediate.size();
+	for (size_t I = 0; I < MBuffersUsed; I++)
+		Total += MBuffers[I]->size();
+	return Total;
+}
+
+const RecordStats& RenderQueue::getRecordStats() const
+{
+	return MRecordStats;
+}
+
+void RenderQueue::printRecordStats() const
+{
+	std::cout << "[RenderQueue] " << MRecordStats.Packets << " packets in " << MRecordStats.Batches << " batches, recorded in "
+		<< MRecordStats.WallMs << " ms; per thread:";
+	for (size_t Thread = 0; Thread < MRecordStats.ThreadMs.size(); Thread++)
+		std::cout << ' ' << Thread << '=' << MRecordStats.ThreadMs[Thread] << "ms";
+	std::cout << '\n';
+}
+
+uint64_t RenderQueue::makeKey(const GLuint Program, const GLuint Texture, const GLenum CullFace, const GeometryHandle Geometry)
+{
+	uint64_t Key = Program & mask(ProgramBits);
+	Key = (Key << TextureBits) | (Texture & mask(TextureBits));
+	Key = (Key << CullBits) | (CullFace == GL_FRONT ? 1u : 0u);
+	Key = (Key << GeometryBits) | (Geometry & mask(GeometryBits));
+	return Key;
+}
+
+void RenderQueue::gather(const CommandBuffer& Buffer)
+{
+	Buffer.forEach([this](const DrawPacket& Packet) { MSorted.push_back({Packet.Key, &Packet}); });
+}
+
+void RenderQueue::resetBuffers()
+{
+	MImmediate.reset();
+	for (size_t I = 0; I < MBuffersUsed; I++)
+		MBuffers[I]->reset();
+	MBuffersUsed = 0;
+
+	// The frame is over: its recording stats become the ones reported
+	if (MPendingStats.Batches > 0)
+		MRecordStats = std::move(MPendingStats);
+	MPendingStats = RecordStats();
+}
@@ -0,0 +1,255 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : ResidencyManager.cpp
+Description : Implementations for ResidencyManager class
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "ResidencyManager.h"
+
+#include "JobSystem.h"
+#include "Model.h"
+#include "Skybox.h"
+#include "Terrain.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+	double toMegabytes(const size_t Bytes)
+	{
+		return static_cast<double>(Bytes) / (1024.0 * 1024.0);
+	}
+
+	const char* policySuffix(const CpuGeometryPolicy Policy)
+	{
+		return Policy == CpuGeometryPolicy::Keep ? "|cpu" : "";
+	}
+}
+
+ResidencyManager& ResidencyManager::getInstance()
+{
+	static ResidencyManager Instance;
+	return Instance;
+}
+
+template <typename T, typename Loader, typename Measure>
+std::shared_ptr<T> ResidencyManager::acquire(const std::string& Key, Loader&& Load, Measure&& Size, std::function<void(T&)> Release)
+{
+	if (const auto Found = MAssets.find(Key); Found != MAssets.end())
+	{
+		Found->second.LastUse = MClock;
+		MStats.Hits++;
+		return std::static_pointer_cast<T>(Found->second.Object);
+	}
+
+	std::shared_ptr<T> Object = Load();
+	ResidentAsset Asset;
+	Asset.Object = Object;
+	Asset.Size = Size(*Object);
+	Asset.LastUse = MClock;
+	if (Release)
+		Asset.Release = [Raw = Object.get(), Release] { Release(*Raw); };
+
+	MTotal += Asset.Size;
+	MStats.Loads++;
+	MAssets.emplace(Key, std::move(Asset));
+	return Object;
+}
+
+std::shared_ptr<Model> ResidencyManager::acquireModel(const std::string& ModelPath, const std::string& TexturePath, const CpuGeometryPolicy Policy)
+{
+	// A copy kept for picking is a different resident asset from the draw-only one.
+	// The model destructor releases its meshes and textures, so nothing else is released.
+	return acquire<Model>(getModelKey(ModelPath, TexturePath, Policy),
+		[&] { return std::make_shared<Model>(ModelPath, TexturePath, Policy); },
+		[](const Model& Model) { return Model.getResidentSize(); },
+		nullptr);
+}
+
+std::vector<std::shared_ptr<Model>> ResidencyManager::acquireModels(const std::vector<ModelRequest>& Requests)
+{
+	PROFILE_ZONE("ResidencyManager::acquireModels");
+	std::vector<std::shared_ptr<Model>> Models(Requests.size());
+	std::vector<std::string> Keys(Requests.size());
+	std::unordered_map<std::string, size_t> Pending;
+	JobCounter Loaded;
+
+	for (size_t I = 0; I < Requests.size(); I++)
+	{
+		const ModelRequest& Request = Requests[I];
+		Keys[I] = getModelKey(Request.ModelPath, Request.TexturePath, Request.Policy);
+
+		// Resident already, or requested twice in this batch: resolved below without a job
+		if (MAssets.contains(Keys[I]) || !Pending.emplace(Keys[I], I).second)
+			continue;
+
+		// Parse and decode on a worker, then hand the upload back to this thread. acquire()
+		// and the cache are only ever touched here, on the thread waiting on Loaded.
+		JobSystem::getInstance().run([this, &Requests, &Models, &Keys, &Loaded, I]
+		{
+			auto Source = std::make_shared<ModelSource>(Model::read(Requests[I].ModelPath, Requests[I].TexturePath));
+			JobSystem::getInstance().runOnMainThread([this, &Requests, &Models, &Keys, I, Source]
+			{
+				Models[I] = acquire<Model>(Keys[I],
+					[&] { return std::make_shared<Model>(std::move(*Source), Requests[I].Policy); },
+					[](const Model& Model) { return Model.getResidentSize(); },
+					nullptr);
+			}, &Loaded);
+		}, &Loaded);
+	}
+
+	JobSystem::getInstance().wait(Loaded);
+
+	for (size_t I = 0; I < Requests.size(); I++)
+	{
+		if (!Models[I])
+			Models[I] = acquireModel(Requests[I].ModelPath, Requests[I].TexturePath, Requests[I].Policy);
+	}
+	return Models;
+}
+
+std::string ResidencyManager::getModelKey(const std::string& ModelPath, const std::string& TexturePath, const CpuGeometryPolicy Policy)
+{
+	return "model:" + ModelPath + "|" + TexturePath + policySuffix(Policy);
+}
+
+std::shared_ptr<Terrain> ResidencyManager::acquireTerrain(const HeightMapInfo& Info, const CpuGeometryPolicy Policy)
+{
+	// The terrain destructor returns its geometry to the arena, so nothing else is released
+	return acquire<Terrain>("terrain:" + Info.FilePath + "|" + std::to_string(Info.Width) + "x" + std::to_string(Info.Depth) + policySuffix(Policy),
+		[&] { return std::make_shared<Terrain>(Info, Policy); },
+		[](const Terrain& Terrain) { return Terrain.GetResidentSize(); },
+		nullptr);
+}
+
+std::shared_ptr<Skybox> ResidencyManager::acquireSkybox()
+{
+	return acquire<Skybox>("skybox:Corona",
+		[] { return std::make_shared<Skybox>(); },
+		[](const Skybox& Skybox) { return Skybox.getResidentSize(); },
+		[](Skybox& Skybox) { Skybox.cleanup(); });
+}
+
+void ResidencyManager::trim()
+{
+	PROFILE_ZONE("ResidencyManager::trim");
+	// Whatever a scene still holds counts as used now
+	MClock++;
+	for (auto& [Key, Asset] : MAssets)
+	{
+		if (Asset.Object.use_count() > 1)
+			Asset.LastUse = MClock;
+	}
+
+	if (MTotal.GpuBytes <= MBudget.GpuBytes && MTotal.CpuBytes <= MBudget.CpuBytes)
+		return;
+
+	// Candidates are the assets only the cache still references, oldest first
+	std::vector<std::unordered_map<std::string, ResidentAsset>::iterator> Candidates;
+	for (auto It = MAssets.begin(); It != MAssets.end(); ++It)
+	{
+		if (It->second.Object.use_count() == 1)
+			Candidates.push_back(It);
+	}
+	std::sort(Candidates.begin(), Candidates.end(), [](const auto& A, const auto& B) { return A->second.LastUse < B->second.LastUse; });
+
+	for (const auto& Candidate : Candidates)
+	{
+		if (MTotal.GpuBytes <= MBudget.GpuBytes && MTotal.CpuBytes <= MBudget.CpuBytes)
+			break;
+		evict(Candidate);
+	}
+
+	if (MTotal.GpuBytes > MBudget.GpuBytes || MTotal.CpuBytes > MBudget.CpuBytes)
+	{
+		std::cerr << "[Residency] over budget with only in-use assets left: " << toMegabytes(MTotal.GpuBytes) << " MB GPU, "
+			<< toMegabytes(MTotal.CpuBytes) << " MB CPU" << '\n';
+	}
+}
+
+void ResidencyManager::shutdown()
+{
+	for (auto& [Key, Asset] : MAssets)
+	{
+		if (Asset.Release)
+			Asset.Release();
+	}
+	MAssets.clear();
+	MTotal = {};
+}
+
+void ResidencyManager::setBudget(const ResidencyBudget& Budget)
+{
+	MBudget = Budget;
+	std::cout << "[Residency] budget " << toMegabytes(Budget.GpuBytes) << " MB GPU, " << toMegabytes(Budget.CpuBytes) << " MB CPU" << '\n';
+}
+
+const ResidencyBudget& ResidencyManager::getBudget() const
+{
+	return MBudget;
+}
+
+void ResidencyManager::setEvictionListener(EvictionListener Listener)
+{
+	MListener = std::move(Listener);
+}
+
+ResidentSize ResidencyManager::getResidentSize() const
+{
+	return MTotal;
+}
+
+ResidentSize ResidencyManager::getResidentSize(const std::string& Key) const
+{
+	const auto Found = MAssets.find(Key);
+	return Found == MAssets.end() ? ResidentSize{} : Found->second.Size;
+}
+
+const ResidencyStats& ResidencyManager::getStats() const
+{
+	return MStats;
+}
+
+void ResidencyManager::printStats(const char* Label) const
+{
+	std::cout << "[Residency] " << Label << ": " << MAssets.size() << " assets, " << toMegabytes(MTotal.GpuBytes) << " / "
+		<< toMegabytes(MBudget.GpuBytes) << " MB GPU, " << toMegabytes(MTotal.CpuBytes) << " / " << toMegabytes(MBudget.CpuBytes)
+		<< " MB CPU, " << MStats.Hits << " hits, " << MStats.Loads << " loads, " << MStats.Evictions << " evictions" << '\n';
+
+	for (const auto& [Key, Asset] : MAssets)
+	{
+		std::cout << "  " << Key << ": " << toMegabytes(Asset.Size.GpuBytes) << " MB GPU, " << toMegabytes(Asset.Size.CpuBytes)
+			<< " MB CPU, ";
+		if (Asset.Object.use_count() > 1)
+			std::cout << "in use" << '\n';
+		else
+			std::cout << "idle for " << MClock - Asset.LastUse << " switches" << '\n';
+	}
+}
+
+void ResidencyManager::evict(const std::unordered_map<std::string, ResidentAsset>::iterator Asset)
+{
+	const EvictionEvent Event{Asset->first, Asset->second.Size, MClock - Asset->second.LastUse};
+	std::cout << "[Residency] evicting " << Event.Key << " (" << toMegabytes(Event.Size.GpuBytes) << " MB GPU, "
+		<< toMegabytes(Event.Size.CpuBytes) << " MB CPU, idle for " << Event.IdleSwitches << " switches)" << '\n';
+
+	if (Asset->second.Release)
+		Asset->second.Release();
+	MTotal -= Asset->second.Size;
+	MStats.Evictions++;
+	MAssets.erase(Asset);
+
+	if (MListener)
+		MListener(Event);
+}
@@ -1,15 +1,29 @@
 #include "Scene.h"
+#include "GeometryArena.h"
+#include "GLStateCache.h"
+#include "GpuProfiler.h"
+#include "ProcessMemory.h"
 #include "Scene1.h"
-#include "Scene2.h"
+#include "DataScene.h"
+#include "Scene5.h"
+#include "Profiler.h"
+#include <glfw3.h>
 #include <iostream>
+#include <string>
+
+// Visible objects per command buffer when the render queue records in parallel
+constexpr size_t RecordBatchSize = 1024;
 
 void Scene::switchScene(SceneType newScene, std::unique_ptr<Scene>& currentScene, SceneType& activeScene, Camera& camera, LightManager& lightManager) {
+    PROFILE_ZONE("Scene::switchScene");
     std::cout << "Switching to new scene..." << std::endl;
 
     if (currentScene == nullptr || activeScene != newScene) {
+        const size_t residentBefore = getProcessResidentBytes();
         if (currentScene) {
             std::cout << "Cleaning up current scene..." << std::endl;
             currentScene->cleanup();  // Clean up the previous scene
+            currentScene.reset();
         }
 
         std::cout << "Attempting to create new scene..." << std::endl;
@@ -20,17 +34,38 @@ void Scene::switchScene(SceneType newScene, std::unique_ptr<Scene>& currentScene
             std::cout << "Scene1 created successfully" << std::endl;
             break;
         case SceneType::SCENE_2:
-            currentScene = std::make_unique<Scene2>(camera, lightManager);
+            currentScene = std::make_unique<DataScene>(camera, lightManager, "Scene2");
             std::cout << "Scene2 created successfully" << std::endl;
             break;
+        case SceneType::SCENE_3:
+            currentScene = std::make_unique<DataScene>(camera, lightManager, "Scene3");
+            std::cout << "Scene3 created successfully" << std::endl;
+            break;
+        case SceneType::SCENE_4:
+            currentScene = std::make_unique<DataScene>(camera, lightManager, "Scene4");
+            std::cout << "Scene4 created successfully" << std::endl;
+            break;
+        case SceneType::SCENE_5:
+            currentScene = std::make_unique<Scene5>(camera, lightManager);
+            std::cout << "Scene5 created successfully" << std::endl;
+            break;
         default:
             std::cerr << "Invalid scene type" << std::endl;
             break;
         }
 
         if (currentScene) {
+            // Assets the new scene reacquired are resident again; evict the least recently used
+            // of the rest down to the budget, then pack the geometry that survived. This has to
+            // happen before load(), which copies arena offsets into indirect draw commands.
+            ResidencyManager::getInstance().trim();
+            ResidencyManager::getInstance().printStats("after acquire");
+            GeometryArena::getInstance().defragment();
+            GeometryArena::getInstance().printStats("after acquire");
+
             currentScene->load();
             std::cout << "Scene loaded successfully" << std::endl;
+            printProcessMemory(("Scene " + std::to_string(static_cast<int>(newScene) + 1)).c_str(), residentBefore, getProcessResidentBytes());
         }
         else {
             std::cerr << "Failed to create the new scene." << std::endl;
@@ -42,3 +77,171 @@ void Scene::switchScene(SceneType newScene, std::unique_ptr<Scene>& currentScene
         std::cout << "Already in the active scene, no need to switch." << std::endl;
     }
 }
+
+void Scene::toggleRenderQueue() {
+    UseRenderQueue = !UseRenderQueue;
+    GLStateCache::getInstance().setFiltering(UseRenderQueue);
+    std::cout << "Render queue and state filtering " << (UseRenderQueue ? "on" : "off") << std::endl;
+}
+
+void Scene::bindLightingShader(Shader& lightingShader, const Camera& camera, const LightManager& lightManager, const Material& material, bool textured,
+                               float width, float height) {
+    // Every variant is a separate program, so the uniforms have to be set again after switching
+    lightingShader.selectVariant(lightManager.getShaderVariant(textured));
+    lightingShader.use();
+    lightingShader.setMat4("view", camera.getViewMatrix());
+    lightingShader.setMat4("projection", camera.getProjectionMatrix(width, height));
+    lightingShader.setVec3("viewPos", camera.VPosition);
+    lightingShader.setMaterial(material);
+    lightManager.updateLighting(lightingShader);
+}
+
+void Scene::addInstance(std::vector<ModelInstance>& instances, FrustumCuller& culler, const Model& model, const glm::mat4& transform) {
+    instances.push_back({&model, transform});
+    culler.add(model.getBoundingSphere().transformed(transform));
+}
+
+void Scene::drawVisibleInstances(const Shader& shader, const std::vector<ModelInstance>& instances, FrustumCuller& culler, const Camera& camera,
+                                 float width, float height) {
+    PROFILE_ZONE("Scene::drawVisibleInstances");
+    const std::vector<uint32_t>& Visible = culler.cull(camera.getFrustum(width, height));
+    if (UseRenderQueue) {
+        // Recorded in batches across the job system, then sorted by texture and mesh so
+        // neighbouring draws share as much bound state as possible
+        Queue.record(Visible.size(), RecordBatchSize, [&](CommandBuffer& buffer, size_t begin, size_t end) {
+            for (size_t I = begin; I < end; I++) {
+                const ModelInstance& Instance = instances[Visible[I]];
+                buffer.draw(shader, *Instance.Source, Instance.Transform);
+            }
+        });
+        Queue.flush();
+        showRecordStats();
+    }
+    else {
+        for (uint32_t Index : Visible) {
+            const ModelInstance& Instance = instances[Index];
+            shader.setMat4("model", Instance.Transform);
+            Instance.Source->draw(shader);
+        }
+    }
+
+    showCullingStats(culler.getStats().LastVisible, culler.getStats().LastCulled);
+}
+
+Entity Scene::addEntity(EntityWorld& world, const Model& model, NodeId parent, const glm::vec3& position, const glm::vec3& scale, bool textured) {
+    Entity Id = world.createEntity(parent, position, scale, model.getBoundingSphere());
+    if (Id != NullEntity) {
+        world.getRegistry().add(Id, RenderableComponent{&model, glm::vec3(1.0f), textured});
+    }
+    return Id;
+}
+
+void Scene::drawVisibleEntities(const Shader& shader, EntityWorld& world, const Camera& camera) {
+    PROFILE_ZONE("Scene::drawVisibleEntities");
+    const std::vector<Entity>& Visible = world.cull(camera.getFrustum(800, 600));
+    ComponentPool<RenderableComponent>& Renderables = world.getRegistry().getPool<RenderableComponent>();
+
+    if (UseRenderQueue) {
+        // The pools are looked up here, once, so the recording jobs only read them
+        ComponentPool<TransformComponent>& Transforms = world.getRegistry().getPool<TransformComponent>();
+        const SceneGraph& Graph = world.getGraph();
+        Queue.record(Visible.size(), RecordBatchSize, [&](CommandBuffer& buffer, size_t begin, size_t end) {
+            for (size_t I = begin; I < end; I++) {
+                const RenderableComponent* Renderable = Renderables.tryGet(Visible[I]);
+                if (Renderable == nullptr || !Renderable->Textured) {
+                    continue;
+                }
+                buffer.draw(shader, *Renderable->Source, Graph.getWorld(Transforms.get(Visible[I]).Node));
+            }
+        });
+        Queue.flush();
+        showRecordStats();
+    }
+    else {
+        for (Entity Id : Visible) {
+            const RenderableComponent* Renderable = Renderables.tryGet(Id);
+            if (Renderable == nullptr || !Renderable->Textured) {
+                continue;
+            }
+            shader.setMat4("model", world.getWorld(Id));
+            Renderable->Source->draw(shader);
+        }
+    }
+
+    showCullingStats(world.getCuller().getStats().LastVisible, world.getCuller().getStats().LastCulled);
+}
+
+void Scene::drawSolidEntities(const Shader& shader, EntityWorld& world, LightManager& lightManager) {
+    EntityRegistry& Registry = world.getRegistry();
+    for (Entity Id : world.getVisible()) {
+        const RenderableComponent* Renderable = Registry.tryGet<RenderableComponent>(Id);
+        if (Renderable == nullptr || Renderable->Textured) {
+            continue;
+        }
+
+        // Light markers show their light's colour, or black while the point lights are off
+        glm::vec3 Colour = Renderable->SolidColour;
+        if (const PointLightComponent* Light = Registry.tryGet<PointLightComponent>(Id)) {
+            Colour = lightManager.isPointLightsOn() ? lightManager.getPointLight(static_cast<int>(Light->LightIndex)).Colour : glm::vec3(0.0f);
+        }
+
+        shader.setMat4("model", world.getWorld(Id));
+        shader.setVec3("solidColor", Colour);
+        Renderable->Source->draw(shader);
+    }
+}
+
+void Scene::showRecordStats() {
+    // Per-thread recording times, every few seconds so the console stays readable
+    static double LastReport = 0.0;
+    double Now = glfwGetTime();
+    if (Now - LastReport < 5.0) {
+        return;
+    }
+    LastReport = Now;
+    Queue.printRecordStats();
+}
+
+void Scene::showGpuOverlay() {
+    static bool Showing = false;
+    static double LastUpdate = 0.0;
+    if (!GpuProfiler::getInstance().isOverlayEnabled()) {
+        if (Showing) {
+            glfwSetWindowTitle(glfwGetCurrentContext(), WindowTitle);
+            Showing = false;
+        }
+        return;
+    }
+
+    double Now = glfwGetTime();
+    if (Showing && Now - LastUpdate < 0.25) {
+        return;
+    }
+    LastUpdate = Now;
+    Showing = true;
+
+    std::string Title = std::string(WindowTitle) + " | " + GpuProfiler::getInstance().getOverlayText();
+    glfwSetWindowTitle(glfwGetCurrentContext(), Title.c_str());
+}
+
+void Scene::showCullingStats(unsigned int visible, unsigned int culled, unsigned int occluded) {
+    // The GPU overlay has the title while it is on
+    if (GpuProfiler::getInstance().isOverlayEnabled()) {
+        return;
+    }
+
+    // Title updates are slow on some platforms, so only refresh a few times a second
+    static double LastUpdate = 0.0;
+    double Now = glfwGetTime();
+    if (Now - LastUpdate < 0.25) {
+        return;
+    }
+    LastUpdate = Now;
+
+    std::string Title = std::string(WindowTitle) + " | " + std::to_string(visible) + " visible, " +
+        std::to_string(culled) + " culled";
+    if (occluded > 0) {
+        Title += " (" + std::to_string(occluded) + " occluded)";
+    }
+    glfwSetWindowTitle(glfwGetCurrentContext(), Title.c_str());
+}
@@ -1,21 +1,64 @@
 #include "Scene1.h"
+#include "GLStateCache.h"
+#include "GpuProfiler.h"
+#include "Profiler.h"
+#include <glfw3.h>
+#include <algorithm>
+#include <cstdlib>
 
 // Scale factors for models
 constexpr float ModelScaleFactor = 0.01f;
 constexpr float PlantScaleFactor = 0.005f;
 
+// Plant grid half-size limit for the =/- keys (321 x 321 cells)
+constexpr int MaxPlantGridRadius = 160;
+
+// Cells further than this from the garden centre hold a palm tree instead of a plant, so the
+// largest field is a forest of about 100k trees around the garden
+constexpr int GardenRadius = 8;
+
+// Plants and trees cross-fade to their impostors between these distances from the camera
+constexpr float ImpostorStart = 25.0f;
+constexpr float ImpostorEnd = 30.0f;
+
+// Scattered terrain plants dither out between these distances from the camera
+constexpr float VegetationFadeStart = 15.0f;
+constexpr float VegetationFadeEnd = 20.0f;
+
 Scene1::Scene1(Camera& camera, LightManager& lightManager)
     : LightingShader("resources/shaders/VertexShader.vert", "resources/shaders/FragmentShader.frag"),
     SkyboxShader("resources/shaders/SkyboxVertexShader.vert", "resources/shaders/SkyboxFragmentShader.frag"),
     TerrainShader("resources/shaders/TerrainVertexShader.vert", "resources/shaders/TerrainFragmentShader.frag"),  // Terrain shader
-    GardenPlant("resources/models/AncientEmpire/SM_Env_Garden_Plants_01.obj", "PolygonAncientWorlds_Texture_01_A.png"),
-    Tree("resources/models/AncientEmpire/SM_Env_Tree_Palm_01.obj", "PolygonAncientWorlds_Texture_01_A.png"),
-    Statue("resources/models/AncientEmpire/SM_Prop_Statue_01.obj", "PolygonAncientWorlds_Texture_01_A.png"),
+    GpuDrivenShader("resources/shaders/GpuDriven.vert", "resources/shaders/FragmentShader.frag", "#define DITHER_FADE\n"),
+    ImpostorShader("resources/shaders/Impostor.vert", "resources/shaders/FragmentShader.frag", "#define IMPOSTOR\n#define DITHER_FADE\n"),
+    VegetationShader("resources/shaders/Vegetation.vert", "resources/shaders/FragmentShader.frag", "#define DITHER_FADE\n"),
+    LSkybox(ResidencyManager::getInstance().acquireSkybox()),
     GCamera(camera),
     GLightManager(lightManager),
-    terrain(HeightMapInfo{ "resources/heightmap/Heightmap0.raw", 100, 100, 1.0f })
+    TerrainNode(InvalidNode),
+    StatueEntity(NullEntity),
+    terrain(ResidencyManager::getInstance().acquireTerrain(HeightMapInfo{ "resources/heightmap/Heightmap0.raw", 100, 100, 1.0f })),
+    UseGpuDriven(true),
+    PlantGridRadius(5),
+    UseStaticBatches(false),
+    UseImpostors(true),
+    UseVegetation(true),
+    UseOcclusion(true),
+    FrameTimeTotal{ 0.0, 0.0, 0.0, 0.0 },
+    FrameTimeCount{ 0, 0, 0, 0 }
 {
     std::cout << "Scene1 constructor called" << std::endl;
+
+    // Parsed and decoded in parallel, uploaded here as each one finishes. The CPU geometry is
+    // kept for static batching.
+    std::vector<std::shared_ptr<Model>> Models = ResidencyManager::getInstance().acquireModels({
+        { "resources/models/AncientEmpire/SM_Env_Garden_Plants_01.obj", "PolygonAncientWorlds_Texture_01_A.png", CpuGeometryPolicy::Keep },
+        { "resources/models/AncientEmpire/SM_Env_Tree_Palm_01.obj", "PolygonAncientWorlds_Texture_01_A.png", CpuGeometryPolicy::Keep },
+        { "resources/models/AncientEmpire/SM_Prop_Statue_01.obj", "PolygonAncientWorlds_Texture_01_A.png", CpuGeometryPolicy::Keep }
+    });
+    GardenPlant = Models[0];
+    Tree = Models[1];
+    Statue = Models[2];
 }
 
 void Scene1::load() {
@@ -30,108 +73,271 @@ void Scene1::load() {
     material.Specular = glm::vec3(0.5f, 0.5f, 0.5f);
     material.Shininess = 32.0f;
 
-    // Set up terrain (the terrain constructor already loads and sets it up)
-    terrain.SetupTerrain();
-}
+    // Rendered once from 64 directions; the statue is always close enough to keep its geometry
+    Impostors.bake({ GardenPlant.get(), Tree.get() });
 
-void Scene1::update(float deltaTime) {
-    // Input handling and light updates can go here
+    buildInstances();
+
+    // Ground cover on the terrain's gentler slopes, in patches, generated on the GPU as regions come into view
+    ScatterRules Rules;
+    Rules.Spacing = 1.0f;
+    Rules.Density = 0.5f;
+    Rules.Clumping = 0.7f;
+    Rules.MaxSlopeDegrees = 35.0f;
+    Rules.MinScale = 0.0015f;
+    Rules.MaxScale = 0.003f;
+    Vegetation.setTerrain(*terrain, World.getGraph().getWorld(TerrainNode));
+    Vegetation.setModel(*GardenPlant, Rules);
+    Vegetation.setDrawDistance(VegetationFadeStart, VegetationFadeEnd);
 }
 
-void Scene1::render() {
-    // Clear the screen
-    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+void Scene1::buildInstances() {
+    // Every placed model is an entity, culled as a batch every frame on the CPU or the GPU
+    GpuDriven.clearInstances();
+    World.clear();
+    int PlantsPerSide = PlantGridRadius * 2 + 1;
+    World.reserve(static_cast<size_t>(PlantsPerSide) * PlantsPerSide + 8);
+
+    // Terrain is its own root, scaled down in height (Y) more than width/depth
+    TerrainNode = World.createGroup(InvalidNode, glm::vec3(0.0f), glm::vec3(0.1f, 0.05f, 0.1f));
 
-    // Activate the terrain shader and set view/projection matrices
-    TerrainShader.use();  // Use the terrain shader
-    TerrainShader.setMat4("view", GCamera.getViewMatrix());
-    TerrainShader.setMat4("projection", GCamera.getProjectionMatrix(800, 600));
-
-    glm::mat4 modelMatrix = glm::scale(glm::mat4(1.0f), glm::vec3(0.1f, 0.05f, 0.1f)); // Scale down height (Y) more than width/depth
-    modelMatrix = glm::translate(modelMatrix, glm::vec3(0.0f, 0.0f, 0.0f)); // Adjust terrain position if necessary
-    TerrainShader.setMat4("model", modelMatrix);
-
-    terrain.DrawTerrain();  // Draw terrain
-
-    glCullFace(GL_BACK);
-    // Global translation to move models by 15 units towards the positive Z axis
-    glm::mat4 globalTranslation = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 15.0f));
-
-    // Switch to the lighting shader for other objects
-    LightingShader.use();
-    LightingShader.setMat4("view", GCamera.getViewMatrix());
-    LightingShader.setMat4("projection", GCamera.getProjectionMatrix(800, 600));
-    LightingShader.setVec3("viewPos", GCamera.VPosition);
-
-    // Set material properties for objects
-    LightingShader.setMaterial(material);
-
-    // Render garden plants as ground
-    LightingShader.setBool("useTexture", true);
-    modelMatrix = glm::mat4(1.0f);
-
-    for (int X = -5; X <= 5; X++) {
-        for (int Z = -5; Z <= 5; Z++) {
-            modelMatrix = glm::mat4(1.0f);
-            modelMatrix = glm::translate(modelMatrix, glm::vec3(X, 0.0f, Z * 0.8f));
-            modelMatrix = glm::scale(modelMatrix, glm::vec3(PlantScaleFactor));
-            modelMatrix = globalTranslation * modelMatrix;  // Apply global translation
-            LightingShader.setMat4("model", modelMatrix);
-            GardenPlant.draw(LightingShader);
+    // Garden root moves every model by 15 units towards the positive Z axis
+    NodeId Garden = World.createGroup(InvalidNode, glm::vec3(0.0f, 0.0f, 15.0f));
+
+    // Garden plants as ground, and a forest of palms once the field grows past the garden
+    for (int X = -PlantGridRadius; X <= PlantGridRadius; X++) {
+        for (int Z = -PlantGridRadius; Z <= PlantGridRadius; Z++) {
+            if (std::max(std::abs(X), std::abs(Z)) > GardenRadius) {
+                addEntity(World, *Tree, Garden, glm::vec3(X, 0.0f, Z * 0.8f), glm::vec3(ModelScaleFactor));
+            }
+            else {
+                addEntity(World, *GardenPlant, Garden, glm::vec3(X, 0.0f, Z * 0.8f), glm::vec3(PlantScaleFactor));
+            }
         }
     }
 
-    // Render trees
+    // Trees
     glm::vec3 TreePositions[] = {
         {-6.0f, 0.0f, -5.0f}, {6.0f, 0.0f, -5.0f},
         {-6.0f, 0.0f, 5.0f}, {6.0f, 0.0f, 5.0f}
     };
 
     for (glm::vec3 Pos : TreePositions) {
-        modelMatrix = glm::mat4(1.0f);
-        modelMatrix = glm::translate(modelMatrix, Pos);
-        modelMatrix = glm::scale(modelMatrix, glm::vec3(ModelScaleFactor));
-        modelMatrix = globalTranslation * modelMatrix;  // Apply global translation
-        LightingShader.setMat4("model", modelMatrix);
-        Tree.draw(LightingShader);
+        addEntity(World, *Tree, Garden, Pos, glm::vec3(ModelScaleFactor));
     }
 
-    // Render statue
-    modelMatrix = glm::mat4(1.0f);
-    modelMatrix = glm::translate(modelMatrix, glm::vec3(0.0f, 0.0f, 0.0f));
-    modelMatrix = glm::scale(modelMatrix, glm::vec3(ModelScaleFactor));
-    modelMatrix = globalTranslation * modelMatrix;  // Apply global translation
-    LightingShader.setMat4("model", modelMatrix);
-    Statue.draw(LightingShader);
+    // Statue
+    StatueEntity = addEntity(World, *Statue, Garden, glm::vec3(0.0f), glm::vec3(ModelScaleFactor));
 
-    GLightManager.updateLighting(LightingShader);  // Update lighting for shaders
+    // World matrices are computed once here; nothing in the garden moves afterwards
+    World.updateTransforms();
+    World.getRegistry().each<RenderableComponent>([this](Entity Id, const RenderableComponent& Renderable) {
+        GpuDriven.addInstance(*Renderable.Source, World.getWorld(Id));
+    });
 
-    // Render skybox
-    LSkybox.render(SkyboxShader, GCamera, 800, 600);
+    GpuDriven.setImpostors(&Impostors, ImpostorStart, ImpostorEnd);
+    GpuDriven.upload();
+
+    Batches.clear();
+    if (UseStaticBatches) {
+        buildStaticBatches();
+    }
 }
 
-void Scene1::cleanup() {
-    std::cout << "Cleaning up Scene1 resources..." << std::endl;
+void Scene1::buildStaticBatches() {
+    // Every garden model is static, so all of them merge into world-space batches
+    World.getRegistry().each<RenderableComponent>([this](Entity Id, const RenderableComponent& Renderable) {
+        Batches.add(*Renderable.Source, World.getWorld(Id));
+    });
+    if (Batches.build()) {
+        Batches.upload();
+    }
+    Batches.printStats("Scene1");
+}
 
-    // Clean up shaders
-    if (LightingShader.getId() != 0) {
-        glDeleteProgram(LightingShader.getId());
+void Scene1::update(float deltaTime) {
+    PROFILE_ZONE("Scene1::update");
+    // Free when nothing moved, which is every frame for this scene
+    World.updateTransforms();
+
+    // Track the frame time with and without Hi-Z occlusion and impostors for the GPU-driven path
+    if (UseGpuDriven) {
+        int Mode = (UseOcclusion ? 1 : 0) + (UseImpostors ? 2 : 0);
+        FrameTimeTotal[Mode] += deltaTime;
+        FrameTimeCount[Mode]++;
     }
-    if (SkyboxShader.getId() != 0) {
-        glDeleteProgram(SkyboxShader.getId());
+}
+
+void Scene1::renderOccluders() {
+    // Depth-only pre-pass of the big occluders, reduced into the Hi-Z pyramid for this frame's cull
+    GLint Viewport[4];
+    glGetIntegerv(GL_VIEWPORT, Viewport);
+
+    Occlusion.beginOccluderPass(GCamera, Viewport[2], Viewport[3]);
+    const Shader& DepthShader = Occlusion.getDepthShader();
+    DepthShader.setMat4("model", World.getGraph().getWorld(TerrainNode));
+    terrain->DrawTerrain();
+    DepthShader.setMat4("model", World.getWorld(StatueEntity));
+    Statue->draw(DepthShader);
+    Occlusion.endOccluderPass();
+}
+
+void Scene1::printFrameTimings() const {
+    const char* Labels[4] = { "frustum only", "frustum + Hi-Z", "frustum + impostors", "frustum + Hi-Z + impostors" };
+    for (int Mode = 0; Mode < 4; Mode++) {
+        if (FrameTimeCount[Mode] == 0) {
+            continue;
+        }
+        double AverageMs = FrameTimeTotal[Mode] / FrameTimeCount[Mode] * 1000.0;
+        std::cout << "Scene1: " << Labels[Mode] << " averaged " << AverageMs << " ms over " << FrameTimeCount[Mode] << " frames" << std::endl;
     }
-    if (TerrainShader.getId() != 0) {  // Clean up terrain shader
-        glDeleteProgram(TerrainShader.getId());
+}
+
+void Scene1::render() {
+    PROFILE_ZONE("Scene1::render");
+    // Clear the screen
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    {
+        PROFILE_GPU("Terrain");
+
+        // Activate the terrain shader and set view/projection matrices
+        TerrainShader.use();  // Use the terrain shader
+        TerrainShader.setMat4("view", GCamera.getViewMatrix());
+        TerrainShader.setMat4("projection", GCamera.getProjectionMatrix(800, 600));
+
+        TerrainShader.setMat4("model", World.getGraph().getWorld(TerrainNode));
+
+        terrain->DrawTerrain();  // Draw terrain
+    }
+
+    GLStateCache::getInstance().setCullFace(GL_BACK);
+
+    if (UseVegetation) {
+        {
+            PROFILE_GPU("Vegetation scatter");
+            Vegetation.update(GCamera);
+        }
+        PROFILE_GPU("Vegetation");
+        bindLightingShader(VegetationShader, GCamera, GLightManager, material, true);
+        Vegetation.draw(VegetationShader);
+        VegetationShader.flushVariantTiming();
+    }
+
+    if (UseGpuDriven) {
+        // Cull on the GPU and draw every plant, tree and statue with one indirect call
+        if (UseOcclusion) {
+            PROFILE_GPU("Occluders");
+            renderOccluders();
+        }
+        {
+            PROFILE_GPU("GPU cull");
+            GpuDriven.cull(GCamera, UseOcclusion ? &Occlusion : nullptr);
+        }
+        {
+            PROFILE_GPU("Plants, trees, statue");
+            bindLightingShader(GpuDrivenShader, GCamera, GLightManager, material, true);
+            GpuDriven.draw(GpuDrivenShader);
+            GpuDrivenShader.flushVariantTiming();
+        }
+        if (UseImpostors) {
+            PROFILE_GPU("Impostors");
+            bindLightingShader(ImpostorShader, GCamera, GLightManager, material, true);
+            GpuDriven.drawImpostors(ImpostorShader);
+            ImpostorShader.flushVariantTiming();
+        }
+
+        unsigned int Visible = GpuDriven.getVisibleCount();
+        unsigned int Occluded = GpuDriven.getOccludedCount();
+        showCullingStats(Visible, GpuDriven.getInstanceCount() - Visible - Occluded, Occluded);
+    }
+    else {
+        PROFILE_GPU("Plants, trees, statue");
+
+        // Switch to the textured lighting shader variant for other objects
+        bindLightingShader(LightingShader, GCamera, GLightManager, material, true);
+
+        // Render the plants, trees and statue that are inside the view frustum
+        if (UseStaticBatches && Batches.isUploaded()) {
+            Batches.draw(LightingShader, GCamera.getFrustum(800, 600));
+            showCullingStats(Batches.getCullingStats().LastVisible, Batches.getCullingStats().LastCulled);
+        }
+        else {
+            drawVisibleEntities(LightingShader, World, GCamera);
+        }
+
+        LightingShader.flushVariantTiming();
+    }
+
+    // Render skybox
+    LSkybox->render(SkyboxShader, GCamera, 800, 600);
+}
+
+void Scene1::handleKey(int key) {
+    switch (key) {
+    case GLFW_KEY_EQUAL:
+    case GLFW_KEY_MINUS:
+        // Grow or shrink the plant field to stress the instance count
+        PlantGridRadius = key == GLFW_KEY_EQUAL ? std::min(PlantGridRadius * 2, MaxPlantGridRadius) : std::max(PlantGridRadius / 2, 5);
+        buildInstances();
+        std::cout << "Scene1: " << World.getRegistry().getEntityCount() << " entities" << std::endl;
+        break;
+    case GLFW_KEY_G:
+        UseGpuDriven = !UseGpuDriven;
+        std::cout << "Scene1: " << (UseGpuDriven ? "GPU-driven culling and indirect draws" : "CPU culling and per-model draws") << std::endl;
+        break;
+    case GLFW_KEY_B:
+        // Built on first use and whenever the plant field changes while it is on
+        UseStaticBatches = !UseStaticBatches;
+        if (UseStaticBatches && !Batches.isUploaded()) {
+            buildStaticBatches();
+        }
+        std::cout << "Scene1: static batches " << (UseStaticBatches ? "on" : "off") << (UseGpuDriven ? " (used on the CPU path, G)" : "") << std::endl;
+        break;
+    case GLFW_KEY_I:
+        printFrameTimings();
+        UseImpostors = !UseImpostors;
+        GpuDriven.setImpostorsEnabled(UseImpostors);
+        std::cout << "Scene1: impostors beyond " << ImpostorStart << " units " << (UseImpostors ? "on" : "off") << std::endl;
+        break;
+    case GLFW_KEY_V:
+        UseVegetation = !UseVegetation;
+        std::cout << "Scene1: scattered terrain vegetation " << (UseVegetation ? "on" : "off") << std::endl;
+        Vegetation.printStats("Scene1");
+        break;
+    case GLFW_KEY_O:
+        printFrameTimings();
+        UseOcclusion = !UseOcclusion;
+        std::cout << "Scene1: Hi-Z occlusion culling " << (UseOcclusion ? "on" : "off") << std::endl;
+        break;
+    default:
+        break;
     }
+}
 
-    // Clean up models (GardenPlant, Tree, Statue)
-    GardenPlant.cleanup();
-    Tree.cleanup();
-    Statue.cleanup();
+void Scene1::cleanup() {
+    std::cout << "Cleaning up Scene1 resources..." << std::endl;
+    LightingShader.printVariantTimings();
+    GpuDrivenShader.printVariantTimings();
+    ImpostorShader.printVariantTimings();
+    VegetationShader.printVariantTimings();
+    Vegetation.printStats("Scene1");
+    World.getCuller().printStats("Scene1");
+    printFrameTimings();
 
-    // Clean up skybox
-    LSkybox.cleanup();
+    // Release shaders (the shader cache keeps the programs for the next scene)
+    LightingShader.cleanup();
+    SkyboxShader.cleanup();
+    TerrainShader.cleanup();
+    GpuDrivenShader.cleanup();
+    ImpostorShader.cleanup();
+    VegetationShader.cleanup();
+    GpuDriven.cleanup();
+    Vegetation.cleanup();
+    Impostors.cleanup();
+    Batches.clear();
+    Occlusion.cleanup();
 
-    // Clean up terrain if necessary
+    // Models, skybox and terrain stay resident for the next scene until the residency manager evicts them
 }
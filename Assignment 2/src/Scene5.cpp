@@ -0,0 +1,376 @@
+// Scene5.cpp
+#include "Scene5.h"
+#include "GpuProfiler.h"
+#include "Profiler.h"
+#include <glfw3.h>
+#include <gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// Scale factors for models
+constexpr float ModelScaleFactor = 0.01f;
+constexpr float PlantScaleFactor = 0.005f;
+constexpr float MarkerScaleFactor = 0.1f;
+
+// Light counts
+constexpr int MinLightCount = 2;
+constexpr int MaxLightCount = 1024;
+constexpr int MaxLightMarkers = 64;
+
+// Sweep timing (frames)
+constexpr int SweepWarmupFrames = 30;
+constexpr int SweepMeasureFrames = 120;
+
+// Window sizes covered by the sweep
+constexpr int SweepResolutions[][2] = {{800, 600}, {1280, 720}, {1920, 1080}};
+
+namespace {
+    // Deterministic pseudo-random value in [0, 1) per light and channel
+    float hashUnit(unsigned int index, unsigned int channel) {
+        unsigned int h = index * 747796405u + channel * 2891336453u;
+        h = ((h >> ((h >> 28u) + 4u)) ^ h) * 277803737u;
+        h = (h >> 22u) ^ h;
+        return static_cast<float>(h & 0xFFFFFFu) / 16777216.0f;
+    }
+
+    glm::vec3 hueToRgb(float hue) {
+        glm::vec3 rgb = glm::clamp(glm::abs(glm::mod(hue * 6.0f + glm::vec3(0.0f, 4.0f, 2.0f), 6.0f) - 3.0f) - 1.0f, 0.0f, 1.0f);
+        return rgb;
+    }
+
+    const char* pathName(PointLightPath path) {
+        return path == PointLightPath::Clustered ? "clustered" : "unculled";
+    }
+
+    std::string modeName(PointLightPath path, bool deferred) {
+        return deferred ? std::string("deferred") : std::string("forward_") + pathName(path);
+    }
+}
+
+Scene5::Scene5(Camera& camera, LightManager& lightManager)
+    : LightingShader("resources/shaders/VertexShader.vert", "resources/shaders/FragmentShader.frag"),
+      SkyboxShader("resources/shaders/SkyboxVertexShader.vert", "resources/shaders/SkyboxFragmentShader.frag"),
+      LSkybox(ResidencyManager::getInstance().acquireSkybox()),
+      GCamera(camera),
+      GLightManager(lightManager),
+      material(),
+      LightCount(256),
+      UseDeferred(false),
+      Time(0.0f),
+      Sweeping(false),
+      SweepStep(0),
+      SweepFrame(0),
+      SweepAccumulatedMs(0.0),
+      RestoreWidth(0),
+      RestoreHeight(0)
+{
+    std::cout << "Scene5 constructor called" << std::endl;
+
+    // Parsed and decoded in parallel, uploaded here as each one finishes
+    std::vector<std::shared_ptr<Model>> Models = ResidencyManager::getInstance().acquireModels({
+        { "resources/models/AncientEmpire/SM_Env_Garden_Plants_01.obj", "PolygonAncientWorlds_Texture_01_A.png" },
+        { "resources/models/AncientEmpire/SM_Prop_Statue_01.obj", "PolygonAncientWorlds_Texture_01_A.png" },
+        { "resources/models/Sphere/Sphere_LowPoly.obj", "" }
+    });
+    GardenPlant = Models[0];
+    Statue = Models[1];
+    Sphere = Models[2];
+}
+
+void Scene5::load() {
+    std::cout << "Loading resources for Scene5..." << std::endl;
+    GLightManager.initialize();
+    GLightManager.setPointLightPath(PointLightPath::Clustered);
+
+    material.Ambient = glm::vec3(1.0f, 1.0f, 1.0f);
+    material.Diffuse = glm::vec3(1.0f, 1.0f, 1.0f);
+    material.Specular = glm::vec3(0.5f, 0.5f, 0.5f);
+    material.Shininess = 32.0f;
+
+    // A wide field of garden plants so the lights have something to land on, plus the statue
+    Instances.clear();
+    Culler.clear();
+    glm::mat4 ModelMatrix;
+    for (int X = -10; X <= 10; X++) {
+        for (int Z = -10; Z <= 10; Z++) {
+            ModelMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(X, -1.0f, Z));
+            ModelMatrix = glm::scale(ModelMatrix, glm::vec3(PlantScaleFactor));
+            addInstance(Instances, Culler, *GardenPlant, ModelMatrix);
+        }
+    }
+
+    ModelMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -1.0f, 0.0f));
+    ModelMatrix = glm::scale(ModelMatrix, glm::vec3(ModelScaleFactor));
+    addInstance(Instances, Culler, *Statue, ModelMatrix);
+
+    generateLights(LightCount);
+    std::cout << "Scene5: " << LightCount << " point lights (=/- to change, V toggles culling, G toggles deferred, B runs the sweep)" << std::endl;
+}
+
+void Scene5::update(float deltaTime) {
+    PROFILE_ZONE("Scene5::update");
+    Time += deltaTime;
+    animateLights();
+
+    if (Sweeping) {
+        updateSweep(deltaTime);
+    }
+}
+
+void Scene5::render() {
+    PROFILE_ZONE("Scene5::render");
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    GLightManager.setSpotLightPosition(GCamera.VPosition);
+    GLightManager.setSpotLightDirection(GCamera.VFront);
+
+    GLint Viewport[4];
+    glGetIntegerv(GL_VIEWPORT, Viewport);
+    if (UseDeferred) {
+        renderDeferred(Viewport[2], Viewport[3]);
+    }
+    else {
+        renderForward(Viewport[2], Viewport[3]);
+    }
+}
+
+void Scene5::renderForward(int width, int height) {
+    PROFILE_ZONE("Scene5::renderForward");
+    // Bin the lights into clusters for this view before shading
+    {
+        PROFILE_GPU("Light clustering");
+        Clustered.update(GCamera, static_cast<float>(width), static_cast<float>(height));
+    }
+
+    {
+        PROFILE_GPU("Textured models");
+        bindLightingShader(LightingShader, GCamera, GLightManager, material, true, static_cast<float>(width), static_cast<float>(height));
+        Clustered.bind(LightingShader);
+        drawTexturedGeometry(LightingShader, width, height);
+    }
+
+    {
+        PROFILE_GPU("Light spheres");
+        bindLightingShader(LightingShader, GCamera, GLightManager, material, false, static_cast<float>(width), static_cast<float>(height));
+        Clustered.bind(LightingShader);
+        drawLightMarkers(LightingShader);
+    }
+
+    LightingShader.flushVariantTiming();
+
+    // Render skybox
+    LSkybox->render(SkyboxShader, GCamera, width, height);
+}
+
+void Scene5::renderDeferred(int width, int height) {
+    PROFILE_ZONE("Scene5::renderDeferred");
+    // Geometry once into the G-buffer, no lighting yet
+    {
+        PROFILE_GPU("G-buffer");
+        Deferred.beginGeometryPass(width, height);
+        Deferred.bindGeometryShader(GCamera, material, true);
+        drawTexturedGeometry(Deferred.getGeometryShader(), width, height);
+        Deferred.bindGeometryShader(GCamera, material, false);
+        drawLightMarkers(Deferred.getGeometryShader());
+        Deferred.getGeometryShader().flushVariantTiming();
+    }
+
+    // Point lights read the same light buffer the clustered path uploads
+    {
+        PROFILE_GPU("Deferred lighting");
+        Deferred.lightingPass(GCamera, GLightManager, Clustered.getLightBuffer(), Clustered.getLightCount(), *Sphere);
+    }
+
+    // The skybox depth tests against the lit target's copy of the scene depth
+    LSkybox->render(SkyboxShader, GCamera, width, height);
+    {
+        PROFILE_GPU("Present");
+        Deferred.present();
+    }
+}
+
+void Scene5::drawTexturedGeometry(const Shader& shader, int width, int height) {
+    drawVisibleInstances(shader, Instances, Culler, GCamera, static_cast<float>(width), static_cast<float>(height));
+}
+
+void Scene5::drawLightMarkers(const Shader& shader) const {
+    // Render markers for the first few lights
+    const std::vector<PointLight>& Lights = GLightManager.getPointLights();
+    const int Markers = std::min(static_cast<int>(Lights.size()), MaxLightMarkers);
+    for (int I = 0; I < Markers; I++) {
+        glm::mat4 ModelMatrix = glm::translate(glm::mat4(1.0f), Lights[I].Position);
+        ModelMatrix = glm::scale(ModelMatrix, glm::vec3(MarkerScaleFactor));
+        shader.setMat4("model", ModelMatrix);
+        shader.setVec3("solidColor", GLightManager.isPointLightsOn() ? Lights[I].Colour : glm::vec3(0.0f));
+        Sphere->draw(shader);
+    }
+}
+
+void Scene5::cleanup() {
+    std::cout << "Cleaning up Scene5 resources..." << std::endl;
+    LightingShader.printVariantTimings();
+    Culler.printStats("Scene5");
+
+    // Restore the default lights for the other scenes
+    GLightManager.initialize();
+
+    LightingShader.cleanup();
+    SkyboxShader.cleanup();
+    Clustered.cleanup();
+    Deferred.cleanup();
+
+    // Models and skybox stay resident for the next scene until the residency manager evicts them
+}
+
+void Scene5::handleKey(int key) {
+    if (Sweeping) {
+        return;
+    }
+
+    switch (key) {
+    case GLFW_KEY_EQUAL:
+        generateLights(std::min(LightCount * 2, MaxLightCount));
+        std::cout << "Scene5: " << LightCount << " point lights" << std::endl;
+        break;
+    case GLFW_KEY_MINUS:
+        generateLights(std::max(LightCount / 2, MinLightCount));
+        std::cout << "Scene5: " << LightCount << " point lights" << std::endl;
+        break;
+    case GLFW_KEY_V: {
+        PointLightPath Path = GLightManager.getPointLightPath() == PointLightPath::Clustered
+            ? PointLightPath::Unculled : PointLightPath::Clustered;
+        GLightManager.setPointLightPath(Path);
+        std::cout << "Scene5: point lights " << pathName(Path) << std::endl;
+        break;
+    }
+    case GLFW_KEY_G:
+        UseDeferred = !UseDeferred;
+        std::cout << "Scene5: " << (UseDeferred ? "deferred" : "forward") << " shading" << std::endl;
+        break;
+    case GLFW_KEY_B:
+        startSweep();
+        break;
+    default:
+        break;
+    }
+}
+
+void Scene5::generateLights(int count) {
+    LightCount = count;
+
+    // Short-range lights so each one only touches a few clusters
+    std::vector<PointLight>& Lights = GLightManager.getPointLights();
+    Lights.resize(count);
+    for (int I = 0; I < count; I++) {
+        Lights[I].Colour = hueToRgb(hashUnit(I, 0));
+        Lights[I].Constant = 1.0f;
+        Lights[I].Linear = 0.7f;
+        Lights[I].Quadratic = 1.8f;
+    }
+
+    animateLights();
+}
+
+void Scene5::animateLights() {
+    // Each light orbits the statue on its own radius, height and speed
+    std::vector<PointLight>& Lights = GLightManager.getPointLights();
+    for (size_t I = 0; I < Lights.size(); I++) {
+        unsigned int Index = static_cast<unsigned int>(I);
+        float Radius = 1.0f + hashUnit(Index, 1) * 10.0f;
+        float Height = -0.8f + hashUnit(Index, 2) * 2.0f;
+        float Speed = (0.2f + hashUnit(Index, 3) * 0.6f) * (hashUnit(Index, 4) < 0.5f ? -1.0f : 1.0f);
+        float Angle = hashUnit(Index, 5) * 6.2831853f + Time * Speed;
+        Lights[I].Position = glm::vec3(std::cos(Angle) * Radius, Height, std::sin(Angle) * Radius);
+    }
+
+    Clustered.uploadLights(Lights);
+}
+
+void Scene5::startSweep() {
+    SweepSteps.clear();
+    SweepResults.clear();
+    for (const auto& Resolution : SweepResolutions) {
+        for (int Count = MinLightCount; Count <= MaxLightCount; Count *= 2) {
+            SweepSteps.push_back({Count, PointLightPath::Clustered, false, Resolution[0], Resolution[1]});
+            SweepSteps.push_back({Count, PointLightPath::Unculled, false, Resolution[0], Resolution[1]});
+            SweepSteps.push_back({Count, PointLightPath::Clustered, true, Resolution[0], Resolution[1]});
+        }
+    }
+
+    Sweeping = true;
+    SweepStep = 0;
+    SweepFrame = 0;
+    SweepAccumulatedMs = 0.0;
+    glfwGetWindowSize(glfwGetCurrentContext(), &RestoreWidth, &RestoreHeight);
+
+    // Measure unthrottled frame times
+    glfwSwapInterval(0);
+
+    applySweepConfig(SweepSteps[0]);
+    std::cout << "Scene5: running light sweep (" << SweepSteps.size() << " steps)..." << std::endl;
+}
+
+void Scene5::applySweepConfig(const SweepConfig& config) {
+    generateLights(config.LightCount);
+    GLightManager.setPointLightPath(config.Path);
+    UseDeferred = config.Deferred;
+
+    // The framebuffer size callback updates the viewport; the warmup frames cover the resize
+    glfwSetWindowSize(glfwGetCurrentContext(), config.Width, config.Height);
+}
+
+void Scene5::updateSweep(float deltaTime) {
+    SweepFrame++;
+    if (SweepFrame <= SweepWarmupFrames) {
+        return;
+    }
+
+    SweepAccumulatedMs += deltaTime * 1000.0;
+    if (SweepFrame < SweepWarmupFrames + SweepMeasureFrames) {
+        return;
+    }
+
+    // Record the size actually rendered, since the window may be clamped to the monitor
+    GLint Viewport[4];
+    glGetIntegerv(GL_VIEWPORT, Viewport);
+
+    const SweepConfig& Config = SweepSteps[SweepStep];
+    SweepResults.push_back({Config, Viewport[2], Viewport[3], SweepAccumulatedMs / SweepMeasureFrames});
+    std::cout << "  " << Viewport[2] << "x" << Viewport[3] << ", " << Config.LightCount << " lights, "
+              << modeName(Config.Path, Config.Deferred) << ": " << SweepResults.back().AverageFrameMs << " ms/frame" << std::endl;
+
+    SweepStep++;
+    SweepFrame = 0;
+    SweepAccumulatedMs = 0.0;
+
+    if (SweepStep < SweepSteps.size()) {
+        applySweepConfig(SweepSteps[SweepStep]);
+        return;
+    }
+
+    Sweeping = false;
+    glfwSwapInterval(1);
+    glfwSetWindowSize(glfwGetCurrentContext(), RestoreWidth, RestoreHeight);
+    GLightManager.setPointLightPath(PointLightPath::Clustered);
+    UseDeferred = false;
+    writeSweepResults();
+}
+
+void Scene5::writeSweepResults() const {
+    std::error_code Error;
+    std::filesystem::create_directories("results", Error);
+
+    std::ofstream File("results/lighting_paths.csv", std::ios::trunc);
+    File << "width,height,lights,path,frame_ms\n";
+    for (const SweepResult& Result : SweepResults) {
+        File << Result.ViewportWidth << ',' << Result.ViewportHeight << ',' << Result.Config.LightCount << ','
+             << modeName(Result.Config.Path, Result.Config.Deferred) << ',' << Result.AverageFrameMs << '\n';
+    }
+
+    std::cout << "Scene5: light sweep written to results/lighting_paths.csv" << std::endl;
+}
@@ -0,0 +1,416 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : SceneDescription.cpp
+Description : Implementations for SceneDescription class
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "SceneDescription.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+namespace
+{
+	// Collects the records of a text description before they are packed into the binary layout
+	struct SceneBuilder
+	{
+		SceneFileHeader Header = {SceneFileMagic, SceneFileVersion, 0, 0, 0, 0, 0, 0, {0.1f, 0.1f, 0.1f}, 0};
+		std::vector<SceneModelRecord> Models;
+		std::vector<SceneTerrainRecord> Terrain;
+		std::vector<SceneGroupRecord> Groups;
+		std::vector<SceneEntityRecord> Entities;
+		std::vector<SceneLightRecord> Lights;
+		std::string Strings;
+		std::unordered_map<std::string, uint32_t> ModelNames;
+		std::unordered_map<std::string, int32_t> GroupNames;
+
+		uint32_t addString(const std::string& Value)
+		{
+			const auto Offset = static_cast<uint32_t>(Strings.size());
+			Strings.append(Value);
+			Strings.push_back('\0');
+			return Offset;
+		}
+	};
+
+	template <typename T>
+	void appendRecords(std::vector<char>& Blob, const std::vector<T>& Records)
+	{
+		const char* Bytes = reinterpret_cast<const char*>(Records.data());
+		Blob.insert(Blob.end(), Bytes, Bytes + Records.size() * sizeof(T));
+	}
+
+	bool readVec3(std::istringstream& Line, float* Out)
+	{
+		return static_cast<bool>(Line >> Out[0] >> Out[1] >> Out[2]);
+	}
+}
+
+bool SceneDescription::load(const std::string& Path)
+{
+	const bool Binary = Path.size() >= 4 && Path.compare(Path.size() - 4, 4, ".bin") == 0;
+	return Binary ? loadBinary(Path) : loadText(Path);
+}
+
+bool SceneDescription::loadText(const std::string& Path)
+{
+	std::ifstream File(Path);
+	if (!File.is_open())
+	{
+		std::cerr << "SceneDescription: failed to open " << Path << '\n';
+		return false;
+	}
+
+	SceneBuilder Builder;
+	std::string Text;
+	int LineNumber = 0;
+
+	const auto fail = [&](const std::string& Message)
+	{
+		std::cerr << "SceneDescription: " << Path << ":" << LineNumber << ": " << Message << '\n';
+		return false;
+	};
+
+	const auto findModel = [&](const std::string& Name, uint32_t& Model)
+	{
+		if (Name == "-")
+		{
+			Model = SceneNoModel;
+			return true;
+		}
+		const auto Found = Builder.ModelNames.find(Name);
+		Model = Found == Builder.ModelNames.end() ? SceneNoModel : Found->second;
+		return Found != Builder.ModelNames.end();
+	};
+
+	const auto findGroup = [&](const std::string& Name, int32_t& Group)
+	{
+		if (Name == "-")
+		{
+			Group = SceneNoParent;
+			return true;
+		}
+		const auto Found = Builder.GroupNames.find(Name);
+		Group = Found == Builder.GroupNames.end() ? SceneNoParent : Found->second;
+		return Found != Builder.GroupNames.end();
+	};
+
+	while (std::getline(File, Text))
+	{
+		LineNumber++;
+		const size_t Comment = Text.find('#');
+		if (Comment != std::string::npos)
+			Text.erase(Comment);
+
+		std::istringstream Line(Text);
+		std::string Command;
+		if (!(Line >> Command))
+			continue;
+
+		if (Command == "clear")
+		{
+			if (!readVec3(Line, Builder.Header.ClearColour))
+				return fail("expected clear r g b");
+		}
+		else if (Command == "batch")
+		{
+			std::string Mode;
+			if (!(Line >> Mode) || (Mode != "on" && Mode != "off"))
+				return fail("expected batch on|off");
+			Builder.Header.Flags = Mode == "on" ? Builder.Header.Flags | SceneStaticBatching : Builder.Header.Flags & ~SceneStaticBatching;
+		}
+		else if (Command == "terrain")
+		{
+			std::string HeightMap;
+			SceneTerrainRecord Terrain = {};
+			if (!(Line >> HeightMap >> Terrain.Width >> Terrain.Depth >> Terrain.CellSpacing) || !readVec3(Line, Terrain.Scale))
+				return fail("expected terrain heightmap width depth cellSpacing scaleX scaleY scaleZ");
+			if (!Builder.Terrain.empty())
+				return fail("only one terrain is supported");
+			Terrain.HeightMap = Builder.addString(HeightMap);
+			Builder.Terrain.push_back(Terrain);
+		}
+		else if (Command == "model")
+		{
+			std::string Name, ModelPath, Texture;
+			if (!(Line >> Name >> ModelPath >> Texture))
+				return fail("expected model name objPath texture");
+			if (Builder.ModelNames.count(Name) != 0)
+				return fail("model '" + Name + "' is already defined");
+			Builder.ModelNames[Name] = static_cast<uint32_t>(Builder.Models.size());
+			Builder.Models.push_back({Builder.addString(ModelPath), Builder.addString(Texture == "-" ? "" : Texture)});
+		}
+		else if (Command == "group")
+		{
+			std::string Name, Parent;
+			SceneGroupRecord Group = {SceneNoParent, {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}};
+			if (!(Line >> Name >> Parent) || !readVec3(Line, Group.Position))
+				return fail("expected group name parent x y z [scale]");
+			float Scale;
+			if (Line >> Scale)
+				Group.Scale[0] = Group.Scale[1] = Group.Scale[2] = Scale;
+			if (!findGroup(Parent, Group.Parent))
+				return fail("unknown group '" + Parent + "'");
+			if (Builder.GroupNames.count(Name) != 0)
+				return fail("group '" + Name + "' is already defined");
+			Builder.GroupNames[Name] = static_cast<int32_t>(Builder.Groups.size());
+			Builder.Groups.push_back(Group);
+		}
+		else if (Command == "entity" || Command == "solid" || Command == "light")
+		{
+			std::string ModelName, GroupName;
+			float Scale = 1.0f;
+			SceneEntityRecord Entity = {SceneNoModel, SceneNoParent, {}, {}, {1.0f, 1.0f, 1.0f}, 0, -1};
+			if (!(Line >> ModelName >> GroupName) || !readVec3(Line, Entity.Position) || !(Line >> Scale))
+				return fail("expected " + Command + " model group x y z scale ...");
+			if (!findModel(ModelName, Entity.Model) || (Entity.Model == SceneNoModel && Command != "light"))
+				return fail("unknown model '" + ModelName + "'");
+			if (!findGroup(GroupName, Entity.Group))
+				return fail("unknown group '" + GroupName + "'");
+			Entity.Scale[0] = Entity.Scale[1] = Entity.Scale[2] = Scale;
+			Entity.Flags = Command == "entity" ? static_cast<uint32_t>(SceneEntityTextured) : 0u;
+
+			if (Command == "solid" && !readVec3(Line, Entity.Colour))
+				return fail("expected solid model group x y z scale r g b");
+			if (Command == "light")
+			{
+				SceneLightRecord Light = {};
+				if (!readVec3(Line, Light.Colour) || !(Line >> Light.Constant >> Light.Linear >> Light.Quadratic))
+					return fail("expected light model group x y z scale r g b constant linear quadratic");
+				Entity.Light = static_cast<int32_t>(Builder.Lights.size());
+				std::memcpy(Entity.Colour, Light.Colour, sizeof(Light.Colour));
+				Builder.Lights.push_back(Light);
+			}
+			Builder.Entities.push_back(Entity);
+		}
+		else if (Command == "grid")
+		{
+			std::string ModelName, GroupName;
+			int X0, X1, Z0, Z1;
+			float Y, StepX, StepZ, Scale;
+			if (!(Line >> ModelName >> GroupName >> X0 >> X1 >> Z0 >> Z1 >> Y >> StepX >> StepZ >> Scale))
+				return fail("expected grid model group x0 x1 z0 z1 y stepX stepZ scale");
+			SceneEntityRecord Entity = {SceneNoModel, SceneNoParent, {}, {Scale, Scale, Scale}, {1.0f, 1.0f, 1.0f}, SceneEntityTextured, -1};
+			if (!findModel(ModelName, Entity.Model) || Entity.Model == SceneNoModel)
+				return fail("unknown model '" + ModelName + "'");
+			if (!findGroup(GroupName, Entity.Group))
+				return fail("unknown group '" + GroupName + "'");
+
+			for (int X = X0; X <= X1; X++)
+			{
+				for (int Z = Z0; Z <= Z1; Z++)
+				{
+					Entity.Position[0] = X * StepX;
+					Entity.Position[1] = Y;
+					Entity.Position[2] = Z * StepZ;
+					Builder.Entities.push_back(Entity);
+				}
+			}
+		}
+		else
+		{
+			return fail("unknown command '" + Command + "'");
+		}
+	}
+
+	// Pack the records into the same layout the binary file uses; the string table always ends
+	// in a null and is padded to keep the file size a multiple of 4
+	Builder.Strings.push_back('\0');
+	Builder.Strings.resize((Builder.Strings.size() + 3) & ~size_t{3}, '\0');
+	SceneFileHeader& Header = Builder.Header;
+	Header.ModelCount = static_cast<uint32_t>(Builder.Models.size());
+	Header.TerrainCount = static_cast<uint32_t>(Builder.Terrain.size());
+	Header.GroupCount = static_cast<uint32_t>(Builder.Groups.size());
+	Header.EntityCount = static_cast<uint32_t>(Builder.Entities.size());
+	Header.LightCount = static_cast<uint32_t>(Builder.Lights.size());
+	Header.StringBytes = static_cast<uint32_t>(Builder.Strings.size());
+
+	MLayout = computeLayout(Header);
+	MBlob.clear();
+	MBlob.reserve(MLayout.End);
+	const char* HeaderBytes = reinterpret_cast<const char*>(&Header);
+	MBlob.insert(MBlob.end(), HeaderBytes, HeaderBytes + sizeof(Header));
+	appendRecords(MBlob, Builder.Models);
+	appendRecords(MBlob, Builder.Terrain);
+	appendRecords(MBlob, Builder.Groups);
+	appendRecords(MBlob, Builder.Entities);
+	appendRecords(MBlob, Builder.Lights);
+	MBlob.insert(MBlob.end(), Builder.Strings.begin(), Builder.Strings.end());
+	return true;
+}
+
+bool SceneDescription::loadBinary(const std::string& Path)
+{
+	std::ifstream File(Path, std::ios::binary | std::ios::ate);
+	if (!File.is_open())
+	{
+		std::cerr << "SceneDescription: failed to open " << Path << '\n';
+		return false;
+	}
+
+	// One allocation and one read for the whole file; the records are used in place
+	const std::streamsize Size = File.tellg();
+	if (Size < static_cast<std::streamsize>(sizeof(SceneFileHeader)))
+	{
+		std::cerr << "SceneDescription: " << Path << " is too small to be a scene" << '\n';
+		MBlob.clear();
+		return false;
+	}
+
+	MBlob.resize(static_cast<size_t>(Size));
+	File.seekg(0);
+	if (!File.read(MBlob.data(), Size))
+	{
+		std::cerr << "SceneDescription: failed to read " << Path << '\n';
+		MBlob.clear();
+		return false;
+	}
+
+	MLayout = computeLayout(getHeader());
+	if (!validate(Path))
+	{
+		MBlob.clear();
+		return false;
+	}
+	return true;
+}
+
+bool SceneDescription::saveBinary(const std::string& Path) const
+{
+	std::ofstream File(Path, std::ios::binary | std::ios::trunc);
+	if (!File.is_open() || !File.write(MBlob.data(), static_cast<std::streamsize>(MBlob.size())))
+	{
+		std::cerr << "SceneDescription: failed to write " << Path << '\n';
+		return false;
+	}
+	return true;
+}
+
+bool SceneDescription::compile(const std::string& TextPath, const std::string& BinaryPath)
+{
+	SceneDescription Description;
+	if (!Description.loadText(TextPath) || !Description.saveBinary(BinaryPath))
+		return false;
+
+	const SceneFileHeader& Header = Description.getHeader();
+	std::cout << "SceneDescription: compiled " << TextPath << " -> " << BinaryPath << " (" << Header.ModelCount << " models, "
+		<< Header.GroupCount << " groups, " << Header.EntityCount << " entities, " << Header.LightCount << " lights, "
+		<< Description.getSize() << " bytes)" << '\n';
+	return true;
+}
+
+bool SceneDescription::isLoaded() const
+{
+	return !MBlob.empty();
+}
+
+size_t SceneDescription::getSize() const
+{
+	return MBlob.size();
+}
+
+const SceneFileHeader& SceneDescription::getHeader() const
+{
+	return *at<SceneFileHeader>(0);
+}
+
+std::span<const SceneModelRecord> SceneDescription::getModels() const
+{
+	return {at<SceneModelRecord>(MLayout.Models), getHeader().ModelCount};
+}
+
+const SceneTerrainRecord* SceneDescription::getTerrain() const
+{
+	return getHeader().TerrainCount > 0 ? at<SceneTerrainRecord>(MLayout.Terrain) : nullptr;
+}
+
+std::span<const SceneGroupRecord> SceneDescription::getGroups() const
+{
+	return {at<SceneGroupRecord>(MLayout.Groups), getHeader().GroupCount};
+}
+
+std::span<const SceneEntityRecord> SceneDescription::getEntities() const
+{
+	return {at<SceneEntityRecord>(MLayout.Entities), getHeader().EntityCount};
+}
+
+std::span<const SceneLightRecord> SceneDescription::getLights() const
+{
+	return {at<SceneLightRecord>(MLayout.Lights), getHeader().LightCount};
+}
+
+const char* SceneDescription::getString(const uint32_t Offset) const
+{
+	return at<char>(MLayout.Strings + Offset);
+}
+
+SceneDescription::Layout SceneDescription::computeLayout(const SceneFileHeader& Header)
+{
+	Layout Result;
+	Result.Models = sizeof(SceneFileHeader);
+	Result.Terrain = Result.Models + size_t{Header.ModelCount} * sizeof(SceneModelRecord);
+	Result.Groups = Result.Terrain + size_t{Header.TerrainCount} * sizeof(SceneTerrainRecord);
+	Result.Entities = Result.Groups + size_t{Header.GroupCount} * sizeof(SceneGroupRecord);
+	Result.Lights = Result.Entities + size_t{Header.EntityCount} * sizeof(SceneEntityRecord);
+	Result.Strings = Result.Lights + size_t{Header.LightCount} * sizeof(SceneLightRecord);
+	Result.End = Result.Strings + Header.StringBytes;
+	return Result;
+}
+
+bool SceneDescription::validate(const std::string& Path) const
+{
+	const auto fail = [&](const char* Message)
+	{
+		std::cerr << "SceneDescription: " << Path << ": " << Message << '\n';
+		return false;
+	};
+
+	const SceneFileHeader& Header = getHeader();
+	if (Header.Magic != SceneFileMagic)
+		return fail("not a compiled scene");
+	if (Header.Version != SceneFileVersion)
+		return fail("compiled for a different scene format version, recompile it");
+	if (Header.TerrainCount > 1 || MLayout.End != MBlob.size())
+		return fail("section sizes do not match the file size");
+	if (Header.StringBytes == 0 || MBlob.back() != '\0')
+		return fail("string table is not terminated");
+
+	// Every index must point inside its table before the scene is instantiated from it
+	const auto validString = [&](const uint32_t Offset) { return Offset < Header.StringBytes; };
+	for (const SceneModelRecord& Model : getModels())
+	{
+		if (!validString(Model.Path) || !validString(Model.Texture))
+			return fail("model path out of range");
+	}
+	if (const SceneTerrainRecord* Terrain = getTerrain(); Terrain != nullptr && !validString(Terrain->HeightMap))
+		return fail("terrain path out of range");
+
+	const std::span<const SceneGroupRecord> Groups = getGroups();
+	for (size_t I = 0; I < Groups.size(); I++)
+	{
+		if (Groups[I].Parent != SceneNoParent && (Groups[I].Parent < 0 || static_cast<size_t>(Groups[I].Parent) >= I))
+			return fail("group parent must come before the group");
+	}
+
+	for (const SceneEntityRecord& Entity : getEntities())
+	{
+		if (Entity.Model != SceneNoModel && Entity.Model >= Header.ModelCount)
+			return fail("entity model out of range");
+		if (Entity.Group != SceneNoParent && (Entity.Group < 0 || static_cast<uint32_t>(Entity.Group) >= Header.GroupCount))
+			return fail("entity group out of range");
+		if (Entity.Light != -1 && (Entity.Light < 0 || static_cast<uint32_t>(Entity.Light) >= Header.LightCount))
+			return fail("entity light out of range");
+	}
+	return true;
+}
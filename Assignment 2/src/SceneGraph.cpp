@@ -0,0 +1,207 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : SceneGraph.cpp
+Description : Implementations for SceneGraph class
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "SceneGraph.h"
+
+#include <gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <immintrin.h>
+
+void multiplyTransformsScalar(const NodeId* Nodes, const size_t Count, const NodeId* Parents, const glm::mat4* Local, glm::mat4* World)
+{
+	for (size_t I = 0; I < Count; I++)
+	{
+		const NodeId Node = Nodes[I];
+		World[Node] = World[Parents[Node]] * Local[Node];
+	}
+}
+
+void multiplyTransformsSse(const NodeId* Nodes, const size_t Count, const NodeId* Parents, const glm::mat4* Local, glm::mat4* World)
+{
+	// Column-major: each result column is the parent's columns weighted by one local column
+	for (size_t I = 0; I < Count; I++)
+	{
+		const NodeId Node = Nodes[I];
+		const float* A = &World[Parents[Node]][0][0];
+		const float* B = &Local[Node][0][0];
+		float* Result = &World[Node][0][0];
+
+		const __m128 A0 = _mm_loadu_ps(A);
+		const __m128 A1 = _mm_loadu_ps(A + 4);
+		const __m128 A2 = _mm_loadu_ps(A + 8);
+		const __m128 A3 = _mm_loadu_ps(A + 12);
+
+		for (int Column = 0; Column < 4; Column++)
+		{
+			const float* BColumn = B + Column * 4;
+			__m128 Sum = _mm_mul_ps(A0, _mm_set1_ps(BColumn[0]));
+			Sum = _mm_add_ps(Sum, _mm_mul_ps(A1, _mm_set1_ps(BColumn[1])));
+			Sum = _mm_add_ps(Sum, _mm_mul_ps(A2, _mm_set1_ps(BColumn[2])));
+			Sum = _mm_add_ps(Sum, _mm_mul_ps(A3, _mm_set1_ps(BColumn[3])));
+			_mm_storeu_ps(Result + Column * 4, Sum);
+		}
+	}
+}
+
+NodeId SceneGraph::createNode(const NodeId Parent, const glm::vec3& Position, const glm::quat& Rotation, const glm::vec3& Scale)
+{
+	const auto Node = static_cast<NodeId>(MParents.size());
+	const bool HasParent = Parent != InvalidNode && Parent < Node;
+
+	MParents.push_back(HasParent ? Parent : InvalidNode);
+	MDepths.push_back(HasParent ? MDepths[Parent] + 1 : 0);
+	MPositions.push_back(Position);
+	MRotations.push_back(Rotation);
+	MScales.push_back(Scale);
+	MLocal.emplace_back(1.0f);
+	MWorld.emplace_back(1.0f);
+	MFlags.push_back(LocalDirty);
+	MAnyDirty = true;
+	return Node;
+}
+
+void SceneGraph::clear()
+{
+	MParents.clear();
+	MDepths.clear();
+	MPositions.clear();
+	MRotations.clear();
+	MScales.clear();
+	MLocal.clear();
+	MWorld.clear();
+	MFlags.clear();
+	MAnyDirty = false;
+}
+
+void SceneGraph::reserve(const size_t Count)
+{
+	MParents.reserve(Count);
+	MDepths.reserve(Count);
+	MPositions.reserve(Count);
+	MRotations.reserve(Count);
+	MScales.reserve(Count);
+	MLocal.reserve(Count);
+	MWorld.reserve(Count);
+	MFlags.reserve(Count);
+}
+
+void SceneGraph::setPosition(const NodeId Node, const glm::vec3& Position)
+{
+	MPositions[Node] = Position;
+	markDirty(Node);
+}
+
+void SceneGraph::setRotation(const NodeId Node, const glm::quat& Rotation)
+{
+	MRotations[Node] = Rotation;
+	markDirty(Node);
+}
+
+void SceneGraph::setScale(const NodeId Node, const glm::vec3& Scale)
+{
+	MScales[Node] = Scale;
+	markDirty(Node);
+}
+
+unsigned int SceneGraph::update(const TransformMultiply Multiply)
+{
+	if (!MAnyDirty)
+		return 0;
+
+	// 1. One forward pass: rebuild dirty locals and inherit the parent's world-dirty flag
+	MUpdateList.clear();
+	uint32_t MaxDepth = 0;
+	for (NodeId Node = 0; Node < MParents.size(); Node++)
+	{
+		uint8_t Flags = MFlags[Node];
+		const NodeId Parent = MParents[Node];
+		if (Parent != InvalidNode && (MFlags[Parent] & WorldDirty))
+			Flags |= WorldDirty;
+
+		if (Flags & LocalDirty)
+		{
+			MLocal[Node] = glm::translate(glm::mat4(1.0f), MPositions[Node]) * glm::mat4_cast(MRotations[Node]) *
+				glm::scale(glm::mat4(1.0f), MScales[Node]);
+			Flags |= WorldDirty;
+		}
+
+		MFlags[Node] = Flags;
+		if (Flags & WorldDirty)
+		{
+			MUpdateList.push_back(Node);
+			MaxDepth = std::max(MaxDepth, MDepths[Node]);
+		}
+	}
+
+	// 2. Bucket the dirty nodes by depth; nodes at the same depth never depend on each other,
+	// so each bucket is one batch for the SIMD multiply
+	MDepthCounts.assign(MaxDepth + 2, 0);
+	for (const NodeId Node : MUpdateList)
+		MDepthCounts[MDepths[Node] + 1]++;
+	for (uint32_t Depth = 1; Depth < MDepthCounts.size(); Depth++)
+		MDepthCounts[Depth] += MDepthCounts[Depth - 1];
+
+	MSortedList.resize(MUpdateList.size());
+	MDepthCursors.assign(MDepthCounts.begin(), MDepthCounts.end() - 1);
+	for (const NodeId Node : MUpdateList)
+		MSortedList[MDepthCursors[MDepths[Node]]++] = Node;
+
+	// 3. Roots copy their local matrix, every deeper level multiplies by its already updated parents
+	for (uint32_t Depth = 0; Depth <= MaxDepth; Depth++)
+	{
+		const NodeId* Begin = MSortedList.data() + MDepthCounts[Depth];
+		const size_t Count = MDepthCounts[Depth + 1] - MDepthCounts[Depth];
+		if (Depth == 0)
+		{
+			for (size_t I = 0; I < Count; I++)
+				MWorld[Begin[I]] = MLocal[Begin[I]];
+		}
+		else
+		{
+			Multiply(Begin, Count, MParents.data(), MLocal.data(), MWorld.data());
+		}
+	}
+
+	for (const NodeId Node : MUpdateList)
+		MFlags[Node] = 0;
+	MAnyDirty = false;
+
+	return static_cast<unsigned int>(MUpdateList.size());
+}
+
+const glm::mat4& SceneGraph::getWorld(const NodeId Node) const
+{
+	return MWorld[Node];
+}
+
+const glm::mat4& SceneGraph::getLocal(const NodeId Node) const
+{
+	return MLocal[Node];
+}
+
+NodeId SceneGraph::getParent(const NodeId Node) const
+{
+	return MParents[Node];
+}
+
+size_t SceneGraph::getNodeCount() const
+{
+	return MParents.size();
+}
+
+void SceneGraph::markDirty(const NodeId Node)
+{
+	MFlags[Node] |= LocalDirty;
+	MAnyDirty = true;
+}
@@ -14,67 +14,156 @@ Mail : ayoub.ahmad@mds.ac.nz
 
 #include "Shader.h"
 
-#include <fstream>
-#include <sstream>
+#include "GLStateCache.h"
+#include "ShaderCache.h"
+
 #include <iostream>
 
-Shader::Shader(const char* vertexPath, const char* fragmentPath)
-{
-    // 1. Retrieve shader source code
-    std::string vertexCode, fragmentCode;
-    std::ifstream vShaderFile, fShaderFile;
-
-    // Ensure ifstream objects can throw exceptions
-    vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    try
-    {
-        vShaderFile.open(vertexPath);
-        fShaderFile.open(fragmentPath);
-        std::stringstream vShaderStream, fShaderStream;
-        vShaderStream << vShaderFile.rdbuf();
-        fShaderStream << fShaderFile.rdbuf();
-        vShaderFile.close();
-        fShaderFile.close();
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
-    }
-    catch (std::ifstream::failure& e)
-    {
-        std::cerr << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ" << std::endl;
-        std::cerr << "Exception message: " << e.what() << std::endl;
-    }
-
-    const char* vShaderCode = vertexCode.c_str();
-    const char* fShaderCode = fragmentCode.c_str();
-
-    // 2. Compile shaders
-    unsigned int vertex, fragment;
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, nullptr);
-    glCompileShader(vertex);
-    checkCompileErrors(vertex, "VERTEX");
-
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, nullptr);
-    glCompileShader(fragment);
-    checkCompileErrors(fragment, "FRAGMENT");
-
-    // 3. Link shaders to program
-    Id = glCreateProgram();
-    glAttachShader(Id, vertex);
-    glAttachShader(Id, fragment);
-    glLinkProgram(Id);
-    checkLinkErrors(Id);
-
-    // 4. Delete shaders as they're linked now
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
+unsigned int ShaderVariant::getKey() const
+{
+	return (HasTexture ? 1u : 0u) | (HasDirectionalLight ? 2u : 0u) | (HasSpotLight ? 4u : 0u) |
+		(static_cast<unsigned int>(NumPointLights) << 3) | (static_cast<unsigned int>(PointLights) << 24);
+}
+
+std::string ShaderVariant::getDefines() const
+{
+	std::string Defines = "#define SHADER_VARIANT\n";
+	if (HasTexture)
+		Defines += "#define HAS_TEXTURE\n";
+	if (HasDirectionalLight)
+		Defines += "#define HAS_DIR\n";
+	if (HasSpotLight)
+		Defines += "#define HAS_SPOT\n";
+	if (PointLights == PointLightPath::Clustered)
+		Defines += "#define CLUSTERED_LIGHTS\n";
+	else if (PointLights == PointLightPath::Unculled)
+		Defines += "#define UNCULLED_LIGHTS\n";
+	Defines += "#define NUM_POINT_LIGHTS " + std::to_string(NumPointLights) + "\n";
+	return Defines;
+}
+
+std::string ShaderVariant::getName() const
+{
+	std::string Name = HasTexture ? "tex" : "solid";
+	if (HasDirectionalLight)
+		Name += "+dir";
+	if (HasSpotLight)
+		Name += "+spot";
+	if (PointLights == PointLightPath::Clustered)
+		Name += "+clustered";
+	else if (PointLights == PointLightPath::Unculled)
+		Name += "+unculled";
+	else
+		Name += "+" + std::to_string(NumPointLights) + "pt";
+	return Name;
+}
+
+Shader::Shader(const char* VertexPath, const char* FragmentPath, const std::string& Defines)
+	: MVertexPath(VertexPath), MFragmentPath(FragmentPath), MDefines(Defines)
+{
+	Id = ShaderCache::getInstance().acquireProgram(VertexPath, FragmentPath, Defines);
+	MBaseId = Id;
+}
+
+void Shader::selectVariant(const ShaderVariant& Variant)
+{
+	const unsigned int Key = Variant.getKey();
+
+	// Variants are compiled the first time they are needed and kept for the lifetime of the shader
+	auto It = MVariants.find(Key);
+	if (It == MVariants.end())
+	{
+		const GLuint Program = ShaderCache::getInstance().acquireProgram(MVertexPath.c_str(), MFragmentPath.c_str(),
+		                                                                 Variant.getDefines() + MDefines);
+		It = MVariants.emplace(Key, Program).first;
+		MVariantTimings[Key].Name = Variant.getName();
+	}
+
+	if (MCurrentStartQuery == 0 || MCurrentKey != Key)
+	{
+		flushVariantTiming();
+		MCurrentKey = Key;
+		MCurrentStartQuery = acquireQuery();
+		glQueryCounter(MCurrentStartQuery, GL_TIMESTAMP);
+	}
+
+	Id = It->second;
+}
+
+void Shader::flushVariantTiming()
+{
+	if (MCurrentStartQuery != 0)
+	{
+		const GLuint EndQuery = acquireQuery();
+		glQueryCounter(EndQuery, GL_TIMESTAMP);
+		MPendingTimings.push_back({MCurrentKey, MCurrentStartQuery, EndQuery});
+		MCurrentStartQuery = 0;
+	}
+
+	collectVariantTimings();
+}
+
+void Shader::printVariantTimings() const
+{
+	if (MVariantTimings.empty())
+		return;
+
+	std::cout << "[Shader] GPU time per variant of " << MFragmentPath << '\n';
+	for (const auto& [Key, Timing] : MVariantTimings)
+	{
+		std::cout << "  " << Timing.Name << ": ";
+		if (Timing.Samples > 0)
+			std::cout << Timing.TotalMs / Timing.Samples << " ms avg over " << Timing.Samples << " samples" << '\n';
+		else
+			std::cout << "no samples" << '\n';
+	}
+}
+
+GLuint Shader::acquireQuery()
+{
+	if (!MFreeQueries.empty())
+	{
+		const GLuint Query = MFreeQueries.back();
+		MFreeQueries.pop_back();
+		return Query;
+	}
+
+	GLuint Query;
+	glGenQueries(1, &Query);
+	return Query;
+}
+
+void Shader::collectVariantTimings()
+{
+	// Results are read back a few frames late; never wait on a query that is still in flight
+	size_t Resolved = 0;
+	for (; Resolved < MPendingTimings.size(); Resolved++)
+	{
+		const PendingTiming& Pending = MPendingTimings[Resolved];
+
+		GLint Available = 0;
+		glGetQueryObjectiv(Pending.EndQuery, GL_QUERY_RESULT_AVAILABLE, &Available);
+		if (!Available)
+			break;
+
+		GLuint64 Start, End;
+		glGetQueryObjectui64v(Pending.StartQuery, GL_QUERY_RESULT, &Start);
+		glGetQueryObjectui64v(Pending.EndQuery, GL_QUERY_RESULT, &End);
+
+		ShaderVariantTiming& Timing = MVariantTimings[Pending.Key];
+		Timing.Samples++;
+		Timing.TotalMs += static_cast<double>(End - Start) / 1.0e6;
+
+		MFreeQueries.push_back(Pending.StartQuery);
+		MFreeQueries.push_back(Pending.EndQuery);
+	}
+
+	MPendingTimings.erase(MPendingTimings.begin(), MPendingTimings.begin() + static_cast<std::ptrdiff_t>(Resolved));
 }
 
 void Shader::use() const
 {
-	glUseProgram(Id);
+	GLStateCache::getInstance().useProgram(Id);
 }
 
 void Shader::setBool(const std::string& Name, const bool Value) const
@@ -87,11 +176,21 @@ void Shader::setInt(const std::string& Name, const int Value) const
 	glUniform1i(glGetUniformLocation(Id, Name.c_str()), Value);
 }
 
+void Shader::setUInt(const std::string& Name, const unsigned int Value) const
+{
+	glUniform1ui(glGetUniformLocation(Id, Name.c_str()), Value);
+}
+
 void Shader::setFloat(const std::string& Name, const float Value) const
 {
 	glUniform1f(glGetUniformLocation(Id, Name.c_str()), Value);
 }
 
+void Shader::setVec2(const std::string& Name, const glm::vec2& Value) const
+{
+	glUniform2fv(glGetUniformLocation(Id, Name.c_str()), 1, &Value[0]);
+}
+
 void Shader::setVec3(const std::string& Name, const glm::vec3& Value) const
 {
 	glUniform3fv(glGetUniformLocation(Id, Name.c_str()), 1, &Value[0]);
@@ -102,6 +201,11 @@ void Shader::setVec3(const std::string& Name, const float X, const float Y, cons
 	glUniform3f(glGetUniformLocation(Id, Name.c_str()), X, Y, Z);
 }
 
+void Shader::setUVec3(const std::string& Name, const glm::uvec3& Value) const
+{
+	glUniform3uiv(glGetUniformLocation(Id, Name.c_str()), 1, &Value[0]);
+}
+
 void Shader::setMat4(const std::string& Name, const glm::mat4& Mat) const
 {
 	glUniformMatrix4fv(glGetUniformLocation(Id, Name.c_str()), 1, GL_FALSE, &Mat[0][0]);
@@ -120,6 +224,41 @@ GLuint Shader::getId()
     return Id;
 }
 
+void Shader::cleanup()
+{
+	if (MBaseId != 0)
+	{
+		ShaderCache::getInstance().releaseProgram(MBaseId);
+		MBaseId = 0;
+	}
+
+	for (const auto& [Key, Program] : MVariants)
+	{
+		ShaderCache::getInstance().releaseProgram(Program);
+	}
+	MVariants.clear();
+	Id = 0;
+
+	// Queries still in flight are dropped along with their results
+	for (const PendingTiming& Pending : MPendingTimings)
+	{
+		MFreeQueries.push_back(Pending.StartQuery);
+		MFreeQueries.push_back(Pending.EndQuery);
+	}
+	if (MCurrentStartQuery != 0)
+	{
+		MFreeQueries.push_back(MCurrentStartQuery);
+		MCurrentStartQuery = 0;
+	}
+	MPendingTimings.clear();
+
+	if (!MFreeQueries.empty())
+	{
+		glDeleteQueries(static_cast<GLsizei>(MFreeQueries.size()), MFreeQueries.data());
+		MFreeQueries.clear();
+	}
+}
+
 void Shader::checkCompileErrors(const unsigned int Shader, const std::string& Type)
 {
 	int Success;
@@ -0,0 +1,326 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : ShaderCache.cpp
+Description : Implementations for ShaderCache class
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "ShaderCache.h"
+
+#include "Shader.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t BinaryMagic = 0x43425053; // "SPBC"
+	constexpr uint32_t BinaryVersion = 1;
+
+	struct BinaryHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint64_t Key;
+		uint32_t Format;
+		uint32_t Length;
+	};
+
+	double elapsedMs(const std::chrono::steady_clock::time_point Start)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+	}
+}
+
+uint64_t hashBytes(const void* Data, const size_t Size, uint64_t Seed)
+{
+	// FNV-1a, good enough for cache keys and stable across runs
+	const auto* Bytes = static_cast<const unsigned char*>(Data);
+	for (size_t I = 0; I < Size; I++)
+	{
+		Seed ^= Bytes[I];
+		Seed *= 1099511628211ull;
+	}
+	return Seed;
+}
+
+ShaderCache& ShaderCache::getInstance()
+{
+	static ShaderCache Instance;
+	return Instance;
+}
+
+GLuint ShaderCache::acquireProgram(const char* VertexPath, const char* FragmentPath, const std::string& Defines)
+{
+	const std::vector<ShaderStage> Stages = {
+		{GL_VERTEX_SHADER, "VERTEX", injectDefines(readSource(VertexPath), Defines)},
+		{GL_FRAGMENT_SHADER, "FRAGMENT", injectDefines(readSource(FragmentPath), Defines)}
+	};
+	return acquire(Stages, std::string(VertexPath) + " + " + FragmentPath);
+}
+
+GLuint ShaderCache::acquireComputeProgram(const char* ComputePath, const std::string& Defines)
+{
+	const std::vector<ShaderStage> Stages = {
+		{GL_COMPUTE_SHADER, "COMPUTE", injectDefines(readSource(ComputePath), Defines)}
+	};
+	return acquire(Stages, ComputePath);
+}
+
+GLuint ShaderCache::acquire(const std::vector<ShaderStage>& Stages, const std::string& Label)
+{
+	const auto Start = std::chrono::steady_clock::now();
+	const std::string& Driver = getDriverString();
+
+	uint64_t Key = hashBytes(Driver.data(), Driver.size());
+	for (const ShaderStage& Stage : Stages)
+	{
+		Key = hashBytes(&Stage.Type, sizeof(Stage.Type), Key);
+		Key = hashBytes(Stage.Source.data(), Stage.Source.size(), Key);
+	}
+
+	// 1. Already resident in this process (e.g. shared with the previous scene)
+	if (const auto It = MPrograms.find(Key); It != MPrograms.end())
+	{
+		It->second.RefCount++;
+		MStats.MemoryHits++;
+		return It->second.Program;
+	}
+
+	// 2. Driver-specific binary from a previous run
+	GLuint Program = loadBinary(Key);
+	if (Program != 0)
+	{
+		const double Ms = elapsedMs(Start);
+		MStats.DiskHits++;
+		MStats.DiskHitMs += Ms;
+		std::cout << "[ShaderCache] " << Label << ": binary cache hit in " << Ms << " ms" << '\n';
+	}
+	else
+	{
+		// 3. Compile from source and store the binary for next time
+		Program = compileProgram(Stages);
+		saveBinary(Key, Program);
+
+		const double Ms = elapsedMs(Start);
+		MStats.SourceCompiles++;
+		MStats.SourceCompileMs += Ms;
+		std::cout << "[ShaderCache] " << Label << ": compiled from source in " << Ms << " ms" << '\n';
+	}
+
+	MPrograms[Key] = {Program, 1};
+	return Program;
+}
+
+void ShaderCache::releaseProgram(const GLuint Program)
+{
+	// Programs stay resident at zero references so the next scene can reuse them
+	for (auto& [Key, Cached] : MPrograms)
+	{
+		if (Cached.Program == Program && Cached.RefCount > 0)
+		{
+			Cached.RefCount--;
+			return;
+		}
+	}
+}
+
+void ShaderCache::shutdown()
+{
+	for (const auto& [Key, Cached] : MPrograms)
+	{
+		glDeleteProgram(Cached.Program);
+	}
+	MPrograms.clear();
+}
+
+void ShaderCache::printStats() const
+{
+	std::cout << "[ShaderCache] " << MPrograms.size() << " resident programs" << '\n';
+	std::cout << "  source compiles : " << MStats.SourceCompiles << " (" << MStats.SourceCompileMs << " ms total";
+	if (MStats.SourceCompiles > 0)
+		std::cout << ", " << MStats.SourceCompileMs / MStats.SourceCompiles << " ms avg";
+	std::cout << ")" << '\n';
+	std::cout << "  binary hits     : " << MStats.DiskHits << " (" << MStats.DiskHitMs << " ms total";
+	if (MStats.DiskHits > 0)
+		std::cout << ", " << MStats.DiskHitMs / MStats.DiskHits << " ms avg";
+	std::cout << ")" << '\n';
+	std::cout << "  binary rejects  : " << MStats.DiskRejects << '\n';
+	std::cout << "  in-process hits : " << MStats.MemoryHits << '\n';
+}
+
+const ShaderCacheStats& ShaderCache::getStats() const
+{
+	return MStats;
+}
+
+std::string ShaderCache::readSource(const char* Path)
+{
+	std::ifstream File;
+	File.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+	try
+	{
+		File.open(Path);
+		std::stringstream Stream;
+		Stream << File.rdbuf();
+		return Stream.str();
+	}
+	catch (std::ifstream::failure& E)
+	{
+		std::cerr << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << Path << std::endl;
+		std::cerr << "Exception message: " << E.what() << std::endl;
+	}
+	return {};
+}
+
+std::string ShaderCache::injectDefines(const std::string& Source, const std::string& Defines)
+{
+	if (Defines.empty())
+		return Source;
+
+	// #version must stay the first directive, so the defines go on the line after it
+	const size_t Version = Source.find("#version");
+	if (Version == std::string::npos)
+		return Defines + Source;
+
+	const size_t LineEnd = Source.find('\n', Version);
+	if (LineEnd == std::string::npos)
+		return Source + '\n' + Defines;
+
+	return Source.substr(0, LineEnd + 1) + Defines + Source.substr(LineEnd + 1);
+}
+
+const std::string& ShaderCache::getDriverString()
+{
+	if (MDriverString.empty())
+	{
+		const auto* Vendor = reinterpret_cast<const char*>(glGetString(GL_VENDOR));
+		const auto* Renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+		const auto* Version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+		MDriverString = std::string(Vendor ? Vendor : "") + '|' + (Renderer ? Renderer : "") + '|' + (Version ? Version : "");
+	}
+	return MDriverString;
+}
+
+std::string ShaderCache::getBinaryPath(const uint64_t Key) const
+{
+	char Name[32];
+	std::snprintf(Name, sizeof(Name), "%016llx.bin", static_cast<unsigned long long>(Key));
+	return MCacheDirectory + '/' + Name;
+}
+
+GLuint ShaderCache::loadBinary(const uint64_t Key)
+{
+	std::ifstream File(getBinaryPath(Key), std::ios::binary);
+	if (!File)
+		return 0;
+
+	BinaryHeader Header = {};
+	File.read(reinterpret_cast<char*>(&Header), sizeof(Header));
+	if (!File || Header.Magic != BinaryMagic || Header.Version != BinaryVersion || Header.Key != Key || Header.Length == 0)
+	{
+		MStats.DiskRejects++;
+		return 0;
+	}
+
+	std::vector<char> Blob(Header.Length);
+	File.read(Blob.data(), static_cast<std::streamsize>(Blob.size()));
+	if (!File)
+	{
+		MStats.DiskRejects++;
+		return 0;
+	}
+
+	const GLuint Program = glCreateProgram();
+	glProgramBinary(Program, Header.Format, Blob.data(), static_cast<GLsizei>(Blob.size()));
+
+	// The driver may reject a binary after an update even when the version string matches
+	int Success;
+	glGetProgramiv(Program, GL_LINK_STATUS, &Success);
+	if (!Success)
+	{
+		std::cout << "[ShaderCache] Binary " << getBinaryPath(Key) << " rejected by driver, recompiling" << '\n';
+		glDeleteProgram(Program);
+		MStats.DiskRejects++;
+		return 0;
+	}
+
+	return Program;
+}
+
+void ShaderCache::saveBinary(const uint64_t Key, const GLuint Program) const
+{
+	int Linked = 0;
+	glGetProgramiv(Program, GL_LINK_STATUS, &Linked);
+	if (!Linked)
+		return;
+
+	int Formats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &Formats);
+	if (Formats == 0)
+		return;
+
+	int Length = 0;
+	glGetProgramiv(Program, GL_PROGRAM_BINARY_LENGTH, &Length);
+	if (Length <= 0)
+		return;
+
+	std::vector<char> Blob(Length);
+	GLenum Format = 0;
+	glGetProgramBinary(Program, Length, nullptr, &Format, Blob.data());
+
+	std::error_code Error;
+	std::filesystem::create_directories(MCacheDirectory, Error);
+
+	std::ofstream File(getBinaryPath(Key), std::ios::binary | std::ios::trunc);
+	if (!File)
+	{
+		std::cerr << "[ShaderCache] Could not write " << getBinaryPath(Key) << '\n';
+		return;
+	}
+
+	const BinaryHeader Header = {BinaryMagic, BinaryVersion, Key, Format, static_cast<uint32_t>(Length)};
+	File.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+	File.write(Blob.data(), static_cast<std::streamsize>(Blob.size()));
+}
+
+GLuint ShaderCache::compileProgram(const std::vector<ShaderStage>& Stages)
+{
+	const GLuint Program = glCreateProgram();
+	glProgramParameteri(Program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+	std::vector<unsigned int> Shaders;
+	for (const ShaderStage& Stage : Stages)
+	{
+		const char* Code = Stage.Source.c_str();
+		const unsigned int StageShader = glCreateShader(Stage.Type);
+		glShaderSource(StageShader, 1, &Code, nullptr);
+		glCompileShader(StageShader);
+		Shader::checkCompileErrors(StageShader, Stage.Name);
+		glAttachShader(Program, StageShader);
+		Shaders.push_back(StageShader);
+	}
+
+	glLinkProgram(Program);
+	Shader::checkLinkErrors(Program);
+
+	// Shaders can be deleted once they are linked into the program
+	for (const unsigned int StageShader : Shaders)
+	{
+		glDeleteShader(StageShader);
+	}
+
+	return Program;
+}
@@ -14,7 +14,10 @@ Mail : ayoub.ahmad@mds.ac.nz
 
 #include "Skybox.h"
 
-#include "stb_image.h"
+#include "GLStateCache.h"
+#include "GpuProfiler.h"
+#include "Mesh.h"
+#include "Profiler.h"
 
 #include <iostream>
 
@@ -27,21 +30,19 @@ Skybox::Skybox()
 		"resources/skybox/Corona/Back.png",
 		"resources/skybox/Corona/Front.png" };
 
-	MCubeMapTexture = loadCubeMap(Faces);
+	MCubeMapTexture = loadCubeMap(Faces, MCubeMapBytes);
 	setupSkybox();
 }
 
 void Skybox::draw(const Shader& Shader) const
 {
-	glBindVertexArray(MVao);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, MCubeMapTexture);
-	glDrawArrays(GL_TRIANGLES, 0, 36);
-	glBindVertexArray(0);
+	GLStateCache::getInstance().bindTexture(0, GL_TEXTURE_CUBE_MAP, MCubeMapTexture);
+	GeometryArena::getInstance().draw(MGeometry);
 }
 
 void Skybox::render(const Shader& skyboxShader, const Camera& camera, int scrWidth, int scrHeight) const
 {
+	PROFILE_GPU("Skybox");
 	glDepthFunc(GL_LEQUAL); // Ensure skybox is drawn correctly
 	skyboxShader.use();
 	skyboxShader.setMat4("view", glm::mat4(glm::mat3(camera.getViewMatrix())));  // Remove translation component of view matrix
@@ -53,10 +54,10 @@ void Skybox::render(const Shader& skyboxShader, const Camera& camera, int scrWid
 void Skybox::cleanup() {
 	std::cout << "Cleaning up Skybox resources..." << std::endl;
 
-	// Clean up VAO
-	if (MVao != 0) {
-		glDeleteVertexArrays(1, &MVao);
-		MVao = 0;
+	// Return the cube to the geometry arena
+	if (MGeometry != InvalidGeometry) {
+		GeometryArena::getInstance().release(MGeometry);
+		MGeometry = InvalidGeometry;
 	}
 
 	// Clean up the cubemap texture
@@ -66,6 +67,11 @@ void Skybox::cleanup() {
 	}
 }
 
+ResidentSize Skybox::getResidentSize() const
+{
+	return {MCubeMapBytes + GeometryArena::getInstance().getByteSize(MGeometry), 0};
+}
+
 void Skybox::setupSkybox()
 {
 	constexpr float SkyboxVertices[] = {
@@ -113,37 +119,42 @@ void Skybox::setupSkybox()
 		1.0f, -1.0f, 1.0f
 	};
 
-	glGenVertexArrays(1, &MVao);
-	glGenBuffers(1, &MVbo);
-	glBindVertexArray(MVao);
-	glBindBuffer(GL_ARRAY_BUFFER, MVbo);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(SkyboxVertices), &SkyboxVertices, GL_STATIC_DRAW);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), static_cast<void*>(nullptr));
-	glBindVertexArray(0);
+	// Stored in the shared arena layout; the skybox shader only reads the position
+	constexpr unsigned int VertexCount = sizeof(SkyboxVertices) / (3 * sizeof(float));
+	std::vector<Vertex> Vertices(VertexCount);
+	std::vector<unsigned int> Indices(VertexCount);
+	for (unsigned int I = 0; I < VertexCount; I++)
+	{
+		Vertices[I].Position = glm::vec3(SkyboxVertices[I * 3], SkyboxVertices[I * 3 + 1], SkyboxVertices[I * 3 + 2]);
+		Vertices[I].Normal = glm::vec3(0.0f);
+		Vertices[I].TexCoords = glm::vec2(0.0f);
+		Indices[I] = I;
+	}
+	MGeometry = GeometryArena::getInstance().allocate(Vertices, Indices);
 }
 
-unsigned int Skybox::loadCubeMap(const std::vector<std::string>& Faces)
+unsigned int Skybox::loadCubeMap(const std::vector<std::string>& Faces, size_t& Bytes)
 {
+	PROFILE_ZONE("Skybox::loadCubeMap");
+	const std::vector<DecodedImage> Images = decodeFaces(Faces);
+
 	unsigned int TextureId;
 	glGenTextures(1, &TextureId);
 	glBindTexture(GL_TEXTURE_CUBE_MAP, TextureId);
 
-	int Width, Height, NrComponents;
-	for (unsigned int I = 0; I < Faces.size(); I++)
+	for (unsigned int I = 0; I < Images.size(); I++)
 	{
-		unsigned char* Data = stbi_load(Faces[I].c_str(), &Width, &Height, &NrComponents, 0);
-		if (Data)
+		const DecodedImage& Image = Images[I];
+		if (Image.Pixels)
 		{
 			glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + I,
-			             0, GL_RGB, Width, Height, 0, GL_RGB, GL_UNSIGNED_BYTE, Data
+			             0, GL_RGB, Image.Width, Image.Height, 0, GL_RGB, GL_UNSIGNED_BYTE, Image.Pixels.get()
 			);
-			stbi_image_free(Data);
+			Bytes += static_cast<size_t>(Image.Width) * Image.Height * 4;
 		}
 		else
 		{
 			std::cerr << "Cubemap texture failed to load at path: " << Faces[I] << '\n';
-			stbi_image_free(Data);
 		}
 	}
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -154,3 +165,13 @@ unsigned int Skybox::loadCubeMap(const std::vector<std::string>& Faces)
 
 	return TextureId;
 }
+
+std::vector<DecodedImage> Skybox::decodeFaces(const std::vector<std::string>& Faces)
+{
+	// decodeImage flips like model textures, which is how the faces have always loaded
+	std::vector<DecodedImage> Images;
+	Images.reserve(Faces.size());
+	for (const std::string& Face : Faces)
+		Images.push_back(decodeImage(Face));
+	return Images;
+}
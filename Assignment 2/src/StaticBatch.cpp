@@ -0,0 +1,246 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : StaticBatch.cpp
+Description : Implementations for StaticBatcher class
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "StaticBatch.h"
+
+#include "JobSystem.h"
+#include "Model.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <immintrin.h>
+#include <iostream>
+#include <tuple>
+#include <unordered_set>
+
+namespace
+{
+	static_assert(sizeof(Vertex) == 8 * sizeof(float), "transformVertices loads a vertex as two 4-float registers");
+
+	// Batches are keyed by texture, then by grid cell of the instance origin
+	using ClusterKey = std::tuple<unsigned int, int, int, int>;
+
+	// Positions by the full transform, normals by its inverse transpose and renormalised, since the
+	// batched vertices are drawn with an identity model matrix. A vertex is [px py pz nx][ny nz u v].
+	void transformVertices(const Vertex* Source, Vertex* Target, const size_t Count, const glm::mat4& Transform)
+	{
+		const glm::mat3 Normal = glm::transpose(glm::inverse(glm::mat3(Transform)));
+		const __m128 P0 = _mm_loadu_ps(&Transform[0][0]);
+		const __m128 P1 = _mm_loadu_ps(&Transform[1][0]);
+		const __m128 P2 = _mm_loadu_ps(&Transform[2][0]);
+		const __m128 P3 = _mm_loadu_ps(&Transform[3][0]);
+		const __m128 N0 = _mm_setr_ps(Normal[0][0], Normal[0][1], Normal[0][2], 0.0f);
+		const __m128 N1 = _mm_setr_ps(Normal[1][0], Normal[1][1], Normal[1][2], 0.0f);
+		const __m128 N2 = _mm_setr_ps(Normal[2][0], Normal[2][1], Normal[2][2], 0.0f);
+		const __m128 Tiny = _mm_set1_ps(1e-30f);
+
+		const float* In = &Source->Position.x;
+		float* Out = &Target->Position.x;
+		for (size_t I = 0; I < Count; I++, In += 8, Out += 8)
+		{
+			const __m128 A = _mm_loadu_ps(In);
+			const __m128 B = _mm_loadu_ps(In + 4);
+
+			__m128 Position = _mm_add_ps(_mm_mul_ps(P0, _mm_shuffle_ps(A, A, _MM_SHUFFLE(0, 0, 0, 0))), P3);
+			Position = _mm_add_ps(Position, _mm_mul_ps(P1, _mm_shuffle_ps(A, A, _MM_SHUFFLE(1, 1, 1, 1))));
+			Position = _mm_add_ps(Position, _mm_mul_ps(P2, _mm_shuffle_ps(A, A, _MM_SHUFFLE(2, 2, 2, 2))));
+
+			__m128 Direction = _mm_mul_ps(N0, _mm_shuffle_ps(A, A, _MM_SHUFFLE(3, 3, 3, 3)));
+			Direction = _mm_add_ps(Direction, _mm_mul_ps(N1, _mm_shuffle_ps(B, B, _MM_SHUFFLE(0, 0, 0, 0))));
+			Direction = _mm_add_ps(Direction, _mm_mul_ps(N2, _mm_shuffle_ps(B, B, _MM_SHUFFLE(1, 1, 1, 1))));
+
+			// Length squared in every lane; a zero normal stays zero
+			const __m128 Squared = _mm_mul_ps(Direction, Direction);
+			__m128 Length = _mm_add_ps(Squared, _mm_shuffle_ps(Squared, Squared, _MM_SHUFFLE(2, 3, 0, 1)));
+			Length = _mm_add_ps(Length, _mm_shuffle_ps(Length, Length, _MM_SHUFFLE(1, 0, 3, 2)));
+			Direction = _mm_div_ps(Direction, _mm_sqrt_ps(_mm_max_ps(Length, Tiny)));
+
+			// [px py pz nx] and [ny nz u v]
+			const __m128 High = _mm_shuffle_ps(Position, Direction, _MM_SHUFFLE(0, 0, 2, 2));
+			_mm_storeu_ps(Out, _mm_shuffle_ps(Position, High, _MM_SHUFFLE(2, 0, 1, 0)));
+			_mm_storeu_ps(Out + 4, _mm_shuffle_ps(Direction, B, _MM_SHUFFLE(3, 2, 2, 1)));
+		}
+	}
+
+	double toMegabytes(const size_t Bytes)
+	{
+		return static_cast<double>(Bytes) / (1024.0 * 1024.0);
+	}
+}
+
+bool StaticBatcher::add(const Model& Source, const glm::mat4& Transform)
+{
+	for (const Mesh& Part : Source.getMeshes())
+	{
+		if (!Part.hasCpuGeometry())
+			return false;
+	}
+
+	MStats.Instances++;
+	for (const Mesh& Part : Source.getMeshes())
+	{
+		MItems.push_back({&Part.getVertices(), &Part.getIndices(), &Part.Textures, Transform, 0, 0, 0});
+		MStats.SourceDraws++;
+	}
+	return true;
+}
+
+void StaticBatcher::add(const std::vector<Vertex>& Vertices, const std::vector<unsigned int>& Indices,
+	const std::vector<Texture>& Textures, const glm::mat4& Transform)
+{
+	MStats.Instances++;
+	MStats.SourceDraws++;
+	MItems.push_back({&Vertices, &Indices, &Textures, Transform, 0, 0, 0});
+}
+
+bool StaticBatcher::build()
+{
+	const auto Start = std::chrono::steady_clock::now();
+	MPending.clear();
+
+	std::vector<std::pair<ClusterKey, size_t>> Order;
+	Order.reserve(MItems.size());
+	std::unordered_set<const std::vector<Vertex>*> Sources;
+	for (size_t I = 0; I < MItems.size(); I++)
+	{
+		const Item& Entry = MItems[I];
+		const glm::vec3 Origin(Entry.Transform[3]);
+		const unsigned int Texture = Entry.Textures->empty() ? 0 : Entry.Textures->front().Id;
+		Order.push_back({{Texture, static_cast<int>(std::floor(Origin.x / CellSize)), static_cast<int>(std::floor(Origin.y / CellSize)),
+			static_cast<int>(std::floor(Origin.z / CellSize))}, I});
+
+		if (Sources.insert(Entry.Vertices).second)
+			MStats.SourceBytes += Entry.Vertices->size() * sizeof(Vertex) + Entry.Indices->size() * sizeof(unsigned int);
+	}
+	std::stable_sort(Order.begin(), Order.end(), [](const auto& A, const auto& B) { return A.first < B.first; });
+
+	// Lay the meshes out in their batches, splitting a cluster once it reaches MaxBatchVertices
+	std::vector<size_t> VertexCounts;
+	std::vector<size_t> IndexCounts;
+	for (size_t I = 0; I < Order.size(); I++)
+	{
+		Item& Entry = MItems[Order[I].second];
+		const bool NewCluster = I == 0 || Order[I].first != Order[I - 1].first;
+		if (NewCluster || VertexCounts.back() + Entry.Vertices->size() > MaxBatchVertices)
+		{
+			MPending.push_back({*Entry.Textures, {}, {}});
+			VertexCounts.push_back(0);
+			IndexCounts.push_back(0);
+		}
+
+		Entry.Batch = MPending.size() - 1;
+		Entry.FirstVertex = VertexCounts.back();
+		Entry.FirstIndex = IndexCounts.back();
+		VertexCounts.back() += Entry.Vertices->size();
+		IndexCounts.back() += Entry.Indices->size();
+	}
+
+	size_t Bytes = 0;
+	for (size_t I = 0; I < MPending.size(); I++)
+		Bytes += VertexCounts[I] * sizeof(Vertex) + IndexCounts[I] * sizeof(unsigned int);
+	MStats.BatchBytes = Bytes;
+
+	if (Bytes > MaxBatchBytes)
+	{
+		std::cout << "StaticBatcher: " << MStats.Instances << " instances would take " << toMegabytes(Bytes) << " MB batched, over the "
+			<< toMegabytes(MaxBatchBytes) << " MB limit; drawing them per model" << '\n';
+		MPending.clear();
+		MItems.clear();
+		MStats.Batches = 0;
+		return false;
+	}
+
+	for (size_t I = 0; I < MPending.size(); I++)
+	{
+		MPending[I].Vertices.resize(VertexCounts[I]);
+		MPending[I].Indices.resize(IndexCounts[I]);
+	}
+
+	// Every mesh writes its own range of its batch, so they transform independently
+	JobSystem::getInstance().parallelFor(MItems.size(), 16, [this](const size_t Begin, const size_t End)
+	{
+		for (size_t I = Begin; I < End; I++)
+		{
+			const Item& Entry = MItems[I];
+			PendingBatch& Batch = MPending[Entry.Batch];
+			transformVertices(Entry.Vertices->data(), Batch.Vertices.data() + Entry.FirstVertex, Entry.Vertices->size(), Entry.Transform);
+
+			const unsigned int Base = static_cast<unsigned int>(Entry.FirstVertex);
+			unsigned int* Target = Batch.Indices.data() + Entry.FirstIndex;
+			for (const unsigned int Index : *Entry.Indices)
+				*Target++ = Index + Base;
+		}
+	});
+
+	MItems.clear();
+	MStats.Batches = static_cast<unsigned int>(MPending.size());
+	MStats.BuildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+	return true;
+}
+
+void StaticBatcher::upload()
+{
+	MBatches.reserve(MBatches.size() + MPending.size());
+	for (PendingBatch& Batch : MPending)
+	{
+		// Bounds are computed by the mesh and are already in world space
+		Mesh Merged(std::move(Batch.Vertices), std::move(Batch.Indices), CpuGeometryPolicy::Release);
+		Merged.Textures = std::move(Batch.Textures);
+		MCuller.add(Merged.Sphere);
+		MBatches.push_back(std::move(Merged));
+	}
+	MPending.clear();
+}
+
+void StaticBatcher::clear()
+{
+	MItems.clear();
+	MPending.clear();
+	MBatches.clear();
+	MCuller.clear();
+	MStats = {};
+}
+
+void StaticBatcher::draw(const Shader& Shader, const Frustum& Frustum)
+{
+	if (MBatches.empty())
+		return;
+
+	Shader.setMat4("model", glm::mat4(1.0f));
+	for (const uint32_t Index : MCuller.cull(Frustum))
+		MBatches[Index].draw(Shader);
+}
+
+bool StaticBatcher::isUploaded() const
+{
+	return !MBatches.empty();
+}
+
+const StaticBatchStats& StaticBatcher::getStats() const
+{
+	return MStats;
+}
+
+const CullingStats& StaticBatcher::getCullingStats() const
+{
+	return MCuller.getStats();
+}
+
+void StaticBatcher::printStats(const std::string& Label) const
+{
+	std::cout << Label << ": static batching " << MStats.Instances << " instances, " << MStats.SourceDraws << " mesh draws -> "
+		<< MStats.Batches << " batches; " << toMegabytes(MStats.SourceBytes) << " MB shared meshes vs " << toMegabytes(MStats.BatchBytes)
+		<< " MB batched, built in " << MStats.BuildMs << " ms" << '\n';
+}
@@ -1,71 +1,91 @@
 #include "Terrain.h"
+#include "GLStateCache.h"
+#include "JobSystem.h"
+#include "Profiler.h"
 #include <iostream>
 #include <fstream>
 #include <vector>
 #include <glm.hpp>
 #include <glew.h>
 
+// Rows per job when the terrain passes are split across the job system
+constexpr size_t TerrainRowsPerJob = 16;
+
 // Constructor for Terrain, takes in HeightMapInfo
-Terrain::Terrain(const HeightMapInfo& info) : terrainInfo(info) {
-    LoadHeightMap();  // Load the heightmap data
-    SmoothHeights();  // Apply smoothing
-    SmoothHeights();  // Apply multiple times
-    SmoothHeights();
-    SmoothHeights();
-    SmoothHeights();
+Terrain::Terrain(const HeightMapInfo& info, CpuGeometryPolicy policy) : terrainInfo(info), geometry(InvalidGeometry), heightTexture(0) {
+    PROFILE_ZONE("Terrain::Terrain");
+    heightmap = LoadHeightMap(terrainInfo);  // Load the heightmap data
+    SmoothHeights(heightmap, terrainInfo);  // Apply smoothing
+    SmoothHeights(heightmap, terrainInfo);  // Apply multiple times
+    SmoothHeights(heightmap, terrainInfo);
+    SmoothHeights(heightmap, terrainInfo);
+    SmoothHeights(heightmap, terrainInfo);
     SetupTerrain();   // Set up the terrain mesh
+
+    // The arena holds everything drawing needs; only height queries would read the map again
+    if (policy == CpuGeometryPolicy::Release) {
+        std::vector<float>().swap(heightmap);
+    }
 }
 
-// Destructor for Terrain, cleans up buffers
+// Destructor for Terrain, returns its vertex and index ranges to the geometry arena
 Terrain::~Terrain() {
-    glDeleteVertexArrays(1, &vao);
-    glDeleteBuffers(1, &vbo);
-    glDeleteBuffers(1, &ebo);
+    GeometryArena::getInstance().release(geometry);
+    glDeleteTextures(1, &heightTexture);
 }
 
 // Function to load heightmap from a raw file
-void Terrain::LoadHeightMap() {
-    terrainInfo.Width = 512;  // Set the terrain width to match heightmap resolution
-    terrainInfo.Depth = 512;  // Set the terrain depth to match heightmap resolution
+std::vector<float> Terrain::LoadHeightMap(HeightMapInfo& info) {
+    info.Width = 512;  // Set the terrain width to match heightmap resolution
+    info.Depth = 512;  // Set the terrain depth to match heightmap resolution
 
-    unsigned int VertexCount = terrainInfo.Width * terrainInfo.Depth;
+    unsigned int VertexCount = info.Width * info.Depth;
 
     // Temporary vector to hold raw byte data
     std::vector<unsigned char> HeightValue(VertexCount);
 
     // Open the file in binary mode
-    std::ifstream file(terrainInfo.FilePath, std::ios_base::binary);
+    std::ifstream file(info.FilePath, std::ios_base::binary);
     if (file) {
         file.read(reinterpret_cast<char*>(&HeightValue[0]), static_cast<std::streamsize>(HeightValue.size()));
         file.close();
     }
     else {
-        std::cerr << "Error: Could not load heightmap file: " << terrainInfo.FilePath << std::endl;
-        return;
+        std::cerr << "Error: Could not load heightmap file: " << info.FilePath << std::endl;
+        return {};
     }
 
     // Normalize heightmap values to [0, 1]
-    heightmap.resize(VertexCount, 0.0f);
+    std::vector<float> heightmap(VertexCount, 0.0f);
     for (unsigned int i = 0; i < VertexCount; i++) {
         heightmap[i] = static_cast<float>(HeightValue[i]) / 255.0f;  // Normalize byte values to [0, 1]
     }
+    return heightmap;
 }
 
 // Function to smooth heightmap by averaging neighboring heights
-void Terrain::SmoothHeights() {
+void Terrain::SmoothHeights(std::vector<float>& heightmap, const HeightMapInfo& info) {
+    PROFILE_ZONE("Terrain::SmoothHeights");
+    if (heightmap.empty()) {
+        return;
+    }
+
     std::vector<float> smoothedMap(heightmap.size());
 
-    for (unsigned int row = 0; row < terrainInfo.Width; row++) {
-        for (unsigned int col = 0; col < terrainInfo.Depth; col++) {
-            smoothedMap[row * terrainInfo.Depth + col] = Average(row, col);
+    // Each row only reads the previous pass, so rows smooth independently
+    JobSystem::getInstance().parallelFor(info.Width, TerrainRowsPerJob, [&](size_t firstRow, size_t lastRow) {
+        for (unsigned int row = static_cast<unsigned int>(firstRow); row < lastRow; row++) {
+            for (unsigned int col = 0; col < info.Depth; col++) {
+                smoothedMap[row * info.Depth + col] = Average(heightmap, info, row, col);
+            }
         }
-    }
+    });
 
-    heightmap = smoothedMap;
+    heightmap.swap(smoothedMap);
 }
 
 // Helper function to calculate the average height of neighboring vertices
-float Terrain::Average(unsigned int row, unsigned int col) {
+float Terrain::Average(const std::vector<float>& heightmap, const HeightMapInfo& info, unsigned int row, unsigned int col) {
     float sum = 0.0f;
     int count = 0;
 
@@ -74,8 +94,8 @@ float Terrain::Average(unsigned int row, unsigned int col) {
             int newRow = row + i;
             int newCol = col + j;
 
-            if (newRow >= 0 && newRow < (int)terrainInfo.Width && newCol >= 0 && newCol < (int)terrainInfo.Depth) {
-                sum += heightmap[newRow * terrainInfo.Depth + newCol];
+            if (newRow >= 0 && newRow < (int)info.Width && newCol >= 0 && newCol < (int)info.Depth) {
+                sum += heightmap[newRow * info.Depth + newCol];
                 count++;
             }
         }
@@ -85,117 +105,150 @@ float Terrain::Average(unsigned int row, unsigned int col) {
 
 // Function to set up the terrain mesh (vertices, indices, normals)
 void Terrain::SetupTerrain() {
+    if (heightmap.empty()) {
+        std::cerr << "Error: No heightmap data to build terrain from (not loaded, or released after upload): " << terrainInfo.FilePath << std::endl;
+        return;
+    }
     SetupMesh();  // Set up the vertex positions, normals, and texture coordinates
+    SetupHeightTexture();
 }
 
 // Function to generate vertex positions, texture coordinates, and normals
 void Terrain::SetupMesh() {
+    PROFILE_ZONE("Terrain::SetupMesh");
     unsigned int VertexCount = terrainInfo.Width * terrainInfo.Depth;
     std::vector<Vertex> Vertices(VertexCount);
 
     float HalfWidth = (terrainInfo.Width - 1) * terrainInfo.CellSpacing * 0.5f;
     float HalfDepth = (terrainInfo.Depth - 1) * terrainInfo.CellSpacing * 0.5f;
-    float HeightScale = 1000.0f;  // Adjust as needed
 
     // Iterate through the terrain grid and assign height values from the heightmap
-    for (unsigned int row = 0; row < terrainInfo.Depth; row++) {
-        float PosZ = HalfDepth - (row * terrainInfo.CellSpacing);  // Z position (depth)
+    JobSystem::getInstance().parallelFor(terrainInfo.Depth, TerrainRowsPerJob, [&](size_t firstRow, size_t lastRow) {
+        for (unsigned int row = static_cast<unsigned int>(firstRow); row < lastRow; row++) {
+            float PosZ = HalfDepth - (row * terrainInfo.CellSpacing);  // Z position (depth)
 
-        for (unsigned int col = 0; col < terrainInfo.Width; col++) {
-            unsigned int Index = row * terrainInfo.Width + col;  // Index in heightmap
+            for (unsigned int col = 0; col < terrainInfo.Width; col++) {
+                unsigned int Index = row * terrainInfo.Width + col;  // Index in heightmap
 
-            float PosX = -HalfWidth + (col * terrainInfo.CellSpacing);  // X position (width)
-            float PosY = heightmap[Index] * HeightScale;  // Apply heightmap to Y
+                float PosX = -HalfWidth + (col * terrainInfo.CellSpacing);  // X position (width)
+                float PosY = heightmap[Index] * HeightScale;  // Apply heightmap to Y
 
-            // Set the vertex position (X, Y, Z)
-            Vertices[Index].Position = glm::vec3(PosX, PosY, PosZ);
+                // Set the vertex position (X, Y, Z)
+                Vertices[Index].Position = glm::vec3(PosX, PosY, PosZ);
+            }
         }
-    }
+    });
 
 
     // Generate normals for the terrain vertices
-    GenerateNormals(Vertices);
-
-    // Set up OpenGL buffers (VAO, VBO, EBO)
-    glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
-    glBindVertexArray(vao);
-
-    // Fill VBO with vertex data
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, Vertices.size() * sizeof(Vertex), &Vertices[0], GL_STATIC_DRAW);
+    GenerateNormals(heightmap, terrainInfo, Vertices);
 
-    // Set up vertex attributes (position, texture coordinates, normals)
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0); // Position
-    glEnableVertexAttribArray(0);
+    // Upload into the shared geometry arena, replacing any previous upload
+    std::vector<GLuint> Indices;
+    SetupIndexBuffer(terrainInfo, Indices);
 
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords)); // TexCoord
-    glEnableVertexAttribArray(1);
+    GeometryArena::getInstance().release(geometry);
+    geometry = GeometryArena::getInstance().allocate(Vertices, Indices);
+}
 
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal)); // Normal
-    glEnableVertexAttribArray(2);
+// Function to upload the heightmap as a texture, one texel per vertex
+void Terrain::SetupHeightTexture() {
+    if (heightTexture == 0) {
+        glGenTextures(1, &heightTexture);
+        glBindTexture(GL_TEXTURE_2D, heightTexture);
+        glTexStorage2D(GL_TEXTURE_2D, 1, GL_R32F, terrainInfo.Width, terrainInfo.Depth);
+
+        // Read with texelFetch, so no filtering
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    else {
+        glBindTexture(GL_TEXTURE_2D, heightTexture);
+    }
 
-    SetupIndexBuffer();
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, terrainInfo.Width, terrainInfo.Depth, GL_RED, GL_FLOAT, heightmap.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
 
-    glBindVertexArray(0);
+    // Bound behind the state cache's back
+    GLStateCache::getInstance().invalidate();
 }
 
 // Function to generate normals for the terrain vertices
-void Terrain::GenerateNormals(std::vector<Vertex>& Vertices) {
-    float inverseCellSpacing = 1.0f / (2.0f * terrainInfo.CellSpacing);
+void Terrain::GenerateNormals(const std::vector<float>& heightmap, const HeightMapInfo& info, std::vector<Vertex>& Vertices) {
+    float inverseCellSpacing = 1.0f / (2.0f * info.CellSpacing);
 
-    for (unsigned int row = 0; row < terrainInfo.Width; row++) {
-        for (unsigned int col = 0; col < terrainInfo.Depth; col++) {
-            float rowNeg = (row == 0) ? heightmap[row * terrainInfo.Depth + col] : heightmap[(row - 1) * terrainInfo.Depth + col];
-            float rowPos = (row == terrainInfo.Width - 1) ? heightmap[row * terrainInfo.Depth + col] : heightmap[(row + 1) * terrainInfo.Depth + col];
-            float colNeg = (col == 0) ? heightmap[row * terrainInfo.Depth + col] : heightmap[row * terrainInfo.Depth + (col - 1)];
-            float colPos = (col == terrainInfo.Depth - 1) ? heightmap[row * terrainInfo.Depth + col] : heightmap[row * terrainInfo.Depth + (col + 1)];
+    JobSystem::getInstance().parallelFor(info.Width, TerrainRowsPerJob, [&](size_t firstRow, size_t lastRow) {
+        for (unsigned int row = static_cast<unsigned int>(firstRow); row < lastRow; row++) {
+            for (unsigned int col = 0; col < info.Depth; col++) {
+                float rowNeg = (row == 0) ? heightmap[row * info.Depth + col] : heightmap[(row - 1) * info.Depth + col];
+                float rowPos = (row == info.Width - 1) ? heightmap[row * info.Depth + col] : heightmap[(row + 1) * info.Depth + col];
+                float colNeg = (col == 0) ? heightmap[row * info.Depth + col] : heightmap[row * info.Depth + (col - 1)];
+                float colPos = (col == info.Depth - 1) ? heightmap[row * info.Depth + col] : heightmap[row * info.Depth + (col + 1)];
 
-            float x = rowNeg - rowPos;
-            if (row == 0 || row == terrainInfo.Width - 1) x *= 2.0f;
+                float x = rowNeg - rowPos;
+                if (row == 0 || row == info.Width - 1) x *= 2.0f;
 
-            float y = colPos - colNeg;
-            if (col == 0 || col == terrainInfo.Depth - 1) y *= 2.0f;
+                float y = colPos - colNeg;
+                if (col == 0 || col == info.Depth - 1) y *= 2.0f;
 
-            glm::vec3 tangentZ(0.0f, x * inverseCellSpacing, 1.0f);
-            glm::vec3 tangentX(1.0f, y * inverseCellSpacing, 0.0f);
+                glm::vec3 tangentZ(0.0f, x * inverseCellSpacing, 1.0f);
+                glm::vec3 tangentX(1.0f, y * inverseCellSpacing, 0.0f);
 
-            glm::vec3 normal = glm::cross(tangentZ, tangentX);
-            normal = glm::normalize(normal);
+                glm::vec3 normal = glm::cross(tangentZ, tangentX);
+                normal = glm::normalize(normal);
 
-            Vertices[row * terrainInfo.Depth + col].Normal = normal;
+                Vertices[row * info.Depth + col].Normal = normal;
+            }
         }
-    }
+    });
 }
 
-// Function to set up the index buffer (EBO)
-void Terrain::SetupIndexBuffer() {
-    unsigned int FaceCount = (terrainInfo.Width - 1) * (terrainInfo.Depth - 1) * 2;
+// Function to build the triangle indices of the grid
+void Terrain::SetupIndexBuffer(const HeightMapInfo& info, std::vector<GLuint>& Indices) {
+    unsigned int FaceCount = (info.Width - 1) * (info.Depth - 1) * 2;
     unsigned int DrawCount = FaceCount * 3; // 3 indices per triangle
-    std::vector<GLuint> Indices(DrawCount);
-
-    int Index = 0;
-    for (unsigned int row = 0; row < (terrainInfo.Depth - 1); row++) {
-        for (unsigned int col = 0; col < (terrainInfo.Width - 1); col++) {
-            Indices[Index++] = row * terrainInfo.Width + col;
-            Indices[Index++] = (row + 1) * terrainInfo.Width + col;
-            Indices[Index++] = row * terrainInfo.Width + (col + 1);
-
-            Indices[Index++] = row * terrainInfo.Width + (col + 1);
-            Indices[Index++] = (row + 1) * terrainInfo.Width + col;
-            Indices[Index++] = (row + 1) * terrainInfo.Width + (col + 1);
+    Indices.resize(DrawCount);
+
+    // Every row of cells writes its own fixed range of six indices per cell
+    JobSystem::getInstance().parallelFor(info.Depth - 1, TerrainRowsPerJob, [&](size_t firstRow, size_t lastRow) {
+        for (unsigned int row = static_cast<unsigned int>(firstRow); row < lastRow; row++) {
+            size_t Index = static_cast<size_t>(row) * (info.Width - 1) * 6;
+            for (unsigned int col = 0; col < (info.Width - 1); col++) {
+                Indices[Index++] = row * info.Width + col;
+                Indices[Index++] = (row + 1) * info.Width + col;
+                Indices[Index++] = row * info.Width + (col + 1);
+
+                Indices[Index++] = row * info.Width + (col + 1);
+                Indices[Index++] = (row + 1) * info.Width + col;
+                Indices[Index++] = (row + 1) * info.Width + (col + 1);
+            }
         }
-    }
-
-    glGenBuffers(1, &ebo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, Indices.size() * sizeof(GLuint), &Indices[0], GL_STATIC_DRAW);
+    });
 }
 
 // Function to render the terrain
 void Terrain::DrawTerrain() {
-    glBindVertexArray(vao);
-    glCullFace(GL_FRONT);
-    glDrawElements(GL_TRIANGLES, (terrainInfo.Width - 1) * (terrainInfo.Depth - 1) * 6, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    GLStateCache::getInstance().setCullFace(GL_FRONT);
+    GeometryArena::getInstance().draw(geometry);
+}
+
+ResidentSize Terrain::GetResidentSize() const {
+    ResidentSize Size;
+    Size.GpuBytes = GeometryArena::getInstance().getByteSize(geometry);
+    if (heightTexture != 0) {
+        Size.GpuBytes += static_cast<size_t>(terrainInfo.Width) * terrainInfo.Depth * sizeof(float);
+    }
+    Size.CpuBytes = heightmap.capacity() * sizeof(float);
+    return Size;
+}
+
+GLuint Terrain::GetHeightTexture() const {
+    return heightTexture;
+}
+
+const HeightMapInfo& Terrain::GetInfo() const {
+    return terrainInfo;
 }
@@ -0,0 +1,374 @@
+/***********************************************************************
+Bachelor of Software Engineering
+Media Design School
+Auckland
+New Zealand
+
+(c) 2024 Media Design School
+
+File Name : VegetationScatter.cpp
+Description : Implementations for VegetationScatter class
+Author : Shikomisen (Ayoub Ahmad)
+Mail : ayoub.ahmad@mds.ac.nz
+**************************************************************************/
+
+#include "VegetationScatter.h"
+
+#include "GeometryArena.h"
+#include "GLStateCache.h"
+#include "Model.h"
+#include "Terrain.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <utility>
+
+namespace
+{
+	// Binding points used by VegetationScatter.comp, VegetationCommands.comp and Vegetation.vert
+	// (0-3 belong to the clustered lighting, 4-8 to the GPU-driven renderer)
+	constexpr GLuint InstanceBinding = 9;
+	constexpr GLuint CountBinding = 10;
+	constexpr GLuint MeshBinding = 11;
+	constexpr GLuint VisibleBinding = 12;
+	constexpr GLuint CommandBinding = 13;
+
+	constexpr GLuint HeightUnit = 0;
+	constexpr unsigned int ScatterGroupSize = 64;
+
+	// An instance is a vec4: world position, and yaw and scale packed as two halves
+	constexpr size_t InstanceBytes = 4 * sizeof(float);
+	constexpr size_t MaxInstanceBytes = 256ull << 20;
+
+	double toMegabytes(const size_t Bytes)
+	{
+		return static_cast<double>(Bytes) / (1024.0 * 1024.0);
+	}
+}
+
+VegetationScatter::VegetationScatter()
+	: MScatterShader("resources/shaders/VegetationScatter.comp"),
+	  MCommandShader("resources/shaders/VegetationCommands.comp"),
+	  MTerrain(nullptr), MTransform(1.0f), MModel(nullptr), MModelRadius(0.0f), MFadeStart(0.0f), MFadeEnd(0.0f),
+	  MRegionsX(0), MRegionsZ(0), MPointsPerSide(0), MFrame(0), MTexture(0)
+{
+	glGenBuffers(1, &MInstanceBuffer);
+	glGenBuffers(1, &MCountBuffer);
+	glGenBuffers(1, &MMeshBuffer);
+	glGenBuffers(1, &MVisibleBuffer);
+	glGenBuffers(1, &MCommandBuffer);
+
+	const std::vector<GLuint> Zeros(MaxResidentRegions, 0);
+	for (const GLuint Buffer : {MCountBuffer, MVisibleBuffer})
+	{
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, Buffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, MaxResidentRegions * sizeof(GLuint), Zeros.data(), GL_DYNAMIC_DRAW);
+	}
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void VegetationScatter::setTerrain(const Terrain& Terrain, const glm::mat4& Transform)
+{
+	const HeightMapInfo& Info = Terrain.GetInfo();
+	MTerrain = &Terrain;
+	MTransform = Transform;
+	MRegionsX = static_cast<int>(Info.Width - 1 + RegionCells - 1) / RegionCells;
+	MRegionsZ = static_cast<int>(Info.Depth - 1 + RegionCells - 1) / RegionCells;
+	reset();
+}
+
+void VegetationScatter::setModel(const Model& Model, const ScatterRules& Rules)
+{
+	MModel = &Model;
+	MRules = Rules;
+
+	// The instance origin sits on the ground, so the reach of the model is measured from it
+	const BoundingSphere& Sphere = Model.getBoundingSphere();
+	MModelRadius = glm::length(Sphere.Centre) + Sphere.Radius;
+
+	MMeshCommands.clear();
+	MTexture = 0;
+	for (const Mesh& Mesh : Model.getMeshes())
+	{
+		const GeometrySpan& Span = GeometryArena::getInstance().getSpan(Mesh.getGeometry());
+		DrawElementsIndirectCommand Command = {};
+		Command.Count = static_cast<GLuint>(Span.IndexCount);
+		Command.FirstIndex = Span.FirstIndex;
+		Command.BaseVertex = Span.BaseVertex;
+		MMeshCommands.push_back(Command);
+
+		if (MTexture == 0 && !Mesh.Textures.empty())
+			MTexture = Mesh.Textures[0].Id;
+	}
+
+	// Every slot holds a full grid of candidates, so a region can never overflow it
+	const float Spacing = std::max(Rules.Spacing, 0.01f);
+	MPointsPerSide = static_cast<GLuint>(std::ceil(static_cast<float>(RegionCells) / Spacing));
+	const auto MaxPointsPerSide = static_cast<GLuint>(std::sqrt(static_cast<double>(MaxInstanceBytes / InstanceBytes / MaxResidentRegions)));
+	if (MPointsPerSide > MaxPointsPerSide)
+	{
+		std::cerr << "[Vegetation] spacing " << Rules.Spacing << " needs " << MPointsPerSide << " candidates per region side, limited to "
+			<< MaxPointsPerSide << '\n';
+		MPointsPerSide = MaxPointsPerSide;
+	}
+	MRules.Spacing = static_cast<float>(RegionCells) / static_cast<float>(MPointsPerSide);
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, MInstanceBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, getInstanceCapacity() * InstanceBytes, nullptr, GL_DYNAMIC_COPY);
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, MMeshBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, MMeshCommands.size() * sizeof(DrawElementsIndirectCommand), MMeshCommands.data(), GL_STATIC_DRAW);
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, MCommandBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, MaxResidentRegions * MMeshCommands.size() * sizeof(DrawElementsIndirectCommand), nullptr,
+		GL_DYNAMIC_COPY);
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	reset();
+}
+
+void VegetationScatter::setDrawDistance(const float FadeStart, const float FadeEnd)
+{
+	MFadeStart = FadeStart;
+	MFadeEnd = std::max(FadeEnd, FadeStart + 0.001f);
+}
+
+void VegetationScatter::reset()
+{
+	MSlots.assign(MaxResidentRegions, {});
+	MVisibleSlots.assign(MaxResidentRegions, 0);
+	MRegionSlots.assign(static_cast<size_t>(MRegionsX) * MRegionsZ, -1);
+	MStats = {};
+	MStats.Regions = static_cast<unsigned int>(MRegionSlots.size());
+
+	MRegionBounds.clear();
+	if (!isReady())
+		return;
+
+	MRegionBounds.reserve(MRegionSlots.size());
+	for (int Region = 0; Region < static_cast<int>(MRegionSlots.size()); Region++)
+		MRegionBounds.push_back(getRegionBounds(Region));
+}
+
+bool VegetationScatter::isReady() const
+{
+	return MTerrain != nullptr && MModel != nullptr && MTerrain->GetHeightTexture() != 0 && !MMeshCommands.empty();
+}
+
+Aabb VegetationScatter::getRegionBounds(const int Region) const
+{
+	// Mirrors Terrain::SetupMesh: columns run along +X and rows along -Z, centred on the origin
+	const HeightMapInfo& Info = MTerrain->GetInfo();
+	const float HalfWidth = (Info.Width - 1) * Info.CellSpacing * 0.5f;
+	const float HalfDepth = (Info.Depth - 1) * Info.CellSpacing * 0.5f;
+	const int FirstColumn = (Region % MRegionsX) * RegionCells;
+	const int FirstRow = (Region / MRegionsX) * RegionCells;
+	const int LastColumn = std::min(FirstColumn + RegionCells, static_cast<int>(Info.Width) - 1);
+	const int LastRow = std::min(FirstRow + RegionCells, static_cast<int>(Info.Depth) - 1);
+
+	// The CPU heightmap is gone by now, so every region spans the full height range
+	Aabb Local;
+	Local.Min = glm::vec3(-HalfWidth + FirstColumn * Info.CellSpacing, 0.0f, HalfDepth - LastRow * Info.CellSpacing);
+	Local.Max = glm::vec3(-HalfWidth + LastColumn * Info.CellSpacing, Terrain::HeightScale, HalfDepth - FirstRow * Info.CellSpacing);
+
+	Aabb World = Local.transformed(MTransform);
+	const glm::vec3 Reach(MModelRadius * MRules.MaxScale);
+	World.Min -= Reach;
+	World.Max += Reach;
+	return World;
+}
+
+int VegetationScatter::acquireSlot()
+{
+	// A free slot, else the one out of view the longest
+	int Oldest = -1;
+	for (int I = 0; I < MaxResidentRegions; I++)
+	{
+		const Slot& Candidate = MSlots[I];
+		if (Candidate.Region < 0)
+			return I;
+		if (Candidate.LastVisible < MFrame && (Oldest < 0 || Candidate.LastVisible < MSlots[Oldest].LastVisible))
+			Oldest = I;
+	}
+
+	if (Oldest >= 0)
+	{
+		MRegionSlots[MSlots[Oldest].Region] = -1;
+		MStats.Evicted++;
+		MStats.ResidentRegions--;
+	}
+	return Oldest;
+}
+
+void VegetationScatter::update(const Camera& Camera)
+{
+	if (!isReady())
+		return;
+
+	MFrame++;
+	MStats.VisibleRegions = 0;
+	MStats.GeneratedLastFrame = 0;
+	std::fill(MVisibleSlots.begin(), MVisibleSlots.end(), 0);
+
+	// Generated regions in view are kept for this frame; missing ones are queued by distance
+	const Frustum ViewFrustum = Camera.getFrustum(800, 600);
+	std::vector<std::pair<float, int>> Missing;
+	for (int Region = 0; Region < static_cast<int>(MRegionBounds.size()); Region++)
+	{
+		const Aabb& Box = MRegionBounds[Region];
+		const float Distance = glm::distance(Camera.VPosition, glm::clamp(Camera.VPosition, Box.Min, Box.Max));
+		if (Distance > MFadeEnd || !ViewFrustum.intersects(Box))
+			continue;
+
+		MStats.VisibleRegions++;
+		const int Index = MRegionSlots[Region];
+		if (Index >= 0)
+		{
+			MSlots[Index].LastVisible = MFrame;
+			MVisibleSlots[Index] = 1;
+		}
+		else
+		{
+			Missing.push_back({Distance, Region});
+		}
+	}
+
+	if (!Missing.empty())
+	{
+		std::sort(Missing.begin(), Missing.end());
+
+		const HeightMapInfo& Info = MTerrain->GetInfo();
+		MScatterShader.use();
+		GLStateCache::getInstance().bindTexture(HeightUnit, GL_TEXTURE_2D, MTerrain->GetHeightTexture());
+		MScatterShader.setInt("heightMap", static_cast<int>(HeightUnit));
+		MScatterShader.setMat4("terrainTransform", MTransform);
+		MScatterShader.setMat4("terrainNormalMatrix", glm::mat4(glm::transpose(glm::inverse(glm::mat3(MTransform)))));
+		MScatterShader.setIVec2("terrainCells", glm::ivec2(Info.Width - 1, Info.Depth - 1));
+		MScatterShader.setVec2("terrainHalfExtent", glm::vec2(Info.Width - 1, Info.Depth - 1) * Info.CellSpacing * 0.5f);
+		MScatterShader.setFloat("cellSpacing", Info.CellSpacing);
+		MScatterShader.setFloat("heightScale", Terrain::HeightScale);
+		MScatterShader.setUInt("pointsPerSide", MPointsPerSide);
+		MScatterShader.setFloat("spacing", MRules.Spacing);
+		MScatterShader.setFloat("density", MRules.Density);
+		MScatterShader.setFloat("clumping", MRules.Clumping);
+		MScatterShader.setFloat("patchSize", std::max(MRules.PatchSize, 1.0f));
+		MScatterShader.setFloat("minHeight", MRules.MinHeight);
+		MScatterShader.setFloat("maxHeight", MRules.MaxHeight);
+		MScatterShader.setFloat("minUp", std::cos(glm::radians(MRules.MaxSlopeDegrees)));
+		MScatterShader.setFloat("minScale", MRules.MinScale);
+		MScatterShader.setFloat("maxScale", MRules.MaxScale);
+		MScatterShader.setUInt("seed", MRules.Seed);
+
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, InstanceBinding, MInstanceBuffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CountBinding, MCountBuffer);
+
+		for (const auto& [Distance, Region] : Missing)
+		{
+			if (MStats.GeneratedLastFrame == MaxRegionsPerFrame)
+				break;
+
+			const int Index = acquireSlot();
+			if (Index < 0)
+				break;
+
+			generate(Region, Index);
+			MSlots[Index] = {Region, MFrame};
+			MRegionSlots[Region] = Index;
+			MVisibleSlots[Index] = 1;
+			MStats.GeneratedLastFrame++;
+			MStats.Generated++;
+			MStats.ResidentRegions++;
+		}
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+	}
+
+	// Rebuild every slot's commands from its count, with zero instances when it is out of view
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, MVisibleBuffer);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, MaxResidentRegions * sizeof(GLuint), MVisibleSlots.data());
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	MCommandShader.use();
+	MCommandShader.setUInt("slotCount", MaxResidentRegions);
+	MCommandShader.setUInt("meshCount", static_cast<unsigned int>(MMeshCommands.size()));
+	MCommandShader.setUInt("slotCapacity", MPointsPerSide * MPointsPerSide);
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CountBinding, MCountBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MeshBinding, MMeshBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, VisibleBinding, MVisibleBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CommandBinding, MCommandBuffer);
+
+	MCommandShader.dispatch((MaxResidentRegions + ScatterGroupSize - 1) / ScatterGroupSize);
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void VegetationScatter::generate(const int Region, const int Slot) const
+{
+	// The slot starts empty; the scatter appends to it with an atomic counter
+	constexpr GLuint Zero = 0;
+	glBindBuffer(GL_COPY_WRITE_BUFFER, MCountBuffer);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, Slot * sizeof(GLuint), sizeof(GLuint), &Zero);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	MScatterShader.setIVec2("regionCoord", glm::ivec2(Region % MRegionsX, Region / MRegionsX));
+	MScatterShader.setUInt("regionCells", RegionCells);
+	MScatterShader.setUInt("slot", static_cast<unsigned int>(Slot));
+
+	const GLuint Candidates = MPointsPerSide * MPointsPerSide;
+	MScatterShader.dispatch((Candidates + ScatterGroupSize - 1) / ScatterGroupSize);
+}
+
+void VegetationScatter::draw(const Shader& Shader) const
+{
+	if (!isReady())
+		return;
+
+	GLStateCache::getInstance().bindTexture(0, GL_TEXTURE_2D, MTexture);
+	Shader.setInt("texture_diffuse1", 0);
+	Shader.setFloat("fadeStart", MFadeStart);
+	Shader.setFloat("fadeEnd", MFadeEnd);
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, InstanceBinding, MInstanceBuffer);
+
+	// One call for every slot; slots out of view or not yet generated have no instances
+	GeometryArena::getInstance().bind();
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, MCommandBuffer);
+	glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(MaxResidentRegions * MMeshCommands.size()), 0);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	GLStateCache::getInstance().recordDraw();
+}
+
+void VegetationScatter::cleanup()
+{
+	MScatterShader.cleanup();
+	MCommandShader.cleanup();
+
+	const GLuint Buffers[] = {MInstanceBuffer, MCountBuffer, MMeshBuffer, MVisibleBuffer, MCommandBuffer};
+	glDeleteBuffers(5, Buffers);
+	MInstanceBuffer = MCountBuffer = MMeshBuffer = MVisibleBuffer = MCommandBuffer = 0;
+
+	MTerrain = nullptr;
+	MModel = nullptr;
+	MMeshCommands.clear();
+	MRegionBounds.clear();
+	MRegionSlots.clear();
+	MSlots.clear();
+	MVisibleSlots.clear();
+}
+
+size_t VegetationScatter::getInstanceCapacity() const
+{
+	return static_cast<size_t>(MPointsPerSide) * MPointsPerSide * MaxResidentRegions;
+}
+
+const ScatterStats& VegetationScatter::getStats() const
+{
+	return MStats;
+}
+
+void VegetationScatter::printStats(const std::string& Label) const
+{
+	std::cout << Label << ": vegetation " << MStats.Regions << " regions of " << RegionCells << " cells, " << MStats.ResidentRegions << " resident, "
+		<< MStats.VisibleRegions << " in view; " << MStats.Generated << " generated, " << MStats.Evicted << " evicted; room for "
+		<< getInstanceCapacity() << " instances (" << toMegabytes(getInstanceCapacity() * InstanceBytes) << " MB)" << '\n';
+}
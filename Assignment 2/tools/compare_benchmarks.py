@@ -0,0 +1,63 @@
+"""Compare two benchmark result files written by "Assignment 2.exe" --bench <name> --json <file>.
+
+Usage: python tools/compare_benchmarks.py baseline.json current.json [--threshold 10] [--metric min_ms]
+
+Prints every timing with its change against the baseline and exits with 1 when any of them is
+slower by more than the threshold percentage, so a build script can fail on a regression.
+The fastest run (min_ms) is compared by default because it is the least noisy on a busy machine.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load_results(path):
+    with open(path, encoding="utf-8") as file:
+        data = json.load(file)
+    return data.get("benchmark", "?"), {result["name"]: result for result in data["results"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Fail when benchmark timings regress against a baseline.")
+    parser.add_argument("baseline", help="JSON results to compare against")
+    parser.add_argument("current", help="JSON results of the build under test")
+    parser.add_argument("--threshold", type=float, default=10.0, help="allowed slowdown in percent (default 10)")
+    parser.add_argument("--metric", choices=("min_ms", "mean_ms"), default="min_ms", help="timing to compare (default min_ms)")
+    args = parser.parse_args()
+
+    baseline_name, baseline = load_results(args.baseline)
+    current_name, current = load_results(args.current)
+    if baseline_name != current_name:
+        print(f"warning: comparing benchmark '{current_name}' against '{baseline_name}'")
+
+    regressions = []
+    width = max((len(name) for name in current), default=0)
+    for name, result in current.items():
+        if name not in baseline:
+            print(f"  {name:<{width}}  {result[args.metric]:10.3f} ms  (new)")
+            continue
+
+        before = baseline[name][args.metric]
+        after = result[args.metric]
+        change = (after - before) / before * 100.0 if before > 0.0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions.append(name)
+        print(f"  {name:<{width}}  {before:10.3f} -> {after:10.3f} ms  {change:+7.1f}%{flag}")
+
+    for name in baseline:
+        if name not in current:
+            print(f"  {name:<{width}}  missing from {args.current}")
+
+    if regressions:
+        print(f"{len(regressions)} of {len(current)} timings regressed by more than {args.threshold:g}%")
+        return 1
+
+    print(f"No timing regressed by more than {args.threshold:g}%")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())